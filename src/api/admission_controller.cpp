@@ -0,0 +1,320 @@
+/*
+AdmissionController implementation
+*/
+
+#include "admission_controller.h"
+#include "../util/logger.h"
+#include "../util/perf_counters.h"
+#include <algorithm>
+
+namespace {
+// Constant lookup table, like the solver names: nothing runs at startup
+struct CommandClassEntry {
+    const char* command;
+    CostClass costClass;
+};
+
+constexpr CommandClassEntry kCommandClasses[] = {
+    {"solve_puzzle", CostClass::SOLVE},
+    {"solve_custom_puzzle", CostClass::SOLVE},
+    {"get_ai_moves", CostClass::SOLVE},
+    {"generate_puzzle", CostClass::SOLVE},
+    {"train_batch", CostClass::JOB},
+    {"cross_validate", CostClass::JOB},
+    {"performance_metrics", CostClass::JOB}
+};
+
+// Weight of the newest run in the service-time and CPU averages
+constexpr double kServiceSmoothing = 0.2;
+
+// Idle clients with a full bucket are forgotten beyond this many
+constexpr size_t kMaxClients = 4096;
+}
+
+// ========== Ticket ==========
+
+AdmissionController::Ticket::Ticket(Ticket&& other) noexcept
+    : controller(other.controller), costClass(other.costClass), client(std::move(other.client)),
+      retryAfterMs(other.retryAfterMs), queuedMs(other.queuedMs), cpuStartMs(other.cpuStartMs),
+      started(other.started) {
+    other.controller = nullptr;
+}
+
+AdmissionController::Ticket& AdmissionController::Ticket::operator=(Ticket&& other) noexcept {
+    if (this != &other) {
+        release();
+        controller = other.controller;
+        costClass = other.costClass;
+        client = std::move(other.client);
+        retryAfterMs = other.retryAfterMs;
+        queuedMs = other.queuedMs;
+        cpuStartMs = other.cpuStartMs;
+        started = other.started;
+        other.controller = nullptr;
+    }
+    return *this;
+}
+
+AdmissionController::Ticket::~Ticket() {
+    release();
+}
+
+void AdmissionController::Ticket::release() {
+    if (!controller) {
+        return;
+    }
+    double serviceMs = std::chrono::duration<double, std::milli>(
+        std::chrono::steady_clock::now() - started).count();
+    double cpuMs = std::max(0.0, threadCpuTimeMs() - cpuStartMs);
+    controller->finish(costClass, client, serviceMs, cpuMs);
+    controller = nullptr;
+}
+
+// ========== AdmissionController ==========
+
+AdmissionController::AdmissionController() : AdmissionController(Options()) {}
+
+AdmissionController::AdmissionController(const Options& options) : options(options) {
+    for (int i = 0; i < kCostClassCount; ++i) {
+        classes[i].limits = options.limits[i];
+        classes[i].limits.concurrency = std::max(1, classes[i].limits.concurrency);
+    }
+}
+
+AdmissionController::Ticket AdmissionController::admit(CostClass costClass, const std::string& clientId) {
+    int index = static_cast<int>(costClass);
+    ClassState& state = classes[index];
+    auto arrived = std::chrono::steady_clock::now();
+    Ticket ticket;
+    ticket.costClass = costClass;
+
+    std::unique_lock<std::mutex> lock(mutex);
+    ClientState& client = clientState(clientId);
+    refill(client, arrived);
+
+    auto reject = [&](const char* reason) {
+        state.rejected++;
+        double expected = expectedWaitMs(state, state.waiting.size() + 1);
+        ticket.retryAfterMs = state.measured ? expected : state.limits.maxQueueWaitMs;
+        SUDOKU_LOG_DEBUG("admission", "rejected class=" << className(costClass) << " client=" << clientId
+                         << " reason=" << reason << " queued=" << state.waiting.size()
+                         << " retry_after_ms=" << ticket.retryAfterMs);
+    };
+
+    // Interactive requests are cheap and never refused for a client's debt
+    if (costClass != CostClass::INTERACTIVE && client.tokensMs < 0.0) {
+        client.throttled++;
+        reject("client_quota");
+        ticket.retryAfterMs = -client.tokensMs / options.clientCpuRate;
+        return ticket;
+    }
+
+    // Fair-queueing tags: cost is the client's usual CPU for this class
+    double cost = client.measured[index] ? client.cpuPerRequestMs[index]
+                                         : (state.measured ? state.serviceMs : 1.0);
+    double start = std::max(state.virtualTime, client.lastFinish[index]);
+    double finishTag = start + std::max(cost, 0.001) / client.weight;
+
+    bool runNow = state.running < state.limits.concurrency &&
+                  withinSlotShare(state, index, &client) &&
+                  nextEligible(state, index) == state.waiting.end();
+    if (!runNow) {
+        if (state.waiting.size() >= state.limits.queueCapacity) {
+            reject("queue_full");
+            return ticket;
+        }
+        if (expectedWaitMs(state, state.waiting.size() + 1) > state.limits.maxQueueWaitMs) {
+            reject("expected_wait");
+            return ticket;
+        }
+
+        QueuedRequest request{finishTag, state.nextId++, start, &client};
+        state.waiting.insert(request);
+        client.lastFinish[index] = finishTag;
+        client.active++;
+        auto deadline = arrived + std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+            std::chrono::duration<double, std::milli>(state.limits.maxQueueWaitMs));
+        auto ready = [&]() {
+            if (state.running >= state.limits.concurrency) return false;
+            auto next = nextEligible(state, index);
+            return next != state.waiting.end() && next->id == request.id;
+        };
+
+        if (!state.slotFreed.wait_until(lock, deadline, ready)) {
+            state.waiting.erase(request);
+            client.active--;
+            // Whoever queued behind us may now be first
+            state.slotFreed.notify_all();
+            reject("deadline");
+            return ticket;
+        }
+        state.waiting.erase(request);
+        // Several slots may have freed at once
+        state.slotFreed.notify_all();
+    } else {
+        client.lastFinish[index] = finishTag;
+        client.active++;
+    }
+
+    state.virtualTime = std::max(state.virtualTime, start);
+    state.running++;
+    client.running[index]++;
+    state.admitted++;
+    ticket.controller = this;
+    ticket.client = clientId;
+    ticket.started = std::chrono::steady_clock::now();
+    ticket.queuedMs = std::chrono::duration<double, std::milli>(ticket.started - arrived).count();
+    ticket.cpuStartMs = threadCpuTimeMs();
+    return ticket;
+}
+
+AdmissionStats AdmissionController::getStats(CostClass costClass) const {
+    const ClassState& state = classes[static_cast<int>(costClass)];
+    std::lock_guard<std::mutex> lock(mutex);
+    AdmissionStats stats;
+    stats.admitted = state.admitted;
+    stats.rejected = state.rejected;
+    stats.running = state.running;
+    stats.queued = state.waiting.size();
+    stats.serviceMs = state.serviceMs;
+    return stats;
+}
+
+std::vector<ClientStats> AdmissionController::getClientStats() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    auto now = std::chrono::steady_clock::now();
+    std::vector<ClientStats> result;
+    result.reserve(clients.size());
+    for (const auto& entry : clients) {
+        ClientState state = entry.second;
+        refill(state, now);
+        ClientStats stats;
+        stats.id = entry.first;
+        stats.requests = state.requests;
+        stats.throttled = state.throttled;
+        stats.cpuMs = state.cpuMs;
+        stats.tokensMs = state.tokensMs;
+        stats.weight = state.weight;
+        result.push_back(stats);
+    }
+    return result;
+}
+
+CostClass AdmissionController::classify(const std::string& command) {
+    for (const auto& entry : kCommandClasses) {
+        if (command == entry.command) {
+            return entry.costClass;
+        }
+    }
+    return CostClass::INTERACTIVE;
+}
+
+const char* AdmissionController::className(CostClass costClass) {
+    switch (costClass) {
+        case CostClass::INTERACTIVE: return "interactive";
+        case CostClass::SOLVE: return "solve";
+        case CostClass::JOB: return "job";
+    }
+    return "unknown";
+}
+
+double AdmissionController::expectedWaitMs(const ClassState& state, size_t ahead) const {
+    // Until a command of this class has finished there is nothing to go on;
+    // the queue bound and the deadline still apply
+    if (!state.measured) {
+        return 0.0;
+    }
+    return static_cast<double>(ahead) * state.serviceMs / state.limits.concurrency;
+}
+
+AdmissionController::ClientState& AdmissionController::clientState(const std::string& id) {
+    auto it = clients.find(id);
+    if (it != clients.end()) {
+        return it->second;
+    }
+    if (clients.size() >= kMaxClients) {
+        forgetIdleClients();
+    }
+
+    ClientState& state = clients[id];
+    auto weight = options.clientWeights.find(id);
+    state.weight = weight != options.clientWeights.end() && weight->second > 0.0 ? weight->second : 1.0;
+    state.tokensMs = options.clientCpuBurstMs;
+    state.refilled = std::chrono::steady_clock::now();
+    return state;
+}
+
+void AdmissionController::refill(ClientState& state, std::chrono::steady_clock::time_point now) const {
+    double elapsedMs = std::chrono::duration<double, std::milli>(now - state.refilled).count();
+    if (elapsedMs > 0.0) {
+        state.tokensMs = std::min(options.clientCpuBurstMs, state.tokensMs + elapsedMs * options.clientCpuRate);
+        state.refilled = now;
+    }
+}
+
+void AdmissionController::forgetIdleClients() {
+    auto now = std::chrono::steady_clock::now();
+    for (auto it = clients.begin(); it != clients.end();) {
+        refill(it->second, now);
+        // A full bucket and nothing in flight: recreating it later changes nothing
+        // (apart from its fair-queueing tags, which only matter while it is busy)
+        if (it->second.active == 0 && it->second.tokensMs >= options.clientCpuBurstMs) {
+            it = clients.erase(it);
+        } else {
+            ++it;
+        }
+    }
+}
+
+int AdmissionController::clientSlotLimit(const ClassState& state) const {
+    return std::max(1, static_cast<int>(state.limits.concurrency * options.clientSlotShare));
+}
+
+bool AdmissionController::othersQueued(const ClassState& state, const ClientState* client) const {
+    for (const QueuedRequest& request : state.waiting) {
+        if (request.client != client) {
+            return true;
+        }
+    }
+    return false;
+}
+
+bool AdmissionController::withinSlotShare(const ClassState& state, int index, const ClientState* client) const {
+    // The share only protects clients that are waiting; without them it would leave slots idle
+    return client->running[index] < clientSlotLimit(state) || !othersQueued(state, client);
+}
+
+std::set<AdmissionController::QueuedRequest>::const_iterator
+AdmissionController::nextEligible(const ClassState& state, int index) const {
+    for (auto it = state.waiting.begin(); it != state.waiting.end(); ++it) {
+        if (withinSlotShare(state, index, it->client)) {
+            return it;
+        }
+    }
+    return state.waiting.end();
+}
+
+void AdmissionController::finish(CostClass costClass, const std::string& clientId, double serviceMs, double cpuMs) {
+    int index = static_cast<int>(costClass);
+    ClassState& state = classes[index];
+    std::lock_guard<std::mutex> lock(mutex);
+    state.running--;
+    state.serviceMs = state.measured
+        ? (1.0 - kServiceSmoothing) * state.serviceMs + kServiceSmoothing * serviceMs
+        : serviceMs;
+    state.measured = true;
+
+    ClientState& client = clientState(clientId);
+    refill(client, std::chrono::steady_clock::now());
+    client.running[index]--;
+    client.active--;
+    client.requests++;
+    client.cpuMs += cpuMs;
+    client.tokensMs -= cpuMs;
+    client.cpuPerRequestMs[index] = client.measured[index]
+        ? (1.0 - kServiceSmoothing) * client.cpuPerRequestMs[index] + kServiceSmoothing * cpuMs
+        : cpuMs;
+    client.measured[index] = true;
+
+    state.slotFreed.notify_all();
+}
@@ -0,0 +1,204 @@
+/*
+AdmissionController - cost classes, bounded queues, per-client fairness
+Commands are sorted into three cost classes. Each class has its own
+concurrency limit and a bounded queue, so a few train_batch or
+cross_validate requests can occupy at most the job slots while board moves
+and hints keep flowing through theirs.
+
+A request that would wait too long is rejected up front instead of timing
+out later: when the class queue is full, or the expected wait (queue length
+times the class's recent service time, divided by its concurrency) exceeds
+the class deadline, admit() returns a rejected ticket carrying a retry hint.
+A request that does queue but is still not running at the deadline is
+rejected the same way. Admission only bounds the wait for a slot: anything
+an admitted command waits for must be bounded too, or it holds the slot
+meanwhile. The server gives the wait for a pooled solver (the single
+neuro-symbolic network, which a train_batch keeps for minutes) the class
+deadline, see SudokuJsonApi::setSolverWait.
+
+Every request is attributed to a client id. The calling thread's CPU clock
+is read when a ticket is granted and when it is released, and the
+difference is charged to the client:
+  - Token bucket: each client earns CPU time at a fixed rate up to a burst.
+    A client in debt has its solve and job requests refused (retry hint =
+    time to pay the debt off); interactive requests are never refused for it.
+  - Weighted fair queueing: within a class, queued requests are started in
+    order of virtual finish time, where a request's cost is its client's
+    recent CPU per request in that class, divided by the client's weight.
+    A client sending a stream of expensive solves therefore queues behind
+    clients sending cheap ones instead of ahead of them.
+  - Slot share: while another client has a request queued in the class,
+    a client may hold at most half of the class's slots (at least one), so
+    the others find a slot that frees up soon. A client alone uses them all.
+Only the admitted thread's own CPU is measured; work a command fans out to
+the shared executor (performance_metrics) is not charged.
+
+    AdmissionController::Ticket ticket = admission.admit(CostClass::SOLVE, client);
+    if (!ticket) return busy(ticket.getRetryAfterMs());
+    ... run the command; the slot is released when the ticket goes away
+*/
+
+#ifndef SUDOKU_API_ADMISSION_CONTROLLER_H
+#define SUDOKU_API_ADMISSION_CONTROLLER_H
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <map>
+#include <mutex>
+#include <set>
+#include <string>
+#include <vector>
+
+enum class CostClass {
+    INTERACTIVE = 0,  // Board reads and moves, single hints: microseconds to milliseconds
+    SOLVE = 1,        // Full solves and move lists: up to seconds on hard puzzles
+    JOB = 2           // Training, cross-validation, evaluation: seconds to minutes
+};
+
+constexpr int kCostClassCount = 3;
+
+struct ClassLimits {
+    int concurrency;          // Commands of this class running at once
+    size_t queueCapacity;     // Commands allowed to wait for a slot
+    double maxQueueWaitMs;    // Reject when the expected or actual wait exceeds this
+};
+
+struct AdmissionStats {
+    uint64_t admitted = 0;
+    uint64_t rejected = 0;
+    int running = 0;
+    size_t queued = 0;
+    double serviceMs = 0.0;   // Moving average of command run time
+};
+
+struct ClientStats {
+    std::string id;
+    uint64_t requests = 0;
+    uint64_t throttled = 0;   // Refused because the client's bucket was in debt
+    double cpuMs = 0.0;       // Total CPU charged
+    double tokensMs = 0.0;    // Current bucket level (negative = in debt)
+    double weight = 1.0;
+};
+
+class AdmissionController {
+public:
+    struct Options {
+        ClassLimits limits[kCostClassCount] = {
+            {4, 256, 250.0},
+            {2, 64, 2000.0},
+            {1, 4, 60000.0}
+        };
+        double clientCpuRate = 0.5;          // CPU ms earned per wall ms (half a core)
+        double clientCpuBurstMs = 10000.0;   // Bucket size
+        double clientSlotShare = 0.5;        // Most of a class's slots one client may hold
+        std::map<std::string, double> clientWeights;  // Unlisted clients weigh 1
+    };
+
+    class Ticket {
+    public:
+        Ticket() = default;
+        Ticket(Ticket&& other) noexcept;
+        Ticket& operator=(Ticket&& other) noexcept;
+        ~Ticket();
+
+        Ticket(const Ticket&) = delete;
+        Ticket& operator=(const Ticket&) = delete;
+
+        explicit operator bool() const { return controller != nullptr; }
+        CostClass getClass() const { return costClass; }
+        double getRetryAfterMs() const { return retryAfterMs; }
+        double getQueuedMs() const { return queuedMs; }
+
+        // Gives the slot back and charges the CPU used so far; the destructor
+        // does the same. Must run on the thread that was admitted.
+        void release();
+
+    private:
+        friend class AdmissionController;
+
+        AdmissionController* controller = nullptr;
+        CostClass costClass = CostClass::INTERACTIVE;
+        std::string client;
+        double retryAfterMs = 0.0;
+        double queuedMs = 0.0;
+        double cpuStartMs = 0.0;
+        std::chrono::steady_clock::time_point started;
+    };
+
+    AdmissionController();
+    explicit AdmissionController(const Options& options);
+
+    AdmissionController(const AdmissionController&) = delete;
+    AdmissionController& operator=(const AdmissionController&) = delete;
+
+    // Blocks while the request queues; an empty ticket means rejected
+    Ticket admit(CostClass costClass, const std::string& clientId = "default");
+
+    AdmissionStats getStats(CostClass costClass) const;
+    const ClassLimits& getLimits(CostClass costClass) const { return classes[static_cast<int>(costClass)].limits; }
+    std::vector<ClientStats> getClientStats() const;
+
+    // Cost class of an API command; unknown commands are interactive
+    static CostClass classify(const std::string& command);
+    static const char* className(CostClass costClass);
+
+private:
+    struct ClientState {
+        double weight = 1.0;
+        double tokensMs = 0.0;
+        std::chrono::steady_clock::time_point refilled;
+        double lastFinish[kCostClassCount] = {};   // Virtual finish tag of the last request
+        double cpuPerRequestMs[kCostClassCount] = {};
+        bool measured[kCostClassCount] = {};
+        int running[kCostClassCount] = {};
+        int active = 0;                             // Queued or running requests
+        uint64_t requests = 0;
+        uint64_t throttled = 0;
+        double cpuMs = 0.0;
+    };
+
+    // Queued requests are started smallest virtual finish tag first
+    struct QueuedRequest {
+        double finish;
+        uint64_t id;
+        double start;
+        ClientState* client;
+        bool operator<(const QueuedRequest& other) const {
+            return finish != other.finish ? finish < other.finish : id < other.id;
+        }
+    };
+
+    struct ClassState {
+        ClassLimits limits;
+        int running = 0;
+        std::set<QueuedRequest> waiting;
+        uint64_t nextId = 0;
+        double virtualTime = 0.0;
+        double serviceMs = 0.0;
+        bool measured = false;
+        uint64_t admitted = 0;
+        uint64_t rejected = 0;
+        std::condition_variable slotFreed;
+    };
+
+    ClientState& clientState(const std::string& id);
+    void refill(ClientState& state, std::chrono::steady_clock::time_point now) const;
+    void forgetIdleClients();
+    double expectedWaitMs(const ClassState& state, size_t ahead) const;
+    int clientSlotLimit(const ClassState& state) const;
+    // True if a client other than `client` has a request in the class queue
+    bool othersQueued(const ClassState& state, const ClientState* client) const;
+    // May `client` start another request of the class, as far as the slot share goes
+    bool withinSlotShare(const ClassState& state, int index, const ClientState* client) const;
+    // First queued request whose client may take a slot
+    std::set<QueuedRequest>::const_iterator nextEligible(const ClassState& state, int index) const;
+    void finish(CostClass costClass, const std::string& clientId, double serviceMs, double cpuMs);
+
+    Options options;
+    mutable std::mutex mutex;
+    ClassState classes[kCostClassCount];
+    std::map<std::string, ClientState> clients;
+};
+
+#endif // SUDOKU_API_ADMISSION_CONTROLLER_H
@@ -1,24 +1,98 @@
 /*
 Command-line API server for Sudoku game
 Accepts commands via command line and outputs JSON responses
+Pass --trace before the command to write a Chrome trace of the request
+
+    sudoku_api serve [--port N] [--client-weight ID=W]... [--allow-origin ORIGIN]...
+        keeps running and answers requests over TCP (see api_server.h for the
+        protocol); --client-weight gives a client W times the default share,
+        --allow-origin replaces the page origins allowed to open a WebSocket
 */
 
 #include "json_api.h"
+#include "admission_controller.h"
+#include "api_server.h"
+#include "../util/trace.h"
+#include <cstdlib>
 #include <iostream>
 #include <string>
+#include <vector>
+
+namespace {
+constexpr int kDefaultPort = 8765;
+
+int runServer(int argc, char* argv[], int argIndex) {
+    int port = kDefaultPort;
+    AdmissionController::Options options;
+    std::vector<std::string> allowedOrigins;
+    for (int i = argIndex; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--port" && i + 1 < argc) {
+            port = std::atoi(argv[++i]);
+        } else if (arg == "--client-weight" && i + 1 < argc) {
+            std::string spec = argv[++i];
+            size_t equals = spec.find('=');
+            double weight = equals == std::string::npos ? 0.0 : std::atof(spec.c_str() + equals + 1);
+            if (weight <= 0.0) {
+                std::cerr << "❌ --client-weight expects ID=WEIGHT with WEIGHT > 0: " << spec << std::endl;
+                return 1;
+            }
+            options.clientWeights[spec.substr(0, equals)] = weight;
+        } else if (arg == "--allow-origin" && i + 1 < argc) {
+            allowedOrigins.push_back(argv[++i]);
+        } else {
+            std::cerr << "❌ Unknown serve option: " << arg << std::endl;
+            return 1;
+        }
+    }
+
+    SudokuJsonApi api;
+    AdmissionController admission(options);
+    // One warmed solver per concurrent solve slot
+    api.warmSolvers(options.limits[static_cast<int>(CostClass::SOLVE)].concurrency);
+
+    ApiServer server(api, admission);
+    if (!allowedOrigins.empty()) {
+        server.setAllowedOrigins(allowedOrigins);
+    }
+    std::string error;
+    if (!server.listen(port, error)) {
+        std::cerr << "❌ Cannot listen: " << error << std::endl;
+        return 1;
+    }
+    std::cerr << "🌐 sudoku_api serving on 127.0.0.1:" << server.getPort() << std::endl;
+    server.serve();
+    return 0;
+}
+}
 
 int main(int argc, char* argv[]) {
-    if (argc < 2) {
-        std::cout << R"({"success":false,"message":"Usage: sudoku_api <command> [params]"})" << std::endl;
+    int argIndex = 1;
+    bool forceTrace = false;
+    if (argIndex < argc && std::string(argv[argIndex]) == "--trace") {
+        forceTrace = true;
+        argIndex++;
+    }
+
+    if (argIndex >= argc) {
+        std::cout << R"({"success":false,"message":"Usage: sudoku_api [--trace] <command> [params] | sudoku_api serve [--port N]"})" << std::endl;
         return 1;
     }
-    
+
+    std::string command = argv[argIndex];
+    if (command == "serve") {
+        return runServer(argc, argv, argIndex + 1);
+    }
+    std::string params = (argc > argIndex + 1) ? argv[argIndex + 1] : "";
+
+    // The session spans construction too, so state and model loading show up
+    TraceSession trace(command, TraceSession::shouldTrace(forceTrace));
+
     SudokuJsonApi api;
-    std::string command = argv[1];
-    std::string params = (argc > 2) ? argv[2] : "";
-    
     std::string response = api.processCommand(command, params);
+    trace.finish();
+
     std::cout << response << std::endl;
-    
+
     return 0;
 }
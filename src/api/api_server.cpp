@@ -0,0 +1,541 @@
+/*
+ApiServer implementation
+*/
+
+#include "api_server.h"
+#include "websocket.h"
+#include "../util/logger.h"
+#include "../util/trace.h"
+#include <arpa/inet.h>
+#include <cerrno>
+#include <cstring>
+#include <deque>
+#include <netinet/in.h>
+#include <sstream>
+#include <sys/socket.h>
+#include <thread>
+#include <unistd.h>
+
+namespace {
+// Longest request line accepted; custom 16x16 puzzles stay far below this
+constexpr size_t kMaxRequestBytes = 1 << 20;
+constexpr size_t kMaxHttpHeadBytes = 16384;
+// WebSocket messages waiting for a slow client before its requests stop being read
+constexpr size_t kMaxQueuedMessages = 16;
+
+bool sendAll(int fd, const std::string& data) {
+    size_t sent = 0;
+    while (sent < data.size()) {
+        ssize_t n = ::send(fd, data.data() + sent, data.size() - sent, MSG_NOSIGNAL);
+        if (n < 0 && errno == EINTR) continue;
+        if (n <= 0) return false;
+        sent += static_cast<size_t>(n);
+    }
+    return true;
+}
+
+// Appends what the next recv() returns; false on EOF or error
+bool readMore(int fd, std::string& pending) {
+    char buffer[16384];
+    while (true) {
+        ssize_t n = ::recv(fd, buffer, sizeof(buffer), 0);
+        if (n < 0 && errno == EINTR) continue;
+        if (n <= 0) return false;
+        pending.append(buffer, static_cast<size_t>(n));
+        return true;
+    }
+}
+
+// "command<TAB>params<TAB>client" - params and client are optional
+void parseRequestLine(std::string line, std::string& command, std::string& params, std::string& client) {
+    while (!line.empty() && (line.back() == '\r' || line.back() == '\n')) line.pop_back();
+    size_t tab = line.find('\t');
+    command = line.substr(0, tab);
+    params = tab == std::string::npos ? "" : line.substr(tab + 1);
+    client.clear();
+    size_t clientTab = params.rfind('\t');
+    if (clientTab != std::string::npos) {
+        client = params.substr(clientTab + 1);
+        params.erase(clientTab);
+    }
+}
+
+// Sending side of one WebSocket connection. The reader queues responses and
+// control frames; EventHub wakes it for new events. The writer thread sends
+// queued frames first, then whatever poll() has collapsed the events into,
+// so the events never pile up however slowly the client reads.
+class PushSession {
+public:
+    void wake() {
+        std::lock_guard<std::mutex> lock(mutex);
+        woken = true;
+        changed.notify_one();
+    }
+
+    // Waits while kMaxQueuedMessages are unsent; false once the session closed
+    bool push(WebSocketOpcode opcode, std::string payload) {
+        std::unique_lock<std::mutex> lock(mutex);
+        drained.wait(lock, [this]() { return closed || outbox.size() < kMaxQueuedMessages; });
+        if (closed) {
+            return false;
+        }
+        outbox.emplace_back(opcode, std::move(payload));
+        changed.notify_one();
+        return true;
+    }
+
+    void close() {
+        std::lock_guard<std::mutex> lock(mutex);
+        closed = true;
+        changed.notify_one();
+        drained.notify_all();
+    }
+
+    // Writer thread body; returns once closed (after sending what was queued)
+    void run(int fd, EventHub::Subscription& subscription) {
+        std::deque<std::pair<WebSocketOpcode, std::string>> messages;
+        std::vector<std::string> events;
+        std::string out;
+        while (true) {
+            bool closing;
+            {
+                std::unique_lock<std::mutex> lock(mutex);
+                changed.wait(lock, [this]() { return closed || woken || !outbox.empty(); });
+                closing = closed;
+                woken = false;
+                messages.swap(outbox);
+            }
+            drained.notify_all();
+
+            out.clear();
+            for (const auto& message : messages) {
+                encodeWebSocketFrame(message.first, message.second, out);
+            }
+            messages.clear();
+            if (!closing) {
+                events.clear();
+                subscription.poll(events);
+                for (const std::string& event : events) {
+                    encodeWebSocketFrame(WebSocketOpcode::TEXT, event, out);
+                }
+            }
+            if (!out.empty() && !sendAll(fd, out)) {
+                // Unblocks the reader too
+                close();
+                ::shutdown(fd, SHUT_RDWR);
+                return;
+            }
+            if (closing) {
+                return;
+            }
+        }
+    }
+
+private:
+    std::mutex mutex;
+    std::condition_variable changed;   // Writer waits for work
+    std::condition_variable drained;   // Reader waits for room
+    std::deque<std::pair<WebSocketOpcode, std::string>> outbox;
+    bool woken = true;   // The first poll sends the full board
+    bool closed = false;
+};
+}
+
+ApiServer::ApiServer(SudokuJsonApi& api, AdmissionController& admission)
+    : api(api), admission(admission),
+      allowedOrigins{"null", "http://localhost:5000", "http://127.0.0.1:5000"} {
+    uint64_t revision = 0;
+    Board current = api.snapshotBoard(&revision);
+    events.boardChanged(current, revision);
+    api.setEventListener(&events);
+    
+    // An admitted request waiting for the one neuro-symbolic network (held by
+    // a train_batch, say) gives up after its class deadline, not never
+    for (int i = 0; i < kCostClassCount; ++i) {
+        CostClass costClass = static_cast<CostClass>(i);
+        api.setSolverWait(costClass, admission.getLimits(costClass).maxQueueWaitMs);
+    }
+}
+
+ApiServer::~ApiServer() {
+    stop();
+    api.setEventListener(nullptr);
+}
+
+bool ApiServer::listen(int requestedPort, std::string& error) {
+    listenFd = ::socket(AF_INET, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (listenFd < 0) {
+        error = std::string("socket: ") + std::strerror(errno);
+        return false;
+    }
+    int reuse = 1;
+    ::setsockopt(listenFd, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse));
+
+    sockaddr_in address{};
+    address.sin_family = AF_INET;
+    address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    address.sin_port = htons(static_cast<uint16_t>(requestedPort));
+    if (::bind(listenFd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) < 0 ||
+        ::listen(listenFd, SOMAXCONN) < 0) {
+        error = "port " + std::to_string(requestedPort) + ": " + std::strerror(errno);
+        ::close(listenFd);
+        listenFd = -1;
+        return false;
+    }
+
+    socklen_t length = sizeof(address);
+    ::getsockname(listenFd, reinterpret_cast<sockaddr*>(&address), &length);
+    port = ntohs(address.sin_port);
+    return true;
+}
+
+void ApiServer::serve() {
+    SUDOKU_LOG_INFO("server", "listening port=" << port);
+    while (!stopping.load()) {
+        int fd = ::accept4(listenFd, nullptr, nullptr, SOCK_CLOEXEC);
+        if (fd < 0) {
+            if (errno == EINTR || errno == ECONNABORTED) continue;
+            if (!stopping.load()) {
+                SUDOKU_LOG_ERROR("server", "accept failed error=" << std::strerror(errno));
+            }
+            break;
+        }
+        {
+            std::lock_guard<std::mutex> lock(connectionsMutex);
+            connections.insert(fd);
+        }
+        std::thread([this, fd]() { serveConnection(fd); }).detach();
+    }
+}
+
+void ApiServer::stop() {
+    if (stopping.exchange(true)) {
+        return;
+    }
+    if (listenFd >= 0) {
+        // Wakes the accept() in serve()
+        ::shutdown(listenFd, SHUT_RDWR);
+        ::close(listenFd);
+        listenFd = -1;
+    }
+
+    std::unique_lock<std::mutex> lock(connectionsMutex);
+    for (int fd : connections) {
+        ::shutdown(fd, SHUT_RDWR);
+    }
+    connectionsDone.wait(lock, [this]() { return connections.empty(); });
+}
+
+std::string ApiServer::handle(const std::string& command, const std::string& params,
+                              const std::string& client) {
+    if (command == "server_stats") {
+        return statsJson();
+    }
+
+    CostClass costClass = AdmissionController::classify(command);
+    if (command == "solve_custom_puzzle") {
+        return handleCustomSolve(params, client);
+    }
+    AdmissionController::Ticket ticket = admission.admit(costClass, client);
+    if (!ticket) {
+        return busyResponse(ticket);
+    }
+
+    TraceSession trace(command, TraceSession::shouldTrace(false));
+    std::string response = api.processCommand(command, params);
+    trace.finish();
+    SUDOKU_LOG_DEBUG("server", "command=" << command << " class=" << AdmissionController::className(costClass)
+                     << " client=" << client << " queued_ms=" << ticket.getQueuedMs());
+    return response;
+}
+
+std::string ApiServer::handleCustomSolve(const std::string& params, const std::string& client) {
+    std::string solverType;
+    Board puzzle;
+    std::string response;
+    if (!api.parseCustomSolve(params, solverType, puzzle, response)) {
+        return response;
+    }
+    // Waits on another request's identical solve instead of occupying a solve slot
+    if (std::shared_ptr<const CustomSolveResult> shared = api.joinRunningSolve(solverType, puzzle)) {
+        return api.customSolveResponse(*shared);
+    }
+    AdmissionController::Ticket ticket = admission.admit(CostClass::SOLVE, client);
+    if (!ticket) {
+        return busyResponse(ticket);
+    }
+
+    TraceSession trace("solve_custom_puzzle", TraceSession::shouldTrace(false));
+    response = api.customSolveResponse(*api.solveCustomBoard(solverType, puzzle));
+    trace.finish();
+    SUDOKU_LOG_DEBUG("server", "command=solve_custom_puzzle class=solve client=" << client
+                     << " queued_ms=" << ticket.getQueuedMs());
+    return response;
+}
+
+std::string ApiServer::busyResponse(const AdmissionController::Ticket& ticket) {
+    return SudokuJsonApi::busyResponse(ticket.getClass(), ticket.getRetryAfterMs());
+}
+
+std::string ApiServer::sanitizeClient(const std::string& client) {
+    if (client.empty() || client.size() > 64) {
+        return "default";
+    }
+    for (char c : client) {
+        bool allowed = (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || (c >= '0' && c <= '9') ||
+                       c == '.' || c == '_' || c == '-';
+        if (!allowed) {
+            return "default";
+        }
+    }
+    return client;
+}
+
+void ApiServer::serveConnection(int fd) {
+    std::string pending;
+    if (readMore(fd, pending)) {
+        if (static_cast<unsigned char>(pending[0]) == kBinaryMagic) {
+            pending.erase(0, 1);
+            serveFrames(fd, pending);
+        } else if (pending.compare(0, 4, "GET ") == 0) {
+            serveWebSocket(fd, pending);
+        } else {
+            serveLines(fd, pending);
+        }
+    }
+
+    // Closed under the lock so accept() cannot reuse the number before it is erased
+    std::lock_guard<std::mutex> lock(connectionsMutex);
+    ::close(fd);
+    connections.erase(fd);
+    connectionsDone.notify_all();
+}
+
+void ApiServer::serveLines(int fd, std::string& pending) {
+    do {
+        size_t start = 0;
+        size_t end;
+        while ((end = pending.find('\n', start)) != std::string::npos) {
+            std::string command, params, client;
+            parseRequestLine(pending.substr(start, end - start), command, params, client);
+            start = end + 1;
+            if (command.empty()) continue;
+
+            if (!sendAll(fd, handle(command, params, sanitizeClient(client)) + "\n")) {
+                return;
+            }
+        }
+        pending.erase(0, start);
+
+        if (pending.size() > kMaxRequestBytes) {
+            SUDOKU_LOG_WARN("server", "request too long bytes=" << pending.size());
+            return;
+        }
+    } while (readMore(fd, pending));
+}
+
+void ApiServer::serveFrames(int fd, std::string& pending) {
+    std::string out;
+    do {
+        // Answers every complete frame that arrived, then sends the replies in one write
+        size_t start = 0;
+        out.clear();
+        while (pending.size() - start >= 4) {
+            uint32_t length = decodeFrameLength(pending.data() + start);
+            if (length > kBinaryMaxFrame) {
+                SUDOKU_LOG_WARN("server", "binary frame too long bytes=" << length);
+                sendAll(fd, out);
+                return;
+            }
+            if (pending.size() - start - 4 < length) break;
+            handleFrame(pending.data() + start + 4, length, out);
+            start += 4 + length;
+        }
+        pending.erase(0, start);
+        if (!out.empty() && !sendAll(fd, out)) {
+            return;
+        }
+    } while (readMore(fd, pending));
+}
+
+void ApiServer::serveWebSocket(int fd, std::string& pending) {
+    size_t headEnd;
+    while ((headEnd = findHttpHeadEnd(pending)) == 0) {
+        if (pending.size() > kMaxHttpHeadBytes || !readMore(fd, pending)) {
+            return;
+        }
+    }
+    std::string reply;
+    bool upgraded = acceptWebSocketUpgrade(pending.substr(0, headEnd), allowedOrigins, reply);
+    if (!sendAll(fd, reply) || !upgraded) {
+        return;
+    }
+    pending.erase(0, headEnd);
+    SUDOKU_LOG_DEBUG("server", "websocket open fd=" << fd << " subscribers=" << events.getSubscriberCount() + 1);
+
+    PushSession session;
+    EventHub::Subscription subscription(events, [&session]() { session.wake(); });
+    std::thread writer([&session, &subscription, fd]() { session.run(fd, subscription); });
+
+    std::string message;
+    WebSocketFrame frame;
+    bool open = true;
+    do {
+        size_t offset = 0;
+        FrameStatus status = FrameStatus::INCOMPLETE;
+        while (open && (status = decodeWebSocketFrame(pending, offset, frame, kMaxRequestBytes)) == FrameStatus::OK) {
+            switch (frame.opcode) {
+                case WebSocketOpcode::CLOSE:
+                    // Echo the status code, then hang up
+                    session.push(WebSocketOpcode::CLOSE, frame.payload.substr(0, 2));
+                    open = false;
+                    break;
+                case WebSocketOpcode::PING:
+                    open = session.push(WebSocketOpcode::PONG, frame.payload);
+                    break;
+                case WebSocketOpcode::PONG:
+                    break;
+                default: {
+                    message += frame.payload;
+                    if (message.size() > kMaxRequestBytes) {
+                        open = false;
+                        break;
+                    }
+                    if (!frame.fin) {
+                        break;
+                    }
+                    std::string command, params, client;
+                    parseRequestLine(message, command, params, client);
+                    message.clear();
+                    if (!command.empty()) {
+                        std::string response = handle(command, params, sanitizeClient(client));
+                        open = session.push(WebSocketOpcode::TEXT,
+                                            "{\"type\":\"response\",\"response\":" + response + "}");
+                    }
+                    break;
+                }
+            }
+        }
+        if (status == FrameStatus::ERROR) {
+            SUDOKU_LOG_WARN("server", "websocket protocol error fd=" << fd);
+            open = false;
+        }
+        pending.erase(0, offset);
+    } while (open && readMore(fd, pending));
+
+    session.close();
+    writer.join();
+}
+
+void ApiServer::handleFrame(const char* data, size_t length, std::string& out) {
+    BinaryRequest request;
+    BinaryResponse response;
+    if (!decodeBinaryRequest(data, length, request, response.message)) {
+        response.status = BinaryStatus::ERROR;
+        encodeBinaryResponse(response, out);
+        return;
+    }
+    const char* command = binaryCommandName(request.command);
+    CostClass costClass = AdmissionController::classify(command);
+    std::string client = sanitizeClient(request.client);
+    response.solver = request.solver;
+
+    auto busy = [&](const AdmissionController::Ticket& ticket) {
+        response.status = BinaryStatus::BUSY;
+        response.retryAfterMs = static_cast<uint32_t>(ticket.getRetryAfterMs() + 0.5);
+        response.message = "Server busy, retry later";
+        encodeBinaryResponse(response, out);
+    };
+
+    if (request.command == BinaryCommand::GET_BOARD) {
+        AdmissionController::Ticket ticket = admission.admit(costClass, client);
+        if (!ticket) {
+            busy(ticket);
+            return;
+        }
+        Board current = api.snapshotBoard();
+        response.status = BinaryStatus::OK;
+        response.board = &current;
+        encodeBinaryResponse(response, out);
+        return;
+    }
+
+    Board puzzle;
+    std::string solverType = SolverFactory::getSolverTypeName(static_cast<SolverType>(request.solver));
+    if (!unpackBoard(request.boardSize, request.cells, puzzle, response.message)) {
+        response.status = BinaryStatus::ERROR;
+        encodeBinaryResponse(response, out);
+        return;
+    }
+
+    // Same admission rule as the text protocol: joining a running solve is free
+    AdmissionController::Ticket ticket;
+    std::shared_ptr<const CustomSolveResult> outcome = api.joinRunningSolve(solverType, puzzle);
+    if (!outcome) {
+        ticket = admission.admit(costClass, client);
+        if (!ticket) {
+            busy(ticket);
+            return;
+        }
+        TraceSession trace(command, TraceSession::shouldTrace(false));
+        outcome = api.solveCustomBoard(solverType, puzzle);
+        trace.finish();
+    }
+    if (outcome->busy) {
+        response.status = BinaryStatus::BUSY;
+        response.retryAfterMs = static_cast<uint32_t>(outcome->retryAfterMs + 0.5);
+        response.message = outcome->message;
+        encodeBinaryResponse(response, out);
+        return;
+    }
+    if (!outcome->accepted) {
+        response.status = BinaryStatus::ERROR;
+        response.message = outcome->message;
+        encodeBinaryResponse(response, out);
+        return;
+    }
+    response.status = outcome->solved ? BinaryStatus::SOLVED : BinaryStatus::UNSOLVED;
+    response.moves = static_cast<uint32_t>(outcome->moves);
+    response.timeUs = static_cast<uint32_t>(outcome->timeMs * 1000.0 + 0.5);
+    response.board = &outcome->solution;
+    if (!outcome->solved) {
+        response.message = outcome->message;
+    }
+    encodeBinaryResponse(response, out);
+}
+
+std::string ApiServer::statsJson() const {
+    std::ostringstream response;
+    response << "{\"success\":true,\"message\":\"Server statistics\",\"data\":{";
+    for (int i = 0; i < kCostClassCount; ++i) {
+        CostClass costClass = static_cast<CostClass>(i);
+        AdmissionStats stats = admission.getStats(costClass);
+        if (i > 0) response << ",";
+        response << "\"" << AdmissionController::className(costClass) << "\":{"
+                 << "\"admitted\":" << stats.admitted << ","
+                 << "\"rejected\":" << stats.rejected << ","
+                 << "\"running\":" << stats.running << ","
+                 << "\"queued\":" << stats.queued << ","
+                 << "\"service_ms\":" << stats.serviceMs
+                 << "}";
+    }
+    response << ",\"coalesced_solves\":" << api.getCoalescedSolveCount()
+             << ",\"push_clients\":" << events.getSubscriberCount()
+             << ",\"throttled_progress\":" << events.getThrottledProgressCount()
+             << ",\"clients\":[";
+    std::vector<ClientStats> clients = admission.getClientStats();
+    for (size_t i = 0; i < clients.size(); ++i) {
+        const ClientStats& client = clients[i];
+        if (i > 0) response << ",";
+        // Ids were sanitised on the way in, so they need no escaping
+        response << "{\"id\":\"" << client.id << "\","
+                 << "\"requests\":" << client.requests << ","
+                 << "\"throttled\":" << client.throttled << ","
+                 << "\"cpu_ms\":" << client.cpuMs << ","
+                 << "\"tokens_ms\":" << client.tokensMs << ","
+                 << "\"weight\":" << client.weight
+                 << "}";
+    }
+    response << "]}}";
+    return response.str();
+}
@@ -0,0 +1,116 @@
+/*
+ApiServer - long-lived TCP front end for SudokuJsonApi (sudoku_api serve)
+One process keeps the game state, warmed solvers and loaded models across
+requests instead of paying process start-up for every command. Clients send
+one request per line and get one JSON response per line:
+
+    solve_puzzle<TAB>backtrack<LF>   ->   {"success":true,...}<LF>
+    solve_puzzle<TAB>backtrack<TAB>alice<LF>
+
+The params field (and its tab) may be omitted. The optional third field
+names the client the request's CPU time is charged to (letters, digits and
+"._-", up to 64 characters); without it the client is "default". Every
+request passes the
+AdmissionController before it reaches processCommand; a shed request gets
+{"success":false,...,"data":{"class":"job","retry_after_ms":N}} at once.
+An admitted request that needs the single neuro-symbolic network gets the
+same reply when the network stays busy (e.g. with a train_batch) for its
+class's queue deadline, so it never holds its slot for longer than that.
+`server_stats` reports the per-class admission counters. A custom solve
+that joins an identical one already running skips admission: it uses no
+solver time of its own.
+
+A connection whose first byte is 0xB5 speaks the binary protocol instead
+(binary_protocol.h): length-prefixed frames with packed boards and a
+fixed-layout reply. Binary requests go through the same admission classes,
+client accounting and SudokuJsonApi handlers as their text equivalents.
+
+A connection that starts with "GET " is an HTTP request for a WebSocket
+(any path, e.g. ws://127.0.0.1:8765/events). Each text message it sends is
+a request in the line format above and is answered with
+{"type":"response","response":{...}}; in between, the server pushes
+EventHub board deltas and live progress of game-board solves, so a client
+animates a whole solve from one request. Responses are queued up to
+kMaxQueuedMessages; past that the server stops reading from the client.
+Upgrades from browser pages are refused (403) unless the page's origin is
+allowed: by default "null" (web/index.html opened from disk) and the Flask
+bridge's http://localhost:5000 and http://127.0.0.1:5000.
+
+Each connection is served by its own thread, so a client waiting on a long
+job does not hold up others. The server listens on the loopback interface
+only.
+*/
+
+#ifndef SUDOKU_API_API_SERVER_H
+#define SUDOKU_API_API_SERVER_H
+
+#include "admission_controller.h"
+#include "binary_protocol.h"
+#include "event_hub.h"
+#include "json_api.h"
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <set>
+#include <string>
+#include <vector>
+
+class ApiServer {
+public:
+    ApiServer(SudokuJsonApi& api, AdmissionController& admission);
+    ~ApiServer();
+
+    ApiServer(const ApiServer&) = delete;
+    ApiServer& operator=(const ApiServer&) = delete;
+
+    // Binds 127.0.0.1:port (0 picks a free port); false with a message on failure
+    bool listen(int port, std::string& error);
+    int getPort() const { return port; }
+
+    // Accepts connections until stop() is called
+    void serve();
+
+    // Stops accepting, closes open connections and waits for their threads
+    void stop();
+
+    // One request through admission control and the API, whatever the transport
+    std::string handle(const std::string& command, const std::string& params,
+                       const std::string& client = "default");
+
+    // Client id as given, or "default" when empty or not made of [A-Za-z0-9._-]{1,64}
+    static std::string sanitizeClient(const std::string& client);
+
+    // Board and progress events pushed to WebSocket clients
+    EventHub& getEvents() { return events; }
+
+    // Replaces the page origins allowed to open a WebSocket
+    void setAllowedOrigins(const std::vector<std::string>& origins) { allowedOrigins = origins; }
+
+private:
+    void serveConnection(int fd);
+    // Codec loops; pending holds bytes already read from the socket
+    void serveLines(int fd, std::string& pending);
+    void serveFrames(int fd, std::string& pending);
+    void serveWebSocket(int fd, std::string& pending);
+    // Decodes one frame payload and appends the response frame to out
+    void handleFrame(const char* data, size_t length, std::string& out);
+    // solve_custom_puzzle: parsed once, joins an identical running solve or
+    // leads a new one under a solve ticket
+    std::string handleCustomSolve(const std::string& params, const std::string& client);
+    static std::string busyResponse(const AdmissionController::Ticket& ticket);
+    std::string statsJson() const;
+
+    SudokuJsonApi& api;
+    AdmissionController& admission;
+    EventHub events;
+    std::vector<std::string> allowedOrigins;
+    int listenFd = -1;
+    int port = 0;
+    std::atomic<bool> stopping{false};
+
+    std::mutex connectionsMutex;
+    std::condition_variable connectionsDone;
+    std::set<int> connections;
+};
+
+#endif // SUDOKU_API_API_SERVER_H
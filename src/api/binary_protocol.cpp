@@ -0,0 +1,129 @@
+/*
+BinaryProtocol implementation
+*/
+
+#include "binary_protocol.h"
+#include <algorithm>
+#include <cmath>
+
+namespace {
+
+void putU16(std::string& out, uint16_t value) {
+    out.push_back(static_cast<char>(value & 0xFF));
+    out.push_back(static_cast<char>(value >> 8));
+}
+
+void putU32(std::string& out, uint32_t value) {
+    for (int shift = 0; shift < 32; shift += 8) {
+        out.push_back(static_cast<char>((value >> shift) & 0xFF));
+    }
+}
+
+void setU32(std::string& out, size_t offset, uint32_t value) {
+    for (int i = 0; i < 4; ++i) {
+        out[offset + i] = static_cast<char>((value >> (8 * i)) & 0xFF);
+    }
+}
+
+}
+
+const char* binaryCommandName(BinaryCommand command) {
+    switch (command) {
+        case BinaryCommand::SOLVE:
+            return "solve_custom_puzzle";
+        case BinaryCommand::GET_BOARD:
+            return "get_board";
+    }
+    return "unknown";
+}
+
+uint32_t decodeFrameLength(const char* data) {
+    const unsigned char* bytes = reinterpret_cast<const unsigned char*>(data);
+    return static_cast<uint32_t>(bytes[0]) | static_cast<uint32_t>(bytes[1]) << 8 |
+           static_cast<uint32_t>(bytes[2]) << 16 | static_cast<uint32_t>(bytes[3]) << 24;
+}
+
+bool decodeBinaryRequest(const char* data, size_t length, BinaryRequest& request, std::string& error) {
+    const unsigned char* bytes = reinterpret_cast<const unsigned char*>(data);
+    if (length < 4) {
+        error = "frame shorter than the request header";
+        return false;
+    }
+    uint8_t command = bytes[0];
+    if (command != static_cast<uint8_t>(BinaryCommand::SOLVE) &&
+        command != static_cast<uint8_t>(BinaryCommand::GET_BOARD)) {
+        error = "unknown command id " + std::to_string(command);
+        return false;
+    }
+    request.command = static_cast<BinaryCommand>(command);
+    request.solver = bytes[1];
+    size_t clientLength = bytes[2];
+    request.boardSize = bytes[3];
+
+    size_t cellCount = static_cast<size_t>(request.boardSize) * request.boardSize;
+    if (length != 4 + clientLength + cellCount) {
+        error = "frame length does not match client id and board size";
+        return false;
+    }
+    request.client.assign(data + 4, clientLength);
+    request.cells.assign(data + 4 + clientLength, cellCount);
+    return true;
+}
+
+void encodeBinaryResponse(const BinaryResponse& response, std::string& out) {
+    size_t frameStart = out.size();
+    putU32(out, 0);  // Length, filled in below
+
+    int boardSize = response.board ? response.board->getBoardSize() : 0;
+    out.push_back(static_cast<char>(response.status));
+    out.push_back(static_cast<char>(response.solver));
+    out.push_back(static_cast<char>(boardSize));
+    out.push_back(0);
+    putU32(out, response.moves);
+    putU32(out, response.timeUs);
+    putU32(out, response.retryAfterMs);
+    if (response.board) {
+        packBoard(*response.board, out);
+    }
+    size_t messageLength = std::min<size_t>(response.message.size(), 0xFFFF);
+    putU16(out, static_cast<uint16_t>(messageLength));
+    out.append(response.message, 0, messageLength);
+
+    setU32(out, frameStart, static_cast<uint32_t>(out.size() - frameStart - 4));
+}
+
+void packBoard(const Board& board, std::string& out) {
+    int size = board.getBoardSize();
+    out.reserve(out.size() + static_cast<size_t>(size) * size);
+    for (int row = 0; row < size; ++row) {
+        for (int col = 0; col < size; ++col) {
+            const Cell& cell = board.getCell(row, col);
+            out.push_back(static_cast<char>(cell.getValue() | (cell.isLocked() ? 0x80 : 0)));
+        }
+    }
+}
+
+bool unpackBoard(int boardSize, const std::string& cells, Board& board, std::string& error) {
+    int gridSize = static_cast<int>(std::lround(std::sqrt(boardSize)));
+    if (boardSize <= 0 || boardSize > 0x7F || gridSize * gridSize != boardSize) {
+        error = "board size " + std::to_string(boardSize) + " is not a perfect square up to 121";
+        return false;
+    }
+    if (board.getBoardSize() != boardSize) {
+        board = Board(gridSize);
+    }
+    for (int row = 0; row < boardSize; ++row) {
+        for (int col = 0; col < boardSize; ++col) {
+            unsigned char packed = static_cast<unsigned char>(cells[row * boardSize + col]);
+            int value = packed & 0x7F;
+            if (value > boardSize) {
+                error = "cell value " + std::to_string(value) + " out of range";
+                return false;
+            }
+            Cell& cell = board.getCell(row, col);
+            cell.setValue(value);
+            cell.setLocked((packed & 0x80) != 0);
+        }
+    }
+    return true;
+}
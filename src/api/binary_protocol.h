@@ -0,0 +1,95 @@
+/*
+BinaryProtocol - compact length-prefixed framing for sudoku_api serve
+High-volume clients send and receive thousands of boards; as JSON every
+9x9 board is ~2 KB of text to build and parse. The binary codec carries a
+board as one byte per cell and replies with a fixed-layout header.
+
+A connection chooses its codec with its first byte: kBinaryMagic (0xB5)
+selects binary for the rest of the connection, anything else is the text
+protocol. After the magic byte every message is a frame:
+
+    u32 length (little-endian, bytes that follow)  payload
+
+Request payload:
+    u8  command        BinaryCommand
+    u8  solver         SolverType (SOLVE only)
+    u8  clientLength   followed by that many client-id bytes
+    u8  boardSize      0 when the command takes no board, else 4, 9, 16, ...
+    ... client id
+    ... boardSize * boardSize cells, row-major: value | 0x80 when locked
+
+Response payload (16-byte header, then the board, then a message):
+    u8  status         BinaryStatus
+    u8  solver
+    u8  boardSize
+    u8  reserved (0)
+    u32 moves
+    u32 timeUs         solver time
+    u32 retryAfterMs   BUSY only
+    ... boardSize * boardSize cells, as in the request
+    u16 messageLength  followed by the message (empty on success)
+
+Requests on one connection are answered in order.
+*/
+
+#ifndef SUDOKU_API_BINARY_PROTOCOL_H
+#define SUDOKU_API_BINARY_PROTOCOL_H
+
+#include "../model/board.h"
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+constexpr uint8_t kBinaryMagic = 0xB5;
+constexpr size_t kBinaryMaxFrame = 1 << 20;
+constexpr size_t kBinaryResponseHeader = 16;
+
+enum class BinaryCommand : uint8_t {
+    SOLVE = 1,       // Solve the board in the request (solve_custom_puzzle)
+    GET_BOARD = 2    // Current game board (get_board)
+};
+
+enum class BinaryStatus : uint8_t {
+    SOLVED = 0,
+    UNSOLVED = 1,    // Board holds the partial solution
+    OK = 2,          // Non-solve command succeeded
+    ERROR = 3,       // Message says why
+    BUSY = 4         // Shed by admission control; see retryAfterMs
+};
+
+struct BinaryRequest {
+    BinaryCommand command = BinaryCommand::GET_BOARD;
+    uint8_t solver = 0;
+    std::string client;
+    int boardSize = 0;
+    std::string cells;   // boardSize * boardSize packed cells
+};
+
+struct BinaryResponse {
+    BinaryStatus status = BinaryStatus::OK;
+    uint8_t solver = 0;
+    uint32_t moves = 0;
+    uint32_t timeUs = 0;
+    uint32_t retryAfterMs = 0;
+    const Board* board = nullptr;   // Not owned; null for no board
+    std::string message;
+};
+
+// Text-protocol command a binary command runs as (admission class, tracing)
+const char* binaryCommandName(BinaryCommand command);
+
+// Length prefix at data[0..3]
+uint32_t decodeFrameLength(const char* data);
+
+// Parses one frame payload; false (with a message) when it is malformed
+bool decodeBinaryRequest(const char* data, size_t length, BinaryRequest& request, std::string& error);
+
+// Appends a complete frame (length prefix included) to out
+void encodeBinaryResponse(const BinaryResponse& response, std::string& out);
+
+// Board <-> packed cells; unpackBoard fails on a non-square size, a size whose
+// values do not fit in seven bits, or a bad value
+void packBoard(const Board& board, std::string& out);
+bool unpackBoard(int boardSize, const std::string& cells, Board& board, std::string& error);
+
+#endif // SUDOKU_API_BINARY_PROTOCOL_H
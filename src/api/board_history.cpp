@@ -0,0 +1,62 @@
+/*
+BoardHistory implementation
+*/
+
+#include "board_history.h"
+#include "binary_protocol.h"
+#include <chrono>
+
+BoardHistory::BoardHistory(size_t window) : window(window) {
+    revision = static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count());
+    floor = revision;
+}
+
+uint64_t BoardHistory::record(const Board& board) {
+    std::string current;
+    packBoard(board, current);
+
+    if (board.getBoardSize() != size || current.size() != cells.size()) {
+        // New size (or the first board): nothing earlier can be diffed against
+        size = board.getBoardSize();
+        cells.swap(current);
+        entries.clear();
+        floor = ++revision;
+        return revision;
+    }
+
+    size_t before = entries.size();
+    for (size_t i = 0; i < current.size(); ++i) {
+        if (current[i] != cells[i]) {
+            entries.push_back({revision + 1, static_cast<int>(i), static_cast<unsigned char>(current[i])});
+        }
+    }
+    if (entries.size() == before) {
+        return revision;
+    }
+    ++revision;
+    cells.swap(current);
+
+    while (entries.size() > window) {
+        // Clients at the dropped entry's revision or later do not need it
+        floor = entries.front().revision;
+        entries.pop_front();
+    }
+    return revision;
+}
+
+bool BoardHistory::changesSince(uint64_t since, std::vector<Change>& changes) const {
+    if (since < floor || since > revision) {
+        return false;
+    }
+    // Newest first, so each cell is reported once with its latest value
+    std::vector<bool> seen(cells.size(), false);
+    for (auto it = entries.rbegin(); it != entries.rend() && it->revision > since; ++it) {
+        if (seen[it->index]) {
+            continue;
+        }
+        seen[it->index] = true;
+        changes.push_back({it->index / size, it->index % size, it->packed & 0x7F, (it->packed & 0x80) != 0});
+    }
+    return true;
+}
@@ -0,0 +1,67 @@
+/*
+BoardHistory - revision counter and recent cell changes of the game board
+Every committed change to the game board is recorded as the list of cells
+that differ from the previous commit, under a new revision number. A client
+that remembers the revision of the board it holds can then be sent just the
+cells changed since, instead of the whole board:
+
+    uint64_t revision = history.record(board);          // after each change
+    std::vector<BoardHistory::Change> changes;
+    if (!history.changesSince(clientRevision, changes)) ... send a snapshot
+
+Only the last `window` cell changes are kept. A client further behind than
+that, or holding a revision this history never issued, gets false and
+should be sent the full board. Revisions start from the wall-clock time in
+microseconds when the history is created, so a revision handed out by an
+earlier process is always below the window and never mistaken for a
+recent one.
+
+Not thread-safe; SudokuJsonApi calls it under its state lock.
+*/
+
+#ifndef SUDOKU_API_BOARD_HISTORY_H
+#define SUDOKU_API_BOARD_HISTORY_H
+
+#include "../model/board.h"
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <string>
+#include <vector>
+
+class BoardHistory {
+public:
+    struct Change {
+        int row;
+        int col;
+        int value;
+        bool locked;
+    };
+
+    explicit BoardHistory(size_t window = 1024);
+
+    // Diffs board against the last recorded one; returns the new revision,
+    // or the current one when nothing changed
+    uint64_t record(const Board& board);
+    uint64_t getRevision() const { return revision; }
+
+    // Latest value of every cell changed after `since`; false when the
+    // changes are no longer (or were never) known
+    bool changesSince(uint64_t since, std::vector<Change>& changes) const;
+
+private:
+    struct Entry {
+        uint64_t revision;
+        int index;            // row * size + col
+        unsigned char packed; // value | 0x80 when locked
+    };
+
+    size_t window;
+    uint64_t revision;
+    uint64_t floor;           // Oldest revision changesSince() can answer from
+    int size = 0;
+    std::string cells;        // Packed board as of `revision`
+    std::deque<Entry> entries;
+};
+
+#endif // SUDOKU_API_BOARD_HISTORY_H
@@ -4,12 +4,48 @@ from flask_cors import CORS
 import subprocess
 import json
 import os
+import sys
 
 app = Flask(__name__)
 CORS(app)  # Allow web frontend to call API
 
+def load_engine():
+    """Import the in-process C++ engine (make python-module), or None"""
+    for path in ["../../build/bin", "./build/bin", "build/bin"]:
+        if os.path.isdir(path) and path not in sys.path:
+            sys.path.insert(0, path)
+    try:
+        import sudoku_engine
+    except ImportError as e:
+        print(f"⚠️  In-process engine unavailable ({e}); falling back to sudoku_api subprocesses")
+        return None
+    sudoku_engine.warm(2)
+    return sudoku_engine
+
+engine = load_engine()
+
+def since_param(value):
+    """The client's board revision, or "" when a delta cannot be answered.
+    Revisions belong to one process, and every sudoku_api subprocess starts a
+    new history, so only the in-process engine can send changed cells."""
+    if engine is None or value in (None, "", 0, "0"):
+        return ""
+    try:
+        return str(int(value))
+    except (TypeError, ValueError):
+        return ""
+
 def call_cpp_api(command, params=""):
     """Call the C++ API and return parsed JSON response"""
+    if engine is not None:
+        # Runs in this process; the engine releases the GIL while it works
+        try:
+            return json.loads(engine.process(command, params))
+        except json.JSONDecodeError as e:
+            return {"success": False, "message": f"JSON parse error: {e}"}
+        except Exception as e:
+            return {"success": False, "message": f"Unexpected error: {e}"}
+
     try:
         # Path to compiled C++ API executable - try multiple possible paths
         possible_paths = [
@@ -65,8 +101,8 @@ def call_cpp_api(command, params=""):
 
 @app.route('/api/board', methods=['GET'])
 def get_board():
-    """Get current board state from C++ backend"""
-    response = call_cpp_api("get_board")
+    """Get current board state from C++ backend (?since=<revision> for changes only)"""
+    response = call_cpp_api("get_board", since_param(request.args.get('since')))
     return jsonify(response)
 
 @app.route('/api/move', methods=['POST'])
@@ -75,8 +111,11 @@ def make_move():
     data = request.json
     row, col, value = data['row'], data['col'], data['value']
     
-    # Format parameters for C++ API: "row,col,value"
+    # Format parameters for C++ API: "row,col,value[,since]"
     params = f"{row},{col},{value}"
+    since = since_param(data.get('since'))
+    if since:
+        params += f",{since}"
     response = call_cpp_api("make_move", params)
     
     return jsonify(response)
@@ -180,6 +219,7 @@ if __name__ == '__main__':
     print("📡 Connecting Web Frontend ←→ C++ Backend")
     print("🌐 Server running on http://localhost:5000")
     print("💡 Make sure to compile C++ API first: make api")
+    print("⚡ Engine: " + ("in-process (sudoku_engine)" if engine is not None else "sudoku_api subprocess"))
     print("🔗 Web UI: Open web/index.html in browser")
     print("─" * 50)
     app.run(debug=True, port=5000)
@@ -0,0 +1,127 @@
+/*
+EventHub implementation
+*/
+
+#include "event_hub.h"
+#include "binary_protocol.h"
+#include <sstream>
+
+namespace {
+
+// "full":..,"size":..,"cells":[...] - every cell when sent is empty or a
+// different size, otherwise only the cells that differ
+void appendCells(std::ostringstream& event, int size, const std::string& sent,
+                 const std::string& current, bool withLock) {
+    bool full = sent.size() != current.size();
+    event << "\"full\":" << (full ? "true" : "false") << ",\"size\":" << size << ",\"cells\":[";
+    bool first = true;
+    for (size_t i = 0; i < current.size(); ++i) {
+        if (!full && sent[i] == current[i]) {
+            continue;
+        }
+        unsigned char packed = static_cast<unsigned char>(current[i]);
+        if (!first) event << ",";
+        first = false;
+        event << "[" << i / size << "," << i % size << "," << (packed & 0x7F);
+        if (withLock) {
+            event << "," << ((packed & 0x80) ? 1 : 0);
+        }
+        event << "]";
+    }
+    event << "]";
+}
+
+}
+
+EventHub::EventHub(double minProgressIntervalMs) : minProgressIntervalMs(minProgressIntervalMs) {}
+
+void EventHub::boardChanged(const Board& board, uint64_t revision) {
+    std::lock_guard<std::mutex> lock(mutex);
+    boardSize = board.getBoardSize();
+    boardCells.clear();
+    packBoard(board, boardCells);
+    boardRevision = revision;
+    // Whatever was being solved is now on the board (or was replaced)
+    progressCells.clear();
+    wakeSubscribers();
+}
+
+void EventHub::solveProgress(const std::string& solverName, const Board& board, int step) {
+    std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+    std::lock_guard<std::mutex> lock(mutex);
+    if (!progressCells.empty() &&
+        std::chrono::duration<double, std::milli>(now - lastProgress).count() < minProgressIntervalMs) {
+        ++throttledProgress;
+        return;
+    }
+    lastProgress = now;
+    progressSize = board.getBoardSize();
+    progressCells.clear();
+    packBoard(board, progressCells);
+    progressSolver = solverName;
+    progressStep = step;
+    ++progressVersion;
+    if (!subscribers.empty()) {
+        wakeSubscribers();
+    }
+}
+
+size_t EventHub::getSubscriberCount() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return subscribers.size();
+}
+
+uint64_t EventHub::getThrottledProgressCount() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return throttledProgress;
+}
+
+void EventHub::wakeSubscribers() {
+    for (auto& entry : subscribers) {
+        entry.second();
+    }
+}
+
+// ========== Subscription ==========
+
+EventHub::Subscription::Subscription(EventHub& hub, std::function<void()> wake) : hub(hub) {
+    std::lock_guard<std::mutex> lock(hub.mutex);
+    id = hub.nextSubscriber++;
+    hub.subscribers.emplace(id, std::move(wake));
+}
+
+EventHub::Subscription::~Subscription() {
+    std::lock_guard<std::mutex> lock(hub.mutex);
+    hub.subscribers.erase(id);
+}
+
+bool EventHub::Subscription::poll(std::vector<std::string>& events) {
+    std::lock_guard<std::mutex> lock(hub.mutex);
+    bool changed = false;
+
+    if (hub.progressVersion != progressVersion && !hub.progressCells.empty()) {
+        std::ostringstream event;
+        event << "{\"type\":\"progress\",\"solver\":\"" << hub.progressSolver << "\","
+              << "\"step\":" << hub.progressStep << ",";
+        appendCells(event, hub.progressSize, progressCells, hub.progressCells, false);
+        event << "}";
+        events.push_back(event.str());
+        progressCells = hub.progressCells;
+        changed = true;
+    }
+    progressVersion = hub.progressVersion;
+
+    if (hub.boardRevision != boardRevision && !hub.boardCells.empty()) {
+        std::ostringstream event;
+        event << "{\"type\":\"board\",\"revision\":" << hub.boardRevision << ",";
+        appendCells(event, hub.boardSize, boardCells, hub.boardCells, true);
+        event << "}";
+        events.push_back(event.str());
+        boardCells = hub.boardCells;
+        // The next solve's progress starts from this board
+        progressCells = hub.boardCells;
+        changed = true;
+    }
+    boardRevision = hub.boardRevision;
+    return changed;
+}
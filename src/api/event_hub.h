@@ -0,0 +1,89 @@
+/*
+EventHub - latest game board and solve progress for push clients
+SudokuJsonApi reports every game-board change and, during game-board solves,
+the solver's working board every few steps. The hub keeps only the latest
+of each (packed one byte per cell) with its revision or version, and wakes its
+subscribers. Each subscriber remembers what it last sent its client and,
+when its writer gets round to it, sends just the cells that differ:
+
+    {"type":"board","revision":12,"full":false,"size":9,"cells":[[0,2,4,0]]}
+    {"type":"progress","solver":"Backtracking Solver","step":640,"full":false,
+     "size":9,"cells":[[3,1,7],[3,2,0]]}
+
+Cells are [row, col, value(, locked)] with 0-based rows and columns, and
+"revision" is the game board's (SudokuJsonApi responses carry the same
+numbers, so a client can mix pushed deltas with get_board <since>). "full"
+means the list covers every cell and replaces what the client had (first
+event, or the board size changed). A slow client is never queued behind:
+whatever it missed while its socket was full collapses into one delta of
+each kind. Progress is also throttled at the source to one update per
+minProgressIntervalMs, which is as often as anyone can watch it.
+*/
+
+#ifndef SUDOKU_API_EVENT_HUB_H
+#define SUDOKU_API_EVENT_HUB_H
+
+#include "json_api.h"
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <string>
+#include <vector>
+
+class EventHub : public ApiEventListener {
+public:
+    explicit EventHub(double minProgressIntervalMs = 30.0);
+
+    void boardChanged(const Board& board, uint64_t revision) override;
+    void solveProgress(const std::string& solverName, const Board& board, int step) override;
+
+    // One push client. wake() is called from publishing threads (with the hub
+    // locked) whenever there is something new; the client's writer then calls poll().
+    class Subscription {
+    public:
+        Subscription(EventHub& hub, std::function<void()> wake);
+        ~Subscription();
+
+        Subscription(const Subscription&) = delete;
+        Subscription& operator=(const Subscription&) = delete;
+
+        // Appends a progress event and then a board event for whatever changed
+        // since the last poll; false when nothing did
+        bool poll(std::vector<std::string>& events);
+
+    private:
+        EventHub& hub;
+        uint64_t id;
+        uint64_t boardRevision = 0;
+        std::string boardCells;      // Packed board the client was last sent
+        uint64_t progressVersion = 0;
+        std::string progressCells;
+    };
+
+    size_t getSubscriberCount() const;
+    uint64_t getThrottledProgressCount() const;
+
+private:
+    mutable std::mutex mutex;
+    std::map<uint64_t, std::function<void()>> subscribers;
+    uint64_t nextSubscriber = 1;
+
+    uint64_t boardRevision = 0;
+    int boardSize = 0;
+    std::string boardCells;
+
+    uint64_t progressVersion = 0;
+    int progressSize = 0;
+    std::string progressCells;   // Empty when no solve is running
+    std::string progressSolver;
+    int progressStep = 0;
+    std::chrono::steady_clock::time_point lastProgress;
+    double minProgressIntervalMs;
+    uint64_t throttledProgress = 0;
+
+    void wakeSubscribers();
+};
+
+#endif // SUDOKU_API_EVENT_HUB_H
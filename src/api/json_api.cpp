@@ -3,33 +3,60 @@ JSON API Implementation for C++ Sudoku Game
 */
 
 #include "json_api.h"
+#include "binary_protocol.h"
+#include "../model/board_json.h"
+#include "../solver/training_scheduler.h"
+#include "../util/logger.h"
+#include "../util/trace.h"
 #include <iostream>
 #include <iomanip>
 #include <fstream>
 #include <chrono>
 #include <cmath>
+#include <cstdlib>
+
+namespace {
+// Solver steps between progress reports; listeners throttle further by time
+constexpr int kProgressInterval = 64;
+
+// Custom solve that threw; reported like one the solver refused
+std::shared_ptr<const CustomSolveResult> failedSolve(const std::string& message) {
+    auto outcome = std::make_shared<CustomSolveResult>();
+    outcome->message = message;
+    return outcome;
+}
+}
 
 SudokuJsonApi::SudokuJsonApi() : board(3), moveCount(0) {
-    // Load existing state or initialize with sample puzzle
+    // Hardware counters cost a few syscalls per solve, so they are opt-in
+    const char* counters = std::getenv("SUDOKU_PERF_COUNTERS");
+    collectCounters = counters != nullptr && std::string(counters) == "1";
+    
+    // Load existing state or initialize with sample puzzle, then the moves made since
     loadState();
+    journal.replay(board, moveCount);
+    history.record(board);
 }
 
 std::string SudokuJsonApi::processCommand(const std::string& command, const std::string& params) {
     try {
         if (command == "get_board") {
-            return getBoard();
+            // Optional param: revision the client already has
+            return getBoard(params.empty() ? 0 : std::stoull(params));
         }
         else if (command == "make_move") {
-            // Parse params: "row,col,value"
+            // Parse params: "row,col,value[,since]"
             std::istringstream iss(params);
             std::string token;
             int row = 0, col = 0, value = 0;
+            uint64_t since = 0;
             
             if (std::getline(iss, token, ',')) row = std::stoi(token);
             if (std::getline(iss, token, ',')) col = std::stoi(token);
             if (std::getline(iss, token, ',')) value = std::stoi(token);
+            if (std::getline(iss, token, ',')) since = std::stoull(token);
             
-            return makeMove(row, col, value);
+            return makeMove(row, col, value, since);
         }
         else if (command == "load_puzzle") {
             return loadPuzzle();
@@ -56,8 +83,23 @@ std::string SudokuJsonApi::processCommand(const std::string& command, const std:
             return getAIPossibleMoves(params);
         }
         else if (command == "train_batch") {
-            int numPuzzles = params.empty() ? 100 : std::stoi(params);
-            return trainOnPuzzleBatch(numPuzzles);
+            // Parse params: "numPuzzles,targetAccuracy,validationInterval" (optional)
+            std::istringstream iss(params);
+            std::string token;
+            int numPuzzles = 100, validationInterval = 0;
+            double targetAccuracy = 0.5;
+            
+            if (std::getline(iss, token, ',') && !token.empty()) {
+                numPuzzles = std::stoi(token);
+            }
+            if (std::getline(iss, token, ',') && !token.empty()) {
+                targetAccuracy = std::stod(token);
+            }
+            if (std::getline(iss, token, ',') && !token.empty()) {
+                validationInterval = std::stoi(token);
+            }
+            
+            return trainOnPuzzleBatch(numPuzzles, targetAccuracy, validationInterval);
         }
         else if (command == "training_stats") {
             return getTrainingStats();
@@ -86,34 +128,91 @@ std::string SudokuJsonApi::processCommand(const std::string& command, const std:
             return performCrossValidation(numPuzzles, kFolds, verbose);
         }
         else if (command == "performance_metrics") {
-            int testPuzzles = params.empty() ? 20 : std::stoi(params);
-            return getPerformanceMetrics(testPuzzles);
+            // Parse params: "testPuzzles,threads" (optional, threads=0 uses all cores)
+            std::istringstream iss(params);
+            std::string token;
+            int testPuzzles = 20, threads = 0;
+            
+            if (std::getline(iss, token, ',') && !token.empty()) {
+                testPuzzles = std::stoi(token);
+            }
+            if (std::getline(iss, token, ',') && !token.empty()) {
+                threads = std::stoi(token);
+            }
+            
+            return getPerformanceMetrics(testPuzzles, threads);
         }
         else if (command == "solve_custom_puzzle") {
-            // Parse params: "solver_type|puzzle_json"
-            size_t delimiter = params.find('|');
-            if (delimiter == std::string::npos) {
-                return createResponse(false, "Invalid parameters for solve_custom_puzzle");
+            std::string solverType;
+            Board puzzle;
+            std::string response;
+            if (!parseCustomSolve(params, solverType, puzzle, response)) {
+                return response;
             }
-            std::string solverType = params.substr(0, delimiter);
-            std::string puzzleJson = params.substr(delimiter + 1);
-            return solveCustomPuzzle(solverType, puzzleJson);
+            return customSolveResponse(*solveCustomBoard(solverType, puzzle));
         }
         else {
+            SUDOKU_LOG_WARN("api", "unknown command=" << command);
             return createResponse(false, "Unknown command: " + command);
         }
     }
     catch (const std::exception& e) {
+        SUDOKU_LOG_ERROR("api", "command failed command=" << command << " error=" << e.what());
         return createResponse(false, "Error: " + std::string(e.what()));
     }
 }
 
-std::string SudokuJsonApi::getBoard() {
-    std::string boardJson = boardToJson();
+void SudokuJsonApi::warmSolvers(int perType) {
+    for (SolverType type : SolverFactory::getAvailableSolvers()) {
+        solverPool.warm(type, perType);
+    }
+}
+
+void SudokuJsonApi::setSolverWait(CostClass costClass, double maxWaitMs) {
+    solverWaitMs[static_cast<int>(costClass)] = maxWaitMs;
+}
+
+std::string SudokuJsonApi::busyResponse(CostClass costClass, double retryAfterMs) {
+    std::ostringstream response;
+    response << "{\"success\":false,\"message\":\"Server busy, retry later\","
+             << "\"data\":{\"class\":\"" << AdmissionController::className(costClass) << "\","
+             << "\"retry_after_ms\":" << static_cast<long long>(retryAfterMs + 0.5)
+             << "}}";
+    return response.str();
+}
+
+SolverPool::Lease SudokuJsonApi::borrowSolver(const std::string& solverType, CostClass costClass) {
+    double maxWaitMs = solverWaitMs[static_cast<int>(costClass)];
+    SolverPool::Lease lease = solverPool.borrow(solverType, maxWaitMs);
+    if (lease.isBusy()) {
+        SUDOKU_LOG_DEBUG("api", "solver busy solver=" << solverType << " class="
+                         << AdmissionController::className(costClass) << " waited_ms=" << maxWaitMs);
+    }
+    return lease;
+}
+
+std::string SudokuJsonApi::solverBusyResponse(CostClass costClass) const {
+    // The holder may keep the solver for a whole training batch; retrying
+    // after one wait limit is as good a guess as any
+    return busyResponse(costClass, solverWaitMs[static_cast<int>(costClass)]);
+}
+
+Board SudokuJsonApi::snapshotBoard(uint64_t* revision) {
+    std::lock_guard<std::mutex> lock(stateMutex);
+    if (revision) {
+        *revision = history.getRevision();
+    }
+    return board;
+}
+
+std::string SudokuJsonApi::getBoard(uint64_t since) {
+    std::lock_guard<std::mutex> lock(stateMutex);
+    std::string boardJson = boardStateJson(since);
     return createResponse(true, "Board retrieved", boardJson);
 }
 
-std::string SudokuJsonApi::makeMove(int row, int col, int value) {
+std::string SudokuJsonApi::makeMove(int row, int col, int value, uint64_t since) {
+    std::lock_guard<std::mutex> lock(stateMutex);
     // Convert to 0-based indexing
     row--; col--;
     
@@ -140,19 +239,20 @@ std::string SudokuJsonApi::makeMove(int row, int col, int value) {
     }
     
     moveCount++;
-    saveState(); // Persist state after each move
+    commitBoardChange(); // Persist state after each move
     
     std::string message = value == 0 ? "Cell cleared" : "Move made successfully";
-    std::string boardJson = boardToJson();
+    std::string boardJson = boardStateJson(since);
     
     return createResponse(true, message, boardJson);
 }
 
 std::string SudokuJsonApi::loadPuzzle() {
+    std::lock_guard<std::mutex> lock(stateMutex);
     initializeSamplePuzzle();
     moveCount = 0;
-    saveState(); // Persist the loaded puzzle
-    std::string boardJson = boardToJson();
+    commitBoardChange(); // Persist the loaded puzzle
+    std::string boardJson = boardStateJson();
     return createResponse(true, "Puzzle loaded", boardJson);
 }
 
@@ -164,6 +264,8 @@ std::string SudokuJsonApi::generatePuzzle(const std::string& difficulty) {
     else if (difficulty == "hard") diff = SudokuGenerator::HARD;
     else if (difficulty == "expert") diff = SudokuGenerator::EXPERT;
     
+    std::lock_guard<std::mutex> lock(stateMutex);
+    
     // Generate a complete grid first
     if (!generator.generateCompleteGrid(board)) {
         return createResponse(false, "Failed to generate complete grid");
@@ -184,12 +286,13 @@ std::string SudokuJsonApi::generatePuzzle(const std::string& difficulty) {
     }
     
     moveCount = 0;
-    saveState(); // Persist the generated puzzle
-    std::string boardJson = boardToJson();
+    commitBoardChange(); // Persist the generated puzzle
+    std::string boardJson = boardStateJson();
     return createResponse(true, "New puzzle generated with " + difficulty + " difficulty", boardJson);
 }
 
 std::string SudokuJsonApi::clearBoard() {
+    std::lock_guard<std::mutex> lock(stateMutex);
     for (int row = 0; row < board.getBoardSize(); ++row) {
         for (int col = 0; col < board.getBoardSize(); ++col) {
             board.getCell(row, col).setValue(0);
@@ -197,12 +300,13 @@ std::string SudokuJsonApi::clearBoard() {
         }
     }
     moveCount = 0;
-    saveState(); // Persist the cleared board
-    std::string boardJson = boardToJson();
+    commitBoardChange(); // Persist the cleared board
+    std::string boardJson = boardStateJson();
     return createResponse(true, "Board cleared", boardJson);
 }
 
 std::string SudokuJsonApi::getStatus() {
+    std::lock_guard<std::mutex> lock(stateMutex);
     bool isComplete = board.isComplete();
     bool isValid = board.isValid();
     
@@ -217,6 +321,7 @@ std::string SudokuJsonApi::getStatus() {
 }
 
 std::string SudokuJsonApi::validateBoard() {
+    std::lock_guard<std::mutex> lock(stateMutex);
     bool isValid = board.isValid();
     std::ostringstream oss;
     oss << "{\"valid\":" << (isValid ? "true" : "false") << "}";
@@ -224,207 +329,257 @@ std::string SudokuJsonApi::validateBoard() {
 }
 
 std::string SudokuJsonApi::solvePuzzle(const std::string& solverType) {
-    // Create or reuse solver - only create new if different type
-    if (!aiSolver || aiSolver->getSolverName().find(solverType) == std::string::npos) {
-        aiSolver = SolverFactory::createSolver(solverType);
-        if (!aiSolver) {
-            return createResponse(false, "Unknown solver type: " + solverType);
-        }
+    SolverPool::Lease lease = borrowSolver(solverType, CostClass::SOLVE);
+    if (lease.isBusy()) {
+        return solverBusyResponse(CostClass::SOLVE);
     }
-    
-    // Ensure neuro-symbolic solver is in inference mode for solving
-    if (solverType == "neuro_symbolic") {
-        auto* neuroSolver = dynamic_cast<NeuroSymbolicSolver*>(aiSolver.get());
-        if (neuroSolver) {
-            neuroSolver->setTrainingMode(false);  // Ensure we're in inference mode
-        }
+    if (!lease) {
+        return createResponse(false, "Unknown solver type: " + solverType);
     }
+    SudokuSolver& solver = lease.solver();
+    
+    // Solve a copy in the slot's scratch boards, without holding the state
+    // lock; the original is kept for training. The revision it was taken at
+    // decides whether the result may still be written back.
+    uint64_t snapshotRevision;
+    {
+        std::lock_guard<std::mutex> lock(stateMutex);
+        lease->original = board;
+        snapshotRevision = history.getRevision();
+    }
+    prepareSolver(*lease, lease->original.getBoardSize());
     
     // Check if puzzle can be solved
-    if (!aiSolver->canSolve(board)) {
+    if (!solver.canSolve(lease->original)) {
         return createResponse(false, "Puzzle cannot be solved - invalid state");
     }
     
-    // Make a copy of the board to solve
-    Board originalBoard = board;  // Keep original for training
-    Board solutionBoard = board;
+    // Game-board solves are what clients animate, so they report progress
+    ApiEventListener* listener = eventListener.load();
+    if (listener) {
+        std::string solverName = solver.getSolverName();
+        lease->context.progressInterval = kProgressInterval;
+        lease->context.onProgress = [listener, solverName](const Board& progress, int step) {
+            listener->solveProgress(solverName, progress, step);
+        };
+    }
+    lease->solution = lease->original;
     
     // Solve the puzzle
-    bool solved = aiSolver->solve(solutionBoard);
+    bool solved;
+    {
+        SUDOKU_TRACE_SPAN("solve");
+        solved = solver.solve(lease->solution, lease->context);
+    }
     
-    // Special handling for neuro-symbolic solver
-    if (solverType == "neuro_symbolic" && !solved) {
-        auto* neuroSolver = dynamic_cast<NeuroSymbolicSolver*>(aiSolver.get());
-        if (neuroSolver) {
-            // If neural network couldn't solve, get solution from backtrack solver to train on
-            auto backtrackSolver = SolverFactory::createSolver("backtrack");
-            Board trainingSolution = originalBoard;
-            
-            if (backtrackSolver && backtrackSolver->solve(trainingSolution)) {
-                // Train the neural network on this solution
-                neuroSolver->trainOnSolution(originalBoard, trainingSolution);
-                
-                // Now try to solve again with the trained network
-                solutionBoard = originalBoard; // Reset to original state
-                solved = neuroSolver->solve(solutionBoard);
-            }
-        }
+    if (lease->type == SolverType::NEURO_SYMBOLIC) {
+        solved = trainNeuroSolver(*lease, solved);
+    }
+    
+    std::lock_guard<std::mutex> lock(stateMutex);
+    
+    // A move, clear or new puzzle acknowledged during the solve wins: the
+    // solution belongs to a board that no longer exists
+    bool conflict = history.getRevision() != snapshotRevision;
+    if (!conflict) {
+        // Even if not fully solved, update the board with partial progress
+        board = lease->solution;
+        commitBoardChange();
     }
     
+    std::ostringstream result;
+    result << "{"
+           << "\"solved\":" << (solved ? "true" : "false") << ","
+           << "\"conflict\":" << (conflict ? "true" : "false") << ","
+           << "\"solver\":\"" << solver.getSolverName() << "\","
+           << "\"moves\":" << lease->context.movesCount << ","
+           << "\"time_ms\":" << lease->context.solveTimeMs << ","
+           << countersJson(lease->context.counters)
+           << "\"board\":" << boardStateJson()
+           << "}";
+    
+    if (conflict) {
+        return createResponse(false, "Board changed during the solve - solution discarded", result.str());
+    }
     if (solved) {
-        // Train neural network if using neuro-symbolic solver and it solved successfully
-        if (solverType == "neuro_symbolic") {
-            auto* neuroSolver = dynamic_cast<NeuroSymbolicSolver*>(aiSolver.get());
-            if (neuroSolver) {
-                neuroSolver->trainOnSolution(originalBoard, solutionBoard);
-            }
-        }
-        
-        // Update the board with solution
-        board = solutionBoard;
-        saveState();
-        
-        std::ostringstream result;
-        result << "{"
-               << "\"solved\":true,"
-               << "\"solver\":\"" << aiSolver->getSolverName() << "\","
-               << "\"moves\":" << aiSolver->getMovesCount() << ","
-               << "\"time_ms\":" << aiSolver->getSolveTimeMs() << ","
-               << "\"board\":" << boardToJson()
-               << "}";
-        
         return createResponse(true, "Puzzle solved successfully", result.str());
-    } else {
-        // Even if not fully solved, update the board with partial progress
-        board = solutionBoard;
-        saveState();
-        
-        std::ostringstream result;
-        result << "{"
-               << "\"solved\":false,"
-               << "\"solver\":\"" << aiSolver->getSolverName() << "\","
-               << "\"moves\":" << aiSolver->getMovesCount() << ","
-               << "\"time_ms\":" << aiSolver->getSolveTimeMs() << ","
-               << "\"board\":" << boardToJson()
-               << "}";
-        
-        return createResponse(false, "Could not solve puzzle completely - partial progress made (" + 
-                            std::to_string(aiSolver->getMovesCount()) + " moves)", result.str());
     }
+    return createResponse(false, "Could not solve puzzle completely - partial progress made (" + 
+                        std::to_string(lease->context.movesCount) + " moves)", result.str());
 }
 
 std::string SudokuJsonApi::solveCustomPuzzle(const std::string& solverType, const std::string& puzzleJson) {
+    std::string parsedType;
+    Board puzzle;
+    std::string response;
+    if (!parseCustomSolve(solverType + "|" + puzzleJson, parsedType, puzzle, response)) {
+        return response;
+    }
+    return customSolveResponse(*solveCustomBoard(parsedType, puzzle));
+}
+
+bool SudokuJsonApi::parseCustomSolve(const std::string& params, std::string& solverType, Board& puzzle,
+                                     std::string& errorResponse) {
+    // Parse params: "solver_type|puzzle_json"
+    size_t delimiter = params.find('|');
+    if (delimiter == std::string::npos) {
+        errorResponse = createResponse(false, "Invalid parameters for solve_custom_puzzle");
+        return false;
+    }
+    solverType = params.substr(0, delimiter);
     try {
         // Parse the puzzle JSON to determine board size and content
-        Board customBoard = parseCustomPuzzle(puzzleJson);
-        
-        // Create or reuse solver - only create new if different type
-        if (!aiSolver || aiSolver->getSolverName().find(solverType) == std::string::npos) {
-            aiSolver = SolverFactory::createSolver(solverType);
-            if (!aiSolver) {
-                return createResponse(false, "Unknown solver type: " + solverType);
-            }
-        }
-        
-        // Ensure neuro-symbolic solver adapts to the new board size and is in inference mode
-        if (solverType == "neuro_symbolic") {
-            auto* neuroSolver = dynamic_cast<NeuroSymbolicSolver*>(aiSolver.get());
-            if (neuroSolver) {
-                neuroSolver->adaptToBoardSize(customBoard.getBoardSize());
-                neuroSolver->setTrainingMode(false);  // Ensure we're in inference mode
-            }
-        }
-        
-        // Check if puzzle can be solved
-        if (!aiSolver->canSolve(customBoard)) {
-            return createResponse(false, "Custom puzzle cannot be solved - invalid state");
-        }
-        
-        // Make copies for solving
-        Board originalBoard = customBoard;
-        Board solutionBoard = customBoard;
-        
-        // Solve the puzzle
-        bool solved = aiSolver->solve(solutionBoard);
-        
-        // Special handling for neuro-symbolic solver
-        if (solverType == "neuro_symbolic" && !solved) {
-            auto* neuroSolver = dynamic_cast<NeuroSymbolicSolver*>(aiSolver.get());
-            if (neuroSolver) {
-                // If neural network couldn't solve, get solution from backtrack solver to train on
-                auto backtrackSolver = SolverFactory::createSolver("backtrack");
-                Board trainingSolution = originalBoard;
-                
-                if (backtrackSolver && backtrackSolver->solve(trainingSolution)) {
-                    // Train the neural network on this solution
-                    neuroSolver->trainOnSolution(originalBoard, trainingSolution);
-                    
-                    // Now try to solve again with the trained network
-                    solutionBoard = originalBoard; // Reset to original state
-                    solved = neuroSolver->solve(solutionBoard);
-                }
-            }
-        }
-        
-        if (solved) {
-            // Train neural network if using neuro-symbolic solver and it solved successfully
-            if (solverType == "neuro_symbolic") {
-                auto* neuroSolver = dynamic_cast<NeuroSymbolicSolver*>(aiSolver.get());
-                if (neuroSolver) {
-                    neuroSolver->trainOnSolution(originalBoard, solutionBoard);
-                }
-            }
-            
-            std::ostringstream result;
-            result << "{"
-                   << "\"solved\":true,"
-                   << "\"solver\":\"" << aiSolver->getSolverName() << "\","
-                   << "\"moves\":" << aiSolver->getMovesCount() << ","
-                   << "\"time_ms\":" << aiSolver->getSolveTimeMs() << ","
-                   << "\"board_size\":" << solutionBoard.getBoardSize() << ","
-                   << "\"solution\":" << boardToJsonFromBoard(solutionBoard)
-                   << "}";
-            
-            return createResponse(true, "Custom puzzle solved successfully", result.str());
-        } else {
-            std::ostringstream result;
-            result << "{"
-                   << "\"solved\":false,"
-                   << "\"solver\":\"" << aiSolver->getSolverName() << "\","
-                   << "\"moves\":" << aiSolver->getMovesCount() << ","
-                   << "\"time_ms\":" << aiSolver->getSolveTimeMs() << ","
-                   << "\"board_size\":" << solutionBoard.getBoardSize() << ","
-                   << "\"partial_solution\":" << boardToJsonFromBoard(solutionBoard)
-                   << "}";
-            
-            return createResponse(false, "Could not solve custom puzzle completely - partial progress made (" + 
-                                std::to_string(aiSolver->getMovesCount()) + " moves)", result.str());
-        }
+        SUDOKU_TRACE_SPAN("parse");
+        puzzle = parseCustomPuzzle(params.substr(delimiter + 1));
+        return true;
     }
     catch (const std::exception& e) {
-        return createResponse(false, "Error parsing custom puzzle: " + std::string(e.what()));
+        SUDOKU_LOG_WARN("api", "custom puzzle rejected solver=" << solverType << " error=" << e.what());
+        errorResponse = createResponse(false, "Error parsing custom puzzle: " + std::string(e.what()));
+        return false;
     }
 }
 
-std::string SudokuJsonApi::getNextAIMove(const std::string& solverType) {
-    // Create solver if not exists
-    if (!aiSolver || aiSolver->getSolverName().find(solverType) == std::string::npos) {
-        aiSolver = SolverFactory::createSolver(solverType);
-        if (!aiSolver) {
-            return createResponse(false, "Unknown solver type: " + solverType);
-        }
+std::string SudokuJsonApi::customSolveResponse(const CustomSolveResult& outcome) {
+    if (outcome.busy) {
+        return busyResponse(CostClass::SOLVE, outcome.retryAfterMs);
+    }
+    if (!outcome.accepted) {
+        return createResponse(false, outcome.message);
     }
     
-    // Ensure neuro-symbolic solver is in inference mode
-    if (solverType == "neuro_symbolic") {
-        auto* neuroSolver = dynamic_cast<NeuroSymbolicSolver*>(aiSolver.get());
-        if (neuroSolver) {
-            neuroSolver->setTrainingMode(false);
+    const Board& solutionBoard = outcome.solution;
+    std::ostringstream result;
+    result << "{"
+           << "\"solved\":" << (outcome.solved ? "true" : "false") << ","
+           << "\"solver\":\"" << outcome.solverName << "\","
+           << "\"moves\":" << outcome.moves << ","
+           << "\"time_ms\":" << outcome.timeMs << ","
+           << countersJson(outcome.counters)
+           << "\"board_size\":" << solutionBoard.getBoardSize() << ","
+           << (outcome.solved ? "\"solution\":" : "\"partial_solution\":") << boardToJsonFromBoard(solutionBoard)
+           << "}";
+    
+    return createResponse(outcome.solved, outcome.message, result.str());
+}
+
+std::shared_ptr<const CustomSolveResult> SudokuJsonApi::solveCustomBoard(const std::string& solverType,
+                                                                         const Board& puzzle) {
+    bool joined = false;
+    try {
+        std::shared_ptr<const CustomSolveResult> outcome = customSolves.run(customSolveKey(solverType, puzzle), [&]() {
+            return runCustomSolve(solverType, puzzle);
+        }, &joined);
+        if (joined) {
+            SUDOKU_LOG_DEBUG("api", "custom solve coalesced solver=" << solverType
+                             << " shared_total=" << customSolves.getSharedCount());
         }
+        return outcome;
+    }
+    catch (const std::exception& e) {
+        SUDOKU_LOG_ERROR("api", "custom solve failed solver=" << solverType << " error=" << e.what());
+        return failedSolve("Error solving custom puzzle: " + std::string(e.what()));
+    }
+}
+
+std::shared_ptr<const CustomSolveResult> SudokuJsonApi::joinRunningSolve(const std::string& solverType,
+                                                                         const Board& puzzle) {
+    auto running = customSolves.tryJoin(customSolveKey(solverType, puzzle));
+    if (!running) {
+        return nullptr;
+    }
+    try {
+        SUDOKU_LOG_DEBUG("api", "custom solve coalesced solver=" << solverType
+                         << " shared_total=" << customSolves.getSharedCount());
+        return running->get();
+    }
+    catch (const std::exception& e) {
+        return failedSolve("Error solving custom puzzle: " + std::string(e.what()));
     }
+}
+
+std::string SudokuJsonApi::customSolveKey(const std::string& solverType, const Board& puzzle) {
+    // Solver, size, then the board packed as the binary protocol sends it
+    std::string key = solverType;
+    key.push_back('\0');
+    key.push_back(static_cast<char>(puzzle.getBoardSize()));
+    packBoard(puzzle, key);
+    return key;
+}
+
+std::shared_ptr<const CustomSolveResult> SudokuJsonApi::runCustomSolve(const std::string& solverType,
+                                                                       const Board& puzzle) {
+    auto outcome = std::make_shared<CustomSolveResult>();
+    
+    SolverPool::Lease lease = borrowSolver(solverType, CostClass::SOLVE);
+    if (lease.isBusy()) {
+        outcome->busy = true;
+        outcome->retryAfterMs = solverWaitMs[static_cast<int>(CostClass::SOLVE)];
+        outcome->message = "Server busy, retry later";
+        return outcome;
+    }
+    if (!lease) {
+        outcome->message = "Unknown solver type: " + solverType;
+        return outcome;
+    }
+    prepareSolver(*lease, puzzle.getBoardSize());
+    SudokuSolver& solver = lease.solver();
+    
+    // Check if puzzle can be solved
+    if (!solver.canSolve(puzzle)) {
+        outcome->message = "Custom puzzle cannot be solved - invalid state";
+        return outcome;
+    }
+    
+    // Solve a copy in the slot's scratch boards; the original is kept for training
+    lease->original = puzzle;
+    lease->solution = puzzle;
+    
+    // Solve the puzzle
+    bool solved;
+    {
+        SUDOKU_TRACE_SPAN("solve");
+        solved = solver.solve(lease->solution, lease->context);
+    }
+    
+    if (lease->type == SolverType::NEURO_SYMBOLIC) {
+        solved = trainNeuroSolver(*lease, solved);
+    }
+    
+    outcome->accepted = true;
+    outcome->solved = solved;
+    outcome->message = solved
+        ? "Custom puzzle solved successfully"
+        : "Could not solve custom puzzle completely - partial progress made (" +
+          std::to_string(lease->context.movesCount) + " moves)";
+    outcome->solverName = solver.getSolverName();
+    outcome->moves = lease->context.movesCount;
+    outcome->timeMs = lease->context.solveTimeMs;
+    outcome->counters = lease->context.counters;
+    outcome->solution = lease->solution;
+    return outcome;
+}
+
+std::string SudokuJsonApi::getNextAIMove(const std::string& solverType) {
+    SolverPool::Lease lease = borrowSolver(solverType, CostClass::INTERACTIVE);
+    if (lease.isBusy()) {
+        return solverBusyResponse(CostClass::INTERACTIVE);
+    }
+    if (!lease) {
+        return createResponse(false, "Unknown solver type: " + solverType);
+    }
+    {
+        std::lock_guard<std::mutex> lock(stateMutex);
+        lease->solution = board;
+    }
+    prepareSolver(*lease, lease->solution.getBoardSize());
     
     SolverMove move(0, 0, 0);
-    bool hasMove = aiSolver->getNextMove(board, move);
+    bool hasMove;
+    {
+        SUDOKU_TRACE_SPAN("solve");
+        hasMove = lease.solver().getNextMove(lease->solution, move);
+    }
     
     if (hasMove) {
         std::ostringstream result;
@@ -443,23 +598,24 @@ std::string SudokuJsonApi::getNextAIMove(const std::string& solverType) {
 }
 
 std::string SudokuJsonApi::getAIPossibleMoves(const std::string& solverType) {
-    // Create solver if not exists
-    if (!aiSolver || aiSolver->getSolverName().find(solverType) == std::string::npos) {
-        aiSolver = SolverFactory::createSolver(solverType);
-        if (!aiSolver) {
-            return createResponse(false, "Unknown solver type: " + solverType);
-        }
+    SolverPool::Lease lease = borrowSolver(solverType, CostClass::SOLVE);
+    if (lease.isBusy()) {
+        return solverBusyResponse(CostClass::SOLVE);
     }
-    
-    // Ensure neuro-symbolic solver is in inference mode
-    if (solverType == "neuro_symbolic") {
-        auto* neuroSolver = dynamic_cast<NeuroSymbolicSolver*>(aiSolver.get());
-        if (neuroSolver) {
-            neuroSolver->setTrainingMode(false);
-        }
+    if (!lease) {
+        return createResponse(false, "Unknown solver type: " + solverType);
     }
+    {
+        std::lock_guard<std::mutex> lock(stateMutex);
+        lease->solution = board;
+    }
+    prepareSolver(*lease, lease->solution.getBoardSize());
     
-    std::vector<SolverMove> moves = aiSolver->getAllPossibleMoves(board);
+    std::vector<SolverMove> moves;
+    {
+        SUDOKU_TRACE_SPAN("solve");
+        moves = lease.solver().getAllPossibleMoves(lease->solution);
+    }
     
     std::ostringstream result;
     result << "{\"moves\":[";
@@ -480,46 +636,86 @@ std::string SudokuJsonApi::getAIPossibleMoves(const std::string& solverType) {
     return createResponse(true, "AI possible moves retrieved", result.str());
 }
 
-std::string SudokuJsonApi::boardToJson() {
-    int size = board.getBoardSize();
-    std::ostringstream oss;
-    oss << "{\"cells\":[";
+void SudokuJsonApi::prepareSolver(SolverSlot& slot, int boardSize) {
+    slot.context.collectCounters = collectCounters;
     
-    for (int row = 0; row < size; row++) {
-        oss << "[";
-        for (int col = 0; col < size; col++) {
-            int value = board.getCell(row, col).getValue();
-            bool locked = board.getCell(row, col).isLocked();
-            oss << "{\"value\":" << value << ",\"locked\":" << (locked ? "true" : "false") << "}";
-            if (col < size - 1) oss << ",";
+    // Ensure neuro-symbolic solver fits the board size and is in inference mode
+    if (slot.type == SolverType::NEURO_SYMBOLIC) {
+        auto* neuroSolver = dynamic_cast<NeuroSymbolicSolver*>(slot.solver.get());
+        if (neuroSolver) {
+            neuroSolver->adaptToBoardSize(boardSize);
+            neuroSolver->setTrainingMode(false);
         }
-        oss << "]";
-        if (row < size - 1) oss << ",";
     }
-    
-    oss << "]}";
-    return oss.str();
 }
 
-std::string SudokuJsonApi::boardToJsonFromBoard(const Board& customBoard) {
-    int size = customBoard.getBoardSize();
-    std::ostringstream oss;
-    oss << "{\"cells\":[";
-    
-    for (int row = 0; row < size; row++) {
-        oss << "[";
-        for (int col = 0; col < size; col++) {
-            int value = customBoard.getCell(row, col).getValue();
-            bool locked = customBoard.getCell(row, col).isLocked();
-            oss << "{\"value\":" << value << ",\"locked\":" << (locked ? "true" : "false") << "}";
-            if (col < size - 1) oss << ",";
+bool SudokuJsonApi::trainNeuroSolver(SolverSlot& slot, bool solved) {
+    auto* neuroSolver = dynamic_cast<NeuroSymbolicSolver*>(slot.solver.get());
+    if (!neuroSolver) {
+        return solved;
+    }
+    
+    if (!solved) {
+        SUDOKU_TRACE_SPAN("neuro_fallback_train");
+        // If neural network couldn't solve, get solution from backtrack solver to train on
+        SolverPool::Lease backtrack = solverPool.borrow(SolverType::BACKTRACK);
+        if (backtrack) {
+            backtrack->solution = slot.original;
+            if (backtrack.solver().solve(backtrack->solution, backtrack->context)) {
+                // Train the neural network on this solution
+                neuroSolver->trainOnSolution(slot.original, backtrack->solution);
+                
+                // Now try to solve again with the trained network
+                slot.solution = slot.original; // Reset to original state
+                solved = neuroSolver->solve(slot.solution, slot.context);
+            }
         }
-        oss << "]";
-        if (row < size - 1) oss << ",";
     }
     
-    oss << "]}";
-    return oss.str();
+    // Train neural network if it solved successfully
+    if (solved) {
+        neuroSolver->trainOnSolution(slot.original, slot.solution);
+    }
+    return solved;
+}
+
+std::string SudokuJsonApi::countersJson(const PerfSample& counters) const {
+    if (!collectCounters) {
+        return "";
+    }
+    return "\"counters\":" + counters.toJson() + ",";
+}
+
+std::string SudokuJsonApi::boardStateJson(uint64_t since) {
+    std::vector<BoardHistory::Change> changes;
+    if (since != 0 && history.changesSince(since, changes)) {
+        SUDOKU_TRACE_SPAN("serialize_board_delta");
+        std::ostringstream oss;
+        oss << "{\"revision\":" << history.getRevision() << ",\"since\":" << since << ",\"changes\":[";
+        for (size_t i = 0; i < changes.size(); ++i) {
+            const BoardHistory::Change& change = changes[i];
+            if (i > 0) oss << ",";
+            oss << "[" << change.row << "," << change.col << "," << change.value << ","
+                << (change.locked ? 1 : 0) << "]";
+        }
+        oss << "]}";
+        return oss.str();
+    }
+    // Full board; the revision goes last so the state file format is untouched
+    std::string json = boardToJson();
+    json.insert(json.size() - 1, ",\"revision\":" + std::to_string(history.getRevision()));
+    return json;
+}
+
+std::string SudokuJsonApi::boardToJson() {
+    return boardToJsonFromBoard(board);
+}
+
+std::string SudokuJsonApi::boardToJsonFromBoard(const Board& customBoard) {
+    SUDOKU_TRACE_SPAN("serialize_board");
+    std::string json;
+    appendBoardJson(json, customBoard, BoardJsonLayout::CELLS);
+    return json;
 }
 
 Board SudokuJsonApi::parseCustomPuzzle(const std::string& puzzleJson) {
@@ -658,6 +854,7 @@ void SudokuJsonApi::parseCustomBoardFromArray(Board& board, const std::string& j
 }
 
 std::string SudokuJsonApi::createResponse(bool success, const std::string& message, const std::string& data) {
+    SUDOKU_TRACE_SPAN("serialize_response");
     std::ostringstream oss;
     oss << "{"
         << "\"success\":" << (success ? "true" : "false") << ","
@@ -716,21 +913,42 @@ void SudokuJsonApi::initializeSamplePuzzle() {
     }
 }
 
+void SudokuJsonApi::commitBoardChange() {
+    uint64_t previous = history.getRevision();
+    uint64_t revision = history.record(board);
+    std::vector<BoardHistory::Change> changes;
+    if (revision == previous || history.changesSince(previous, changes)) {
+        // No cells changed still journals the move count
+        journal.appendChanges(moveCount, board.getBoardSize(), changes);
+    } else {
+        journal.appendBoard(moveCount, board);
+    }
+    if (journal.needsCompaction()) {
+        saveState();
+    }
+    ApiEventListener* listener = eventListener.load();
+    if (listener) {
+        listener->boardChanged(board, revision);
+    }
+}
+
 void SudokuJsonApi::saveState() {
-    std::ofstream file("game_state.json");
-    if (!file.is_open()) return;
-    
+    SUDOKU_TRACE_SPAN("state_save");
+    // Written by the journal's commit thread, which also empties the journal
+    std::ostringstream file;
     file << "{\n";
     file << "  \"moveCount\": " << moveCount << ",\n";
     file << "  \"board\": " << boardToJson() << "\n";
     file << "}\n";
-    file.close();
+    journal.compact(file.str());
 }
 
 void SudokuJsonApi::loadState() {
+    SUDOKU_TRACE_SPAN("state_load");
     std::ifstream file("game_state.json");
     if (!file.is_open()) {
         // No saved state, initialize with sample puzzle
+        SUDOKU_LOG_DEBUG("api", "no saved state, using sample puzzle");
         initializeSamplePuzzle();
         return;
     }
@@ -856,62 +1074,73 @@ void SudokuJsonApi::parseBoardFromJson(const std::string& jsonData) {
 // Neural Network Training Methods
 // ============================================================================
 
-std::string SudokuJsonApi::trainOnPuzzleBatch(int numPuzzles) {
-    // Create neuro-symbolic solver for training
-    auto trainer = SolverFactory::createSolver("neuro_symbolic");
-    auto* neuroSolver = dynamic_cast<NeuroSymbolicSolver*>(trainer.get());
+std::string SudokuJsonApi::trainOnPuzzleBatch(int numPuzzles, double targetAccuracy, int validationInterval) {
+    if (numPuzzles <= 0) {
+        return createResponse(false, "Number of training puzzles must be positive");
+    }
+    
+    // Train the pooled network that solves use, so its next save keeps this
+    // training instead of overwriting it. Neuro-symbolic requests meanwhile
+    // wait up to their class's solver wait and are then answered busy.
+    SolverPool::Lease trainer = borrowSolver("neuro_symbolic", CostClass::JOB);
+    if (trainer.isBusy()) {
+        return solverBusyResponse(CostClass::JOB);
+    }
+    auto* neuroSolver = trainer ? dynamic_cast<NeuroSymbolicSolver*>(trainer->solver.get()) : nullptr;
     
     if (!neuroSolver) {
         return createResponse(false, "Failed to create neuro-symbolic solver for training");
     }
     
-    int successful = 0;
-    int failed = 0;
-    auto startTime = std::chrono::high_resolution_clock::now();
-    
-    for (int i = 0; i < numPuzzles; ++i) {
-        // Generate a COMPLETE solution first (this is our ground truth!)
-        Board completeBoard(3); // 9x9 board
-        
-        if (generator.generateCompleteGrid(completeBoard)) {
-            // Store the VERIFIED correct solution
-            Board groundTruthSolution = completeBoard;
-            
-            // Now create a puzzle by removing cells FROM THE SAME BOARD
-            // We need to create the puzzle WITHOUT regenerating the grid
-            Board puzzleToSolve = completeBoard; // Copy the same complete solution
-            
-            // Remove cells to create puzzle (without regenerating grid)
-            SudokuGenerator::Difficulty difficulty = 
-                static_cast<SudokuGenerator::Difficulty>(i % 4);
-            
-            if (generator.createPuzzleFromCompleteGrid(puzzleToSolve, difficulty)) {
-                // NOW we have proper supervised learning:
-                // - puzzleToSolve: Puzzle with holes from groundTruthSolution
-                // - groundTruthSolution: SAME complete solution (correct pairing!)
-                
-                // Train neural network on KNOWN correct solution
-                neuroSolver->trainOnSolution(puzzleToSolve, groundTruthSolution);
-                successful++;
-            } else {
-                failed++;
-            }
-        } else {
-            failed++;
-        }
-    }
+    // Easy-to-hard curriculum with periodic validation on a held-out set
+    TrainingScheduler::Config config;
+    config.totalPuzzles = numPuzzles;
+    config.targetAccuracy = targetAccuracy;
+    config.validationInterval = validationInterval;
     
-    auto endTime = std::chrono::high_resolution_clock::now();
-    auto duration = std::chrono::duration_cast<std::chrono::milliseconds>(endTime - startTime);
+    // Own generator: training runs outside the state lock, beside board commands
+    SudokuGenerator trainingGenerator;
+    TrainingScheduler scheduler(*neuroSolver, trainingGenerator, config);
+    TrainingScheduler::Report report = scheduler.run();
     
     std::ostringstream result;
     result << "{"
-           << "\"puzzles_trained\":" << successful << ","
-           << "\"failed_puzzles\":" << failed << ","
+           << "\"puzzles_trained\":" << report.puzzlesTrained << ","
+           << "\"failed_puzzles\":" << report.failedPuzzles << ","
            << "\"total_requested\":" << numPuzzles << ","
-           << "\"training_time_ms\":" << duration.count() << ","
-           << "\"success_rate\":" << (successful / (double)numPuzzles * 100.0)
-           << "}";
+           << "\"training_time_ms\":" << static_cast<long long>(report.trainingTimeMs) << ","
+           << "\"validation_time_ms\":" << static_cast<long long>(report.validationTimeMs) << ","
+           << "\"success_rate\":" << (report.puzzlesTrained / (double)numPuzzles * 100.0) << ","
+           << "\"curriculum\":{";
+    
+    for (int i = 0; i < 4; ++i) {
+        if (i > 0) result << ",";
+        SudokuGenerator::Difficulty difficulty = TrainingScheduler::stageDifficulty(i, 4);
+        result << "\"" << TrainingScheduler::difficultyName(difficulty) << "\":"
+               << report.puzzlesPerDifficulty[i];
+    }
+    
+    result << "},"
+           << "\"target_accuracy\":" << std::fixed << std::setprecision(4) << targetAccuracy << ","
+           << "\"target_reached\":" << (report.targetReached ? "true" : "false") << ","
+           << "\"puzzles_to_target\":" << report.puzzlesToTarget << ","
+           << "\"time_to_target_ms\":" << std::setprecision(2) << report.timeToTargetMs << ","
+           << "\"initial_accuracy\":" << std::setprecision(4) << report.initialAccuracy << ","
+           << "\"final_accuracy\":" << report.finalAccuracy << ","
+           << "\"checkpoints\":[";
+    
+    for (size_t i = 0; i < report.checkpoints.size(); ++i) {
+        const auto& checkpoint = report.checkpoints[i];
+        if (i > 0) result << ",";
+        result << "{"
+               << "\"puzzles\":" << checkpoint.puzzlesTrained << ","
+               << "\"time_ms\":" << std::setprecision(2) << checkpoint.trainingTimeMs << ","
+               << "\"accuracy\":" << std::setprecision(4) << checkpoint.accuracy << ","
+               << "\"difficulty\":\"" << TrainingScheduler::difficultyName(checkpoint.difficulty) << "\""
+               << "}";
+    }
+    
+    result << "]}";
     
     return createResponse(true, "Batch training completed", result.str());
 }
@@ -949,7 +1178,7 @@ std::string SudokuJsonApi::enableRealTimeLearning(bool enable) {
 std::string SudokuJsonApi::performCrossValidation(int numPuzzles, int kFolds, bool verbose) {
     auto startTime = std::chrono::high_resolution_clock::now();
     
-    // Create neuro-symbolic solver
+    // Scratch network (its folds never save), like performance_metrics
     auto neuroSolver = std::make_unique<NeuroSymbolicSolver>();
     if (!neuroSolver) {
         return createResponse(false, "Failed to create neuro-symbolic solver");
@@ -972,8 +1201,7 @@ std::string SudokuJsonApi::performCrossValidation(int numPuzzles, int kFolds, bo
             Board puzzleToValidate = completeBoard;
             
             // Create puzzle by removing cells
-            SudokuGenerator::Difficulty difficulty = 
-                static_cast<SudokuGenerator::Difficulty>(i % 4);
+            SudokuGenerator::Difficulty difficulty = SudokuGenerator::difficultyForIndex(i);
             
             if (puzzleGenerator.createPuzzleFromCompleteGrid(puzzleToValidate, difficulty)) {
                 puzzleSolutionPairs.emplace_back(puzzleToValidate, groundTruthSolution);
@@ -1029,57 +1257,47 @@ std::string SudokuJsonApi::performCrossValidation(int numPuzzles, int kFolds, bo
     return createResponse(true, message, result.str());
 }
 
-std::string SudokuJsonApi::getPerformanceMetrics(int testPuzzles) {
+std::string SudokuJsonApi::getPerformanceMetrics(int testPuzzles, int threads) {
     auto startTime = std::chrono::high_resolution_clock::now();
     
-    // Create neuro-symbolic solver
+    // Scratch network: starts from the saved model but never writes it back,
+    // so the pooled network that solves use keeps the model file to itself
     auto neuroSolver = std::make_unique<NeuroSymbolicSolver>();
     if (!neuroSolver) {
         return createResponse(false, "Failed to create neuro-symbolic solver");
     }
     
-    // Generate test dataset
-    std::vector<std::pair<Board, Board>> testSet;
-    testSet.reserve(testPuzzles);
-    
-    SudokuGenerator puzzleGenerator;
-    int successful = 0;
-    
-    for (int i = 0; i < testPuzzles; ++i) {
-        Board completeBoard(3);
-        
-        if (puzzleGenerator.generateCompleteGrid(completeBoard)) {
-            Board groundTruthSolution = completeBoard;
-            Board testPuzzle = completeBoard;
-            
-            SudokuGenerator::Difficulty difficulty = 
-                static_cast<SudokuGenerator::Difficulty>(i % 4);
-            
-            if (puzzleGenerator.createPuzzleFromCompleteGrid(testPuzzle, difficulty)) {
-                testSet.emplace_back(testPuzzle, groundTruthSolution);
-                successful++;
-            }
-        }
+    if (testPuzzles < 2) {
+        return createResponse(false, "Need at least 2 puzzles (half train, half test)");
     }
     
-    if (testSet.empty()) {
-        return createResponse(false, "Failed to generate test dataset");
+    // TRAINING PHASE: Train the solver on half the data (generated in parallel)
+    int trainSize = testPuzzles / 2;
+    GeneratedPuzzleSource trainSource(trainSize);
+    std::vector<std::pair<Board, Board>> trainSet = collectPuzzles(trainSource, trainSize, threads);
+    
+    if (trainSet.empty()) {
+        return createResponse(false, "Failed to generate training dataset");
     }
     
-    // TRAINING PHASE: Train the solver on half the data
     neuroSolver->setTrainingMode(true);
-    int trainSize = testSet.size() / 2;
-    for (int i = 0; i < trainSize; ++i) {
-        neuroSolver->trainOnSolution(testSet[i].first, testSet[i].second);
+    for (const auto& pair : trainSet) {
+        neuroSolver->trainOnSolution(pair.first, pair.second, false);
     }
     
-    // TESTING PHASE: Calculate performance metrics on the remaining data (pure neural)
+    // TESTING PHASE: Stream the remaining puzzles through parallel workers (pure neural)
     neuroSolver->setTrainingMode(false);
-    std::vector<std::pair<Board, Board>> testData(testSet.begin() + trainSize, testSet.end());
-    auto metrics = neuroSolver->calculatePerformanceMetrics(testData);
-    
+    auto evalStart = std::chrono::high_resolution_clock::now();
+    GeneratedPuzzleSource testSource(testPuzzles - trainSize);
+    auto metrics = neuroSolver->calculatePerformanceMetrics(testSource, threads);
     auto endTime = std::chrono::high_resolution_clock::now();
+    
+    if (metrics.puzzlesEvaluated == 0) {
+        return createResponse(false, "Failed to generate test dataset");
+    }
+    
     auto duration = std::chrono::duration_cast<std::chrono::milliseconds>(endTime - startTime);
+    double evalSeconds = std::chrono::duration<double>(endTime - evalStart).count();
     
     // Create JSON response
     std::ostringstream result;
@@ -1093,14 +1311,18 @@ std::string SudokuJsonApi::getPerformanceMetrics(int testPuzzles) {
            << "\"false_positives\":" << metrics.falsePositives << ","
            << "\"true_negatives\":" << metrics.trueNegatives << ","
            << "\"false_negatives\":" << metrics.falseNegatives << ","
-           << "\"test_puzzles\":" << testData.size() << ","
-           << "\"training_puzzles\":" << trainSize << ","
+           << "\"test_puzzles\":" << metrics.puzzlesEvaluated << ","
+           << "\"training_puzzles\":" << trainSet.size() << ","
+           << "\"tasks\":" << metrics.tasksUsed << ","
+           << "\"threads\":" << metrics.threadsUsed << ","
+           << "\"test_puzzles_per_sec\":" << std::setprecision(2)
+           << (evalSeconds > 0 ? metrics.puzzlesEvaluated / evalSeconds : 0.0) << ","
            << "\"evaluation_time_ms\":" << duration.count()
            << "}"
            << "}";
     
-    std::string message = "Performance metrics calculated on " + std::to_string(testData.size()) + 
-                         " test puzzles after training on " + std::to_string(trainSize) + " puzzles";
+    std::string message = "Performance metrics calculated on " + std::to_string(metrics.puzzlesEvaluated) + 
+                         " test puzzles after training on " + std::to_string(trainSet.size()) + " puzzles";
     
     return createResponse(true, message, result.str());
 }
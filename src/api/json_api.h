@@ -11,19 +11,72 @@ Provides a command-line interface that outputs JSON for easy integration with we
 #include "../solver/solver_interface.h"
 #include "../solver/solver_factory.h"
 #include "../solver/neuro_symbolic_solver.h"
+#include "admission_controller.h"
+#include "board_history.h"
+#include "move_journal.h"
+#include "solver_pool.h"
+#include "../util/single_flight.h"
+#include <atomic>
+#include <mutex>
 #include <string>
 #include <sstream>
 
+// Outcome of one custom-puzzle solve; coalesced requests share one instance
+struct CustomSolveResult {
+    bool accepted = false;      // false: `message` says why nothing was solved
+    bool busy = false;          // Not accepted because no solver freed up in time
+    double retryAfterMs = 0.0;
+    bool solved = false;
+    std::string message;
+    std::string solverName;
+    int moves = 0;
+    double timeMs = 0.0;
+    PerfSample counters;
+    Board solution;
+};
+
+// Told about game-board changes and game-board solve progress as they happen
+// (sudoku_api serve pushes them to WebSocket clients). Called on the thread
+// doing the work, boardChanged with the state lock held: implementations
+// copy what they need and return without calling back into the API.
+class ApiEventListener {
+public:
+    virtual ~ApiEventListener() = default;
+    virtual void boardChanged(const Board& board, uint64_t revision) = 0;
+    virtual void solveProgress(const std::string& solverName, const Board& board, int step) = 0;
+};
+
 class SudokuJsonApi {
 public:
     SudokuJsonApi();
     
-    // Main API entry point
+    // Main API entry point; safe to call from several threads. Board commands
+    // serialise on the game state, solves and jobs work on their own copies.
     std::string processCommand(const std::string& command, const std::string& params);
     
-    // Command handlers
-    std::string getBoard();
-    std::string makeMove(int row, int col, int value);
+    // Long-lived instances (sudoku_api serve) build solvers before the first request
+    void warmSolvers(int perType);
+    
+    // Longest a command of the class waits for a pooled solver (the single
+    // neuro-symbolic network) before it is answered busy; negative, the
+    // default, waits as long as it takes. Set before serving requests.
+    void setSolverWait(CostClass costClass, double maxWaitMs);
+    
+    // {"success":false,...,"data":{"class":...,"retry_after_ms":N}}
+    static std::string busyResponse(CostClass costClass, double retryAfterMs);
+    
+    // Copy of the game board, for transports that do not speak JSON
+    Board snapshotBoard(uint64_t* revision = nullptr);
+    
+    // At most one listener; nullptr detaches it
+    void setEventListener(ApiEventListener* listener) { eventListener.store(listener); }
+    
+    // Command handlers. Board responses carry the board's "revision"; given
+    // the revision a client already holds (since > 0), getBoard and makeMove
+    // return only the cells changed after it, or the full board when the
+    // history no longer reaches back that far.
+    std::string getBoard(uint64_t since = 0);
+    std::string makeMove(int row, int col, int value, uint64_t since = 0);
     std::string loadPuzzle();
     std::string generatePuzzle(const std::string& difficulty = "medium");
     std::string clearBoard();
@@ -33,25 +86,66 @@ public:
     // AI Solver commands
     std::string solvePuzzle(const std::string& solverType = "backtrack");
     std::string solveCustomPuzzle(const std::string& solverType, const std::string& puzzleJson);
+    
+    // solve_custom_puzzle params ("solver_type|puzzle_json"), parsed once; on
+    // failure errorResponse holds the response to send
+    bool parseCustomSolve(const std::string& params, std::string& solverType, Board& puzzle,
+                          std::string& errorResponse);
+    
+    // Solves a parsed puzzle; identical concurrent requests (same cells, locks
+    // and solver) run one solve and share its result
+    std::shared_ptr<const CustomSolveResult> solveCustomBoard(const std::string& solverType, const Board& puzzle);
+    
+    // Waits for and returns the result of an identical solve already in
+    // flight, or nullptr when there is none. Joining costs no solver time,
+    // so the server admits a request only when this returns nullptr.
+    std::shared_ptr<const CustomSolveResult> joinRunningSolve(const std::string& solverType, const Board& puzzle);
+    std::string customSolveResponse(const CustomSolveResult& outcome);
+    uint64_t getCoalescedSolveCount() const { return customSolves.getSharedCount(); }
     std::string getNextAIMove(const std::string& solverType = "backtrack");
     std::string getAIPossibleMoves(const std::string& solverType = "backtrack");
     
     // Neural Network Training commands
-    std::string trainOnPuzzleBatch(int numPuzzles = 100);
+    std::string trainOnPuzzleBatch(int numPuzzles = 100, double targetAccuracy = 0.5, int validationInterval = 0);
     std::string getTrainingStats();
     std::string enableRealTimeLearning(bool enable = true);
     
     // Cross-validation commands
     std::string performCrossValidation(int numPuzzles = 50, int kFolds = 5, bool verbose = false);
-    std::string getPerformanceMetrics(int testPuzzles = 20);
+    std::string getPerformanceMetrics(int testPuzzles = 20, int threads = 0);
     
 private:
+    std::mutex stateMutex;  // Guards board, history, moveCount, generator and the state file
     Board board;
+    BoardHistory history;
+    MoveJournal journal{"game_state.journal", "game_state.json"};  // Moves since the state file was written
     SudokuGenerator generator;
-    std::unique_ptr<SudokuSolver> aiSolver;
+    SolverPool solverPool;  // Warmed solvers and scratch boards, borrowed per request
+    SingleFlight<std::string, std::shared_ptr<const CustomSolveResult>> customSolves;
+    std::atomic<ApiEventListener*> eventListener{nullptr};
+    double solverWaitMs[kCostClassCount] = {-1.0, -1.0, -1.0};
     int moveCount;
+    bool collectCounters;   // SUDOKU_PERF_COUNTERS=1 adds hardware counters to solve responses
+    
+    static std::string customSolveKey(const std::string& solverType, const Board& puzzle);
+    std::shared_ptr<const CustomSolveResult> runCustomSolve(const std::string& solverType, const Board& puzzle);
+    
+    // Borrows a solver within the class's wait limit (lease.isBusy() when it ran out)
+    SolverPool::Lease borrowSolver(const std::string& solverType, CostClass costClass);
+    std::string solverBusyResponse(CostClass costClass) const;
+    
+    // Per-request setup of a borrowed solver: counters, neuro-symbolic inference mode
+    void prepareSolver(SolverSlot& slot, int boardSize);
+    
+    // Neuro-symbolic only: when the network fails, learn from a backtracking
+    // solution and retry; either way train on the final solution
+    bool trainNeuroSolver(SolverSlot& slot, bool solved);
+    
+    // "counters":{...}, fragment for solve responses (empty unless enabled)
+    std::string countersJson(const PerfSample& counters) const;
     
     // JSON formatting helpers
+    std::string boardStateJson(uint64_t since = 0);  // Board with revision, or the changes since
     std::string boardToJson();
     std::string boardToJsonFromBoard(const Board& customBoard);
     Board parseCustomPuzzle(const std::string& puzzleJson);
@@ -61,7 +155,10 @@ private:
     std::string escapeJson(const std::string& str);
     void initializeSamplePuzzle();
     
-    // State persistence
+    // Journals the game-board change and tells the listener; call with stateMutex held
+    void commitBoardChange();
+    
+    // State persistence: the state file is a snapshot, the journal holds later moves
     void saveState();
     void loadState();
     void parseBoardFromJson(const std::string& jsonData);
@@ -0,0 +1,327 @@
+/*
+MoveJournal implementation
+*/
+
+#include "move_journal.h"
+#include "binary_protocol.h"
+#include "../util/logger.h"
+#include "../util/trace.h"
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cstring>
+#include <fcntl.h>
+#include <fstream>
+#include <sstream>
+#include <unistd.h>
+
+namespace {
+
+enum RecordKind : uint8_t {
+    kRecordChanges = 1,
+    kRecordBoard = 2
+};
+
+constexpr size_t kRecordHeader = 8;   // u32 length, u32 checksum
+
+uint32_t fnv1a(const char* data, size_t length) {
+    uint32_t hash = 2166136261u;
+    for (size_t i = 0; i < length; ++i) {
+        hash ^= static_cast<unsigned char>(data[i]);
+        hash *= 16777619u;
+    }
+    return hash;
+}
+
+void putU16(std::string& out, uint16_t value) {
+    out.push_back(static_cast<char>(value & 0xFF));
+    out.push_back(static_cast<char>(value >> 8));
+}
+
+void putU32(std::string& out, uint32_t value) {
+    for (int shift = 0; shift < 32; shift += 8) {
+        out.push_back(static_cast<char>((value >> shift) & 0xFF));
+    }
+}
+
+uint32_t getU32(const char* data) {
+    const unsigned char* bytes = reinterpret_cast<const unsigned char*>(data);
+    return static_cast<uint32_t>(bytes[0]) | static_cast<uint32_t>(bytes[1]) << 8 |
+           static_cast<uint32_t>(bytes[2]) << 16 | static_cast<uint32_t>(bytes[3]) << 24;
+}
+
+uint16_t getU16(const char* data) {
+    const unsigned char* bytes = reinterpret_cast<const unsigned char*>(data);
+    return static_cast<uint16_t>(bytes[0] | bytes[1] << 8);
+}
+
+bool writeAll(int fd, const std::string& data) {
+    size_t written = 0;
+    while (written < data.size()) {
+        ssize_t n = ::write(fd, data.data() + written, data.size() - written);
+        if (n < 0 && errno == EINTR) continue;
+        if (n <= 0) return false;
+        written += static_cast<size_t>(n);
+    }
+    return true;
+}
+
+// Applies one record body; false when it does not make sense for the board
+bool applyRecord(const std::string& body, Board& board, int& moveCount) {
+    if (body.size() < 5) {
+        return false;
+    }
+    uint8_t kind = static_cast<uint8_t>(body[0]);
+    int moves = static_cast<int>(getU32(body.data() + 1));
+
+    if (kind == kRecordBoard) {
+        if (body.size() < 6) return false;
+        int size = static_cast<unsigned char>(body[5]);
+        if (body.size() != 6 + static_cast<size_t>(size) * size) return false;
+        std::string error;
+        if (!unpackBoard(size, body.substr(6), board, error)) return false;
+    } else if (kind == kRecordChanges) {
+        if (body.size() < 7) return false;
+        size_t count = getU16(body.data() + 5);
+        if (body.size() != 7 + count * 3) return false;
+        int size = board.getBoardSize();
+        for (size_t i = 0; i < count; ++i) {
+            const char* entry = body.data() + 7 + i * 3;
+            int index = getU16(entry);
+            unsigned char packed = static_cast<unsigned char>(entry[2]);
+            if (index >= size * size || (packed & 0x7F) > size) return false;
+            Cell& cell = board.getCell(index / size, index % size);
+            cell.setValue(packed & 0x7F);
+            cell.setLocked((packed & 0x80) != 0);
+        }
+    } else {
+        return false;
+    }
+    moveCount = moves;
+    return true;
+}
+
+std::string directoryOf(const std::string& path) {
+    size_t slash = path.find_last_of('/');
+    if (slash == std::string::npos) return ".";
+    return slash == 0 ? "/" : path.substr(0, slash);
+}
+
+}
+
+MoveJournal::MoveJournal(const std::string& journalPath, const std::string& snapshotPath,
+                         int commitIntervalMs, size_t compactBytes)
+    : journalPath(journalPath), snapshotPath(snapshotPath),
+      commitIntervalMs(commitIntervalMs), compactBytes(compactBytes) {}
+
+MoveJournal::~MoveJournal() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+        wake.notify_one();
+    }
+    if (thread.joinable()) {
+        thread.join();
+    }
+    if (fd >= 0) {
+        ::close(fd);
+    }
+}
+
+size_t MoveJournal::replay(Board& board, int& moveCount) {
+    SUDOKU_TRACE_SPAN("journal_replay");
+    std::ifstream file(journalPath, std::ios::binary);
+    if (!file.is_open()) {
+        return 0;
+    }
+    std::ostringstream contents;
+    contents << file.rdbuf();
+    std::string data = contents.str();
+    file.close();
+
+    size_t offset = 0;
+    size_t applied = 0;
+    while (data.size() - offset >= kRecordHeader) {
+        uint32_t length = getU32(data.data() + offset);
+        uint32_t checksum = getU32(data.data() + offset + 4);
+        if (data.size() - offset - kRecordHeader < length ||
+            fnv1a(data.data() + offset + kRecordHeader, length) != checksum) {
+            break;
+        }
+        Board candidate = board;
+        int candidateMoves = moveCount;
+        if (!applyRecord(data.substr(offset + kRecordHeader, length), candidate, candidateMoves)) {
+            break;
+        }
+        board = candidate;
+        moveCount = candidateMoves;
+        offset += kRecordHeader + length;
+        ++applied;
+    }
+
+    if (offset < data.size()) {
+        // Torn write from a crash (or corruption): later appends must not follow it
+        SUDOKU_LOG_WARN("journal", "discarding damaged tail path=" << journalPath
+                        << " valid_bytes=" << offset << " bytes=" << data.size());
+        if (::truncate(journalPath.c_str(), static_cast<off_t>(offset)) != 0) {
+            SUDOKU_LOG_ERROR("journal", "truncate failed path=" << journalPath << " error=" << std::strerror(errno));
+        }
+    }
+    std::lock_guard<std::mutex> lock(mutex);
+    appendedBytes = offset;
+    journalStart = 0;
+    SUDOKU_LOG_DEBUG("journal", "replayed records=" << applied << " bytes=" << offset);
+    return applied;
+}
+
+void MoveJournal::appendChanges(int moveCount, int boardSize, const std::vector<BoardHistory::Change>& changes) {
+    std::string body;
+    body.reserve(7 + changes.size() * 3);
+    body.push_back(static_cast<char>(kRecordChanges));
+    putU32(body, static_cast<uint32_t>(moveCount));
+    putU16(body, static_cast<uint16_t>(changes.size()));
+    for (const BoardHistory::Change& change : changes) {
+        putU16(body, static_cast<uint16_t>(change.row * boardSize + change.col));
+        body.push_back(static_cast<char>(change.value | (change.locked ? 0x80 : 0)));
+    }
+    append(body);
+}
+
+void MoveJournal::appendBoard(int moveCount, const Board& board) {
+    std::string body;
+    body.push_back(static_cast<char>(kRecordBoard));
+    putU32(body, static_cast<uint32_t>(moveCount));
+    body.push_back(static_cast<char>(board.getBoardSize()));
+    packBoard(board, body);
+    append(body);
+}
+
+void MoveJournal::append(const std::string& body) {
+    std::lock_guard<std::mutex> lock(mutex);
+    putU32(buffer, static_cast<uint32_t>(body.size()));
+    putU32(buffer, fnv1a(body.data(), body.size()));
+    buffer += body;
+    appendedBytes += kRecordHeader + body.size();
+    if (!thread.joinable()) {
+        thread = std::thread([this]() { run(); });
+    }
+    wake.notify_one();
+}
+
+bool MoveJournal::needsCompaction() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return appendedBytes - journalStart >= compactBytes && pendingSnapshot.empty() && !compacting;
+}
+
+void MoveJournal::compact(const std::string& snapshot) {
+    std::lock_guard<std::mutex> lock(mutex);
+    // Everything buffered is part of the snapshot, but is only dropped once
+    // the snapshot is on disk
+    pendingSnapshot = snapshot;
+    snapshotCovers = buffer.size();
+    snapshotAt = appendedBytes;
+    if (!thread.joinable()) {
+        thread = std::thread([this]() { run(); });
+    }
+    wake.notify_one();
+}
+
+void MoveJournal::flush() {
+    std::unique_lock<std::mutex> lock(mutex);
+    committed.wait(lock, [this]() {
+        return !thread.joinable() || (buffer.empty() && pendingSnapshot.empty() && !writing);
+    });
+}
+
+uint64_t MoveJournal::getCommitCount() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return commits;
+}
+
+void MoveJournal::run() {
+    std::unique_lock<std::mutex> lock(mutex);
+    while (true) {
+        wake.wait(lock, [this]() { return stopping || !buffer.empty() || !pendingSnapshot.empty(); });
+        if (buffer.empty() && pendingSnapshot.empty()) {
+            break;   // Stopping with nothing left to write
+        }
+        if (!stopping) {
+            // Group commit: records arriving in the next few milliseconds share this write and sync
+            wake.wait_for(lock, std::chrono::milliseconds(commitIntervalMs), [this]() { return stopping; });
+        }
+        std::string batch;
+        std::string snapshot;
+        batch.swap(buffer);
+        snapshot.swap(pendingSnapshot);
+        size_t covered = snapshotCovers;
+        uint64_t coveredAt = snapshotAt;
+        compacting = !snapshot.empty();
+        writing = true;
+        lock.unlock();
+
+        bool compacted = false;
+        {
+            SUDOKU_TRACE_SPAN("journal_commit");
+            bool open = openJournal();
+            if (!snapshot.empty() && open && writeSnapshot(snapshot)) {
+                if (::ftruncate(fd, 0) == 0 && ::fdatasync(fd) == 0) {
+                    compacted = true;
+                } else {
+                    SUDOKU_LOG_ERROR("journal", "truncate failed path=" << journalPath << " error=" << std::strerror(errno));
+                }
+            }
+            // Without a new snapshot the journal still starts at the old one,
+            // so the records the snapshot would have covered go in as well
+            size_t skip = compacted ? covered : 0;
+            if (batch.size() > skip && open) {
+                if (!writeAll(fd, batch.substr(skip)) || ::fdatasync(fd) != 0) {
+                    SUDOKU_LOG_ERROR("journal", "append failed path=" << journalPath << " error=" << std::strerror(errno));
+                }
+            }
+        }
+
+        lock.lock();
+        if (compacted) {
+            journalStart = std::max(journalStart, coveredAt);
+        }
+        compacting = false;
+        writing = false;
+        ++commits;
+        committed.notify_all();
+    }
+}
+
+bool MoveJournal::openJournal() {
+    if (fd >= 0) {
+        return true;
+    }
+    fd = ::open(journalPath.c_str(), O_WRONLY | O_CREAT | O_APPEND | O_CLOEXEC, 0644);
+    if (fd < 0) {
+        SUDOKU_LOG_ERROR("journal", "cannot open path=" << journalPath << " error=" << std::strerror(errno));
+        return false;
+    }
+    return true;
+}
+
+bool MoveJournal::writeSnapshot(const std::string& snapshot) {
+    std::string temporary = snapshotPath + ".tmp";
+    int snapshotFd = ::open(temporary.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+    if (snapshotFd < 0) {
+        SUDOKU_LOG_ERROR("journal", "cannot write snapshot path=" << temporary << " error=" << std::strerror(errno));
+        return false;
+    }
+    bool ok = writeAll(snapshotFd, snapshot) && ::fsync(snapshotFd) == 0;
+    ::close(snapshotFd);
+    if (!ok || ::rename(temporary.c_str(), snapshotPath.c_str()) != 0) {
+        SUDOKU_LOG_ERROR("journal", "snapshot failed path=" << snapshotPath << " error=" << std::strerror(errno));
+        ::unlink(temporary.c_str());
+        return false;
+    }
+    // Makes the rename itself durable
+    int directoryFd = ::open(directoryOf(snapshotPath).c_str(), O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+    if (directoryFd >= 0) {
+        ::fsync(directoryFd);
+        ::close(directoryFd);
+    }
+    return true;
+}
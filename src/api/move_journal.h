@@ -0,0 +1,103 @@
+/*
+MoveJournal - append-only log of game-board changes with group commit
+Rewriting the whole state file after every move turns many small moves into
+many full-file writes. Instead each committed change is appended to a
+journal as a compact record, and the file is only rewritten occasionally:
+
+  - append*() encodes one record into an in-memory buffer and returns; no
+    I/O happens on the caller's thread.
+  - A commit thread wakes when records arrive, waits commitIntervalMs for
+    more to gather, then writes the whole batch with one write() and one
+    fdatasync(). A crash loses at most the records of the last interval.
+  - Once the journal passes compactBytes, the owner writes a snapshot
+    through compact(): the snapshot replaces the state file atomically
+    (temp file, fsync, rename) and the journal starts over. Records stay
+    buffered until the rename has succeeded; if the snapshot cannot be
+    written they are appended to the journal as usual and the next
+    needsCompaction() asks for another attempt.
+  - replay() runs at start-up after the snapshot was loaded and applies the
+    journal on top of it. A torn or corrupt tail (from a crash mid-write) is
+    cut off at the last intact record.
+
+Records, each prefixed by u32 length and u32 FNV-1a checksum of the body:
+    u8 kind, u32 moveCount, then
+    CHANGES: u16 count, count * (u16 cell index, u8 value | 0x80 if locked)
+    BOARD:   u8 board size, size * size packed cells
+Every record sets cells to absolute values, so replaying a journal whose
+records are already in the snapshot (a crash between the snapshot rename and
+the journal truncation) ends in the same state.
+
+Thread-safe. The commit thread starts on the first append, so processes
+that only read never create it.
+*/
+
+#ifndef SUDOKU_API_MOVE_JOURNAL_H
+#define SUDOKU_API_MOVE_JOURNAL_H
+
+#include "board_history.h"
+#include "../model/board.h"
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+class MoveJournal {
+public:
+    MoveJournal(const std::string& journalPath, const std::string& snapshotPath,
+                int commitIntervalMs = 5, size_t compactBytes = 256 * 1024);
+    ~MoveJournal();   // Commits what is buffered
+
+    MoveJournal(const MoveJournal&) = delete;
+    MoveJournal& operator=(const MoveJournal&) = delete;
+
+    // Applies the journal to a board loaded from the snapshot; returns the
+    // number of records applied
+    size_t replay(Board& board, int& moveCount);
+
+    void appendChanges(int moveCount, int boardSize, const std::vector<BoardHistory::Change>& changes);
+    void appendBoard(int moveCount, const Board& board);
+
+    // True once enough has been journalled that a snapshot should be taken,
+    // and no snapshot is already on its way to disk
+    bool needsCompaction() const;
+
+    // Replaces the snapshot with `snapshot`, which must include every record
+    // appended so far, and empties the journal
+    void compact(const std::string& snapshot);
+
+    // Blocks until everything appended so far is on disk
+    void flush();
+
+    uint64_t getCommitCount() const;   // fdatasync batches so far
+
+private:
+    void append(const std::string& body);
+    void run();
+    bool writeSnapshot(const std::string& snapshot);
+    bool openJournal();
+
+    std::string journalPath;
+    std::string snapshotPath;
+    int commitIntervalMs;
+    size_t compactBytes;
+
+    mutable std::mutex mutex;
+    std::condition_variable wake;       // Commit thread waits for work
+    std::condition_variable committed;  // flush() waits for the commit thread
+    std::string buffer;                 // Encoded records not yet written
+    std::string pendingSnapshot;
+    size_t snapshotCovers = 0;          // Leading buffer bytes included in pendingSnapshot
+    uint64_t snapshotAt = 0;            // appendedBytes when pendingSnapshot was taken
+    bool compacting = false;            // Commit thread is writing a snapshot
+    bool writing = false;               // Commit thread is writing a batch
+    uint64_t appendedBytes = 0;         // Record bytes ever appended, counting the replayed journal
+    uint64_t journalStart = 0;          // appendedBytes at the start of the journal file
+    uint64_t commits = 0;
+    bool stopping = false;
+    int fd = -1;
+    std::thread thread;
+};
+
+#endif // SUDOKU_API_MOVE_JOURNAL_H
@@ -0,0 +1,117 @@
+/*
+sudoku_engine - CPython extension that runs the JSON API in-process
+bridge_server.py used to start sudoku_api for every HTTP request, paying
+process start-up, state-file loading and solver construction each time.
+This module keeps one engine alive for the life of the Python process and
+calls it directly:
+
+    import sudoku_engine
+    sudoku_engine.process("solve_puzzle", "backtrack")   # -> JSON string
+    sudoku_engine.process("get_board", "", "alice")      # client for CPU accounting
+    sudoku_engine.warm(2)                                # build solvers up front
+
+Requests go through ApiServer::handle, so they get the same admission
+classes, per-client accounting, coalescing and server_stats as sudoku_api
+serve; no socket is opened. The GIL is released while a command runs, so
+Flask threads solve in parallel and the interpreter stays responsive.
+
+Built with the plain C API and no other dependencies (make python-module).
+*/
+
+#define PY_SSIZE_T_CLEAN
+#include <Python.h>
+
+#include "admission_controller.h"
+#include "api_server.h"
+#include "json_api.h"
+#include <exception>
+#include <string>
+
+namespace {
+
+struct Engine {
+    SudokuJsonApi api;
+    AdmissionController admission;
+    ApiServer server{api, admission};
+};
+
+// Created on import and never freed: worker threads may still be inside it
+// while the interpreter shuts down
+Engine* engine = nullptr;
+
+PyObject* process(PyObject*, PyObject* args, PyObject* kwargs) {
+    static const char* keywords[] = {"command", "params", "client", nullptr};
+    const char* command = nullptr;
+    const char* params = "";
+    const char* client = "default";
+    if (!PyArg_ParseTupleAndKeywords(args, kwargs, "s|ss", const_cast<char**>(keywords),
+                                     &command, &params, &client)) {
+        return nullptr;
+    }
+
+    // Copied while the GIL still protects the argument strings
+    std::string commandText(command);
+    std::string paramsText(params);
+    std::string clientText = ApiServer::sanitizeClient(client);
+    std::string response;
+    std::string error;
+
+    Py_BEGIN_ALLOW_THREADS
+    try {
+        response = engine->server.handle(commandText, paramsText, clientText);
+    } catch (const std::exception& e) {
+        error = e.what();
+    }
+    Py_END_ALLOW_THREADS
+
+    if (!error.empty()) {
+        PyErr_SetString(PyExc_RuntimeError, error.c_str());
+        return nullptr;
+    }
+    return PyUnicode_FromStringAndSize(response.data(), static_cast<Py_ssize_t>(response.size()));
+}
+
+PyObject* warm(PyObject*, PyObject* args) {
+    int perType = 0;
+    if (!PyArg_ParseTuple(args, "i", &perType)) {
+        return nullptr;
+    }
+    Py_BEGIN_ALLOW_THREADS
+    engine->api.warmSolvers(perType);
+    Py_END_ALLOW_THREADS
+    Py_RETURN_NONE;
+}
+
+PyMethodDef kMethods[] = {
+    {"process", reinterpret_cast<PyCFunction>(reinterpret_cast<void (*)(void)>(process)),
+     METH_VARARGS | METH_KEYWORDS,
+     "process(command, params='', client='default') -> str\n"
+     "Runs one API command and returns its JSON response."},
+    {"warm", warm, METH_VARARGS,
+     "warm(per_type) -> None\n"
+     "Builds per_type solvers of each kind before the first request."},
+    {nullptr, nullptr, 0, nullptr}
+};
+
+PyModuleDef kModule = {
+    PyModuleDef_HEAD_INIT,
+    "sudoku_engine",
+    "In-process Sudoku engine (the sudoku_api JSON commands without a subprocess)",
+    -1,
+    kMethods,
+    nullptr, nullptr, nullptr, nullptr
+};
+
+}
+
+PyMODINIT_FUNC PyInit_sudoku_engine(void) {
+    if (engine == nullptr) {
+        try {
+            engine = new Engine();
+        } catch (const std::exception& e) {
+            PyErr_Format(PyExc_ImportError, "sudoku_engine: %s", e.what());
+            return nullptr;
+        }
+    }
+    return PyModule_Create(&kModule);
+}
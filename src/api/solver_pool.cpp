@@ -0,0 +1,156 @@
+/*
+SolverPool implementation
+*/
+
+#include "solver_pool.h"
+#include "../util/logger.h"
+#include "../util/trace.h"
+#include <chrono>
+#include <limits>
+
+// ========== Lease ==========
+
+SolverPool::Lease::Lease(SolverPool* pool, std::unique_ptr<SolverSlot> slot)
+    : pool(pool), slot(std::move(slot)) {}
+
+SolverPool::Lease::Lease(Lease&& other) noexcept
+    : pool(other.pool), slot(std::move(other.slot)), busy(other.busy) {
+    other.pool = nullptr;
+}
+
+SolverPool::Lease& SolverPool::Lease::operator=(Lease&& other) noexcept {
+    if (this != &other) {
+        release();
+        pool = other.pool;
+        slot = std::move(other.slot);
+        busy = other.busy;
+        other.pool = nullptr;
+    }
+    return *this;
+}
+
+SolverPool::Lease::~Lease() {
+    release();
+}
+
+void SolverPool::Lease::release() {
+    if (pool && slot) {
+        pool->giveBack(std::move(slot));
+    }
+    pool = nullptr;
+}
+
+// ========== SolverPool ==========
+
+SolverPool::SolverPool(size_t maxIdlePerType) : maxIdlePerType(maxIdlePerType) {}
+
+SolverPool::Lease SolverPool::borrow(const std::string& solverName, double maxWaitMs) {
+    SolverType type;
+    if (!SolverFactory::parseSolverType(solverName, type)) {
+        return Lease();
+    }
+    return borrow(type, maxWaitMs);
+}
+
+SolverPool::Lease SolverPool::borrow(SolverType type, double maxWaitMs) {
+    {
+        std::unique_lock<std::mutex> lock(mutex);
+        std::vector<std::unique_ptr<SolverSlot>>& slots = idle[type];
+        size_t& count = live[type];
+        auto available = [&] { return !slots.empty() || count < maxInstances(type); };
+        if (maxWaitMs < 0.0) {
+            returned.wait(lock, available);
+        } else if (!returned.wait_for(lock, std::chrono::duration<double, std::milli>(maxWaitMs), available)) {
+            Lease lease;
+            lease.busy = true;
+            return lease;
+        }
+        if (!slots.empty()) {
+            std::unique_ptr<SolverSlot> slot = std::move(slots.back());
+            slots.pop_back();
+            return Lease(this, std::move(slot));
+        }
+        count++;   // Reserved before building, so racing borrowers cannot exceed the limit
+    }
+
+    // Built outside the lock: a neuro-symbolic model load must not stall
+    // requests for other solver types
+    std::unique_ptr<SolverSlot> slot = createSlot(type);
+    if (!slot) {
+        std::lock_guard<std::mutex> lock(mutex);
+        live[type]--;
+        returned.notify_all();
+        return Lease();
+    }
+    return Lease(this, std::move(slot));
+}
+
+void SolverPool::warm(SolverType type, size_t count) {
+    for (size_t i = 0; i < count; ++i) {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            if (live[type] >= maxInstances(type)) {
+                return;
+            }
+            live[type]++;
+        }
+        std::unique_ptr<SolverSlot> slot = createSlot(type);
+        if (!slot) {
+            std::lock_guard<std::mutex> lock(mutex);
+            live[type]--;
+            return;
+        }
+        giveBack(std::move(slot));
+    }
+}
+
+size_t SolverPool::maxInstances(SolverType type) {
+    // One network per process: it is trained by every solve and saved to a
+    // single model file per board size
+    return type == SolverType::NEURO_SYMBOLIC ? 1 : std::numeric_limits<size_t>::max();
+}
+
+size_t SolverPool::getIdleCount(SolverType type) const {
+    std::lock_guard<std::mutex> lock(mutex);
+    auto it = idle.find(type);
+    return it == idle.end() ? 0 : it->second.size();
+}
+
+size_t SolverPool::getCreatedCount() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return created;
+}
+
+std::unique_ptr<SolverSlot> SolverPool::createSlot(SolverType type) {
+    SUDOKU_TRACE_SPAN("solver_construct");
+    std::unique_ptr<SudokuSolver> solver = SolverFactory::createSolver(type);
+    if (!solver) {
+        return nullptr;
+    }
+
+    std::unique_ptr<SolverSlot> slot(new SolverSlot());
+    slot->type = type;
+    slot->solver = std::move(solver);
+
+    std::lock_guard<std::mutex> lock(mutex);
+    created++;
+    SUDOKU_LOG_DEBUG("solver_pool", "created solver=" << SolverFactory::getSolverTypeName(type)
+                     << " total=" << created);
+    return slot;
+}
+
+void SolverPool::giveBack(std::unique_ptr<SolverSlot> slot) {
+    // Counters and progress are requested per solve; neither may leak into the next request
+    slot->context.collectCounters = false;
+    slot->context.progressInterval = 0;
+    slot->context.onProgress = nullptr;
+
+    std::lock_guard<std::mutex> lock(mutex);
+    std::vector<std::unique_ptr<SolverSlot>>& slots = idle[slot->type];
+    if (slots.size() < maxIdlePerType) {
+        slots.push_back(std::move(slot));
+    } else {
+        live[slot->type]--;
+    }
+    returned.notify_all();
+}
@@ -0,0 +1,103 @@
+/*
+SolverPool - warmed solvers that API requests borrow and return
+Creating a solver per request costs a heap allocation, the constraint
+solver's strategy table, and for neuro-symbolic a model load. The pool keeps
+finished solvers per type together with the buffers a solve needs (its
+SolveContext and two scratch boards), so a request only swaps a pointer and
+copies cells into boards whose storage already exists.
+
+Borrowing returns a Lease that hands the slot back when it goes out of scope.
+Idle slots are reused most-recently-returned first. The neuro-symbolic solver
+is stateful (its network learns from every solve and saves itself to
+models/), so the pool keeps exactly one of it: concurrent requests for that
+type wait for the instance instead of training diverging copies that
+overwrite each other's model file. Since that instance may be held for a
+whole train_batch, callers that must answer quickly pass a wait limit and
+get a busy lease back when it runs out. The pool is safe to use from
+several threads; a borrowed slot belongs to one request until it is
+returned.
+*/
+
+#ifndef SUDOKU_API_SOLVER_POOL_H
+#define SUDOKU_API_SOLVER_POOL_H
+
+#include "../model/board.h"
+#include "../solver/solver_interface.h"
+#include "../solver/solver_factory.h"
+#include <condition_variable>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+// One solver plus the per-request state that goes with it
+struct SolverSlot {
+    SolverType type;
+    std::unique_ptr<SudokuSolver> solver;
+    SolveContext context;
+    Board original;    // Puzzle as given, kept for neuro-symbolic training
+    Board solution;    // Board the solver works on
+};
+
+class SolverPool {
+public:
+    class Lease {
+    public:
+        Lease() = default;
+        Lease(Lease&& other) noexcept;
+        Lease& operator=(Lease&& other) noexcept;
+        ~Lease();
+
+        Lease(const Lease&) = delete;
+        Lease& operator=(const Lease&) = delete;
+
+        explicit operator bool() const { return slot != nullptr; }
+        // Empty because every instance stayed borrowed for the whole wait limit
+        bool isBusy() const { return busy; }
+        SolverSlot* operator->() const { return slot.get(); }
+        SolverSlot& operator*() const { return *slot; }
+        SudokuSolver& solver() const { return *slot->solver; }
+
+    private:
+        friend class SolverPool;
+        Lease(SolverPool* pool, std::unique_ptr<SolverSlot> slot);
+        void release();
+
+        SolverPool* pool = nullptr;
+        std::unique_ptr<SolverSlot> slot;
+        bool busy = false;
+    };
+
+    // maxIdlePerType bounds how many returned slots are kept per solver type
+    explicit SolverPool(size_t maxIdlePerType = 4);
+
+    // Empty lease for unknown or unimplemented solver types. Blocks while
+    // every instance a type may have is borrowed: without limit when
+    // maxWaitMs is negative, else at most maxWaitMs before returning a busy lease.
+    Lease borrow(const std::string& solverName, double maxWaitMs = -1.0);
+    Lease borrow(SolverType type, double maxWaitMs = -1.0);
+
+    // Builds slots ahead of the first request (long-lived API instances),
+    // at most as many as the type may have
+    void warm(SolverType type, size_t count);
+
+    // Instances of a type that may exist at once, borrowed or idle
+    static size_t maxInstances(SolverType type);
+
+    size_t getIdleCount(SolverType type) const;
+    size_t getCreatedCount() const;
+
+private:
+    std::unique_ptr<SolverSlot> createSlot(SolverType type);
+    void giveBack(std::unique_ptr<SolverSlot> slot);
+
+    mutable std::mutex mutex;
+    std::condition_variable returned;
+    std::map<SolverType, std::vector<std::unique_ptr<SolverSlot>>> idle;
+    std::map<SolverType, size_t> live;   // Borrowed plus idle, per type
+    size_t maxIdlePerType;
+    size_t created = 0;
+};
+
+#endif // SUDOKU_API_SOLVER_POOL_H
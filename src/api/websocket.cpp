@@ -0,0 +1,224 @@
+/*
+WebSocket implementation
+*/
+
+#include "websocket.h"
+#include <algorithm>
+#include <cctype>
+#include <sstream>
+
+namespace {
+
+// Appended to the client's key before hashing (RFC 6455 section 1.3)
+const char* const kHandshakeGuid = "258EAFA5-E914-47DA-95CA-C5AB0DC85B11";
+
+uint32_t rotateLeft(uint32_t value, int bits) {
+    return (value << bits) | (value >> (32 - bits));
+}
+
+// 20-byte SHA-1 digest; only used for the handshake, never for security
+std::string sha1(const std::string& message) {
+    uint32_t h[5] = {0x67452301, 0xEFCDAB89, 0x98BADCFE, 0x10325476, 0xC3D2E1F0};
+
+    std::string data = message;
+    uint64_t bitLength = static_cast<uint64_t>(message.size()) * 8;
+    data.push_back(static_cast<char>(0x80));
+    while (data.size() % 64 != 56) {
+        data.push_back(0);
+    }
+    for (int shift = 56; shift >= 0; shift -= 8) {
+        data.push_back(static_cast<char>((bitLength >> shift) & 0xFF));
+    }
+
+    for (size_t chunk = 0; chunk < data.size(); chunk += 64) {
+        uint32_t w[80];
+        for (int i = 0; i < 16; ++i) {
+            const unsigned char* p = reinterpret_cast<const unsigned char*>(data.data() + chunk + 4 * i);
+            w[i] = static_cast<uint32_t>(p[0]) << 24 | static_cast<uint32_t>(p[1]) << 16 |
+                   static_cast<uint32_t>(p[2]) << 8 | p[3];
+        }
+        for (int i = 16; i < 80; ++i) {
+            w[i] = rotateLeft(w[i - 3] ^ w[i - 8] ^ w[i - 14] ^ w[i - 16], 1);
+        }
+
+        uint32_t a = h[0], b = h[1], c = h[2], d = h[3], e = h[4];
+        for (int i = 0; i < 80; ++i) {
+            uint32_t f, k;
+            if (i < 20) {
+                f = (b & c) | (~b & d);
+                k = 0x5A827999;
+            } else if (i < 40) {
+                f = b ^ c ^ d;
+                k = 0x6ED9EBA1;
+            } else if (i < 60) {
+                f = (b & c) | (b & d) | (c & d);
+                k = 0x8F1BBCDC;
+            } else {
+                f = b ^ c ^ d;
+                k = 0xCA62C1D6;
+            }
+            uint32_t temp = rotateLeft(a, 5) + f + e + k + w[i];
+            e = d;
+            d = c;
+            c = rotateLeft(b, 30);
+            b = a;
+            a = temp;
+        }
+        h[0] += a; h[1] += b; h[2] += c; h[3] += d; h[4] += e;
+    }
+
+    std::string digest;
+    for (uint32_t word : h) {
+        for (int shift = 24; shift >= 0; shift -= 8) {
+            digest.push_back(static_cast<char>((word >> shift) & 0xFF));
+        }
+    }
+    return digest;
+}
+
+std::string base64(const std::string& data) {
+    static const char* const kAlphabet = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+    std::string out;
+    size_t i = 0;
+    for (; i + 2 < data.size(); i += 3) {
+        uint32_t n = static_cast<unsigned char>(data[i]) << 16 | static_cast<unsigned char>(data[i + 1]) << 8 |
+                     static_cast<unsigned char>(data[i + 2]);
+        out += kAlphabet[(n >> 18) & 63];
+        out += kAlphabet[(n >> 12) & 63];
+        out += kAlphabet[(n >> 6) & 63];
+        out += kAlphabet[n & 63];
+    }
+    if (i < data.size()) {
+        uint32_t n = static_cast<unsigned char>(data[i]) << 16;
+        if (i + 1 < data.size()) n |= static_cast<unsigned char>(data[i + 1]) << 8;
+        out += kAlphabet[(n >> 18) & 63];
+        out += kAlphabet[(n >> 12) & 63];
+        out += i + 1 < data.size() ? kAlphabet[(n >> 6) & 63] : '=';
+        out += '=';
+    }
+    return out;
+}
+
+std::string lower(std::string text) {
+    std::transform(text.begin(), text.end(), text.begin(),
+                   [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+    return text;
+}
+
+std::string trim(const std::string& text) {
+    size_t begin = text.find_first_not_of(" \t");
+    size_t end = text.find_last_not_of(" \t\r");
+    return begin == std::string::npos ? "" : text.substr(begin, end - begin + 1);
+}
+
+}
+
+size_t findHttpHeadEnd(const std::string& data) {
+    size_t end = data.find("\r\n\r\n");
+    return end == std::string::npos ? 0 : end + 4;
+}
+
+bool acceptWebSocketUpgrade(const std::string& requestHead, const std::vector<std::string>& allowedOrigins,
+                            std::string& response) {
+    std::istringstream lines(requestHead);
+    std::string line;
+    std::getline(lines, line);
+    bool isGet = line.compare(0, 4, "GET ") == 0;
+
+    std::string key;
+    std::string origin;
+    bool hasOrigin = false;
+    bool upgrade = false;
+    while (std::getline(lines, line)) {
+        size_t colon = line.find(':');
+        if (colon == std::string::npos) continue;
+        std::string name = lower(trim(line.substr(0, colon)));
+        std::string value = trim(line.substr(colon + 1));
+        if (name == "upgrade") {
+            upgrade = lower(value).find("websocket") != std::string::npos;
+        } else if (name == "sec-websocket-key") {
+            key = value;
+        } else if (name == "origin") {
+            origin = lower(value);
+            hasOrigin = true;
+        }
+    }
+
+    if (!isGet || !upgrade || key.empty()) {
+        response = "HTTP/1.1 400 Bad Request\r\nContent-Type: text/plain\r\nContent-Length: 28\r\n"
+                   "Connection: close\r\n\r\nExpected a WebSocket upgrade";
+        return false;
+    }
+    if (hasOrigin && std::none_of(allowedOrigins.begin(), allowedOrigins.end(),
+                                  [&origin](const std::string& allowed) { return lower(allowed) == origin; })) {
+        response = "HTTP/1.1 403 Forbidden\r\nContent-Type: text/plain\r\nContent-Length: 18\r\n"
+                   "Connection: close\r\n\r\nOrigin not allowed";
+        return false;
+    }
+    response = "HTTP/1.1 101 Switching Protocols\r\nUpgrade: websocket\r\nConnection: Upgrade\r\n"
+               "Sec-WebSocket-Accept: " + base64(sha1(key + kHandshakeGuid)) + "\r\n\r\n";
+    return true;
+}
+
+FrameStatus decodeWebSocketFrame(const std::string& data, size_t& offset, WebSocketFrame& frame,
+                                 size_t maxPayload) {
+    const unsigned char* bytes = reinterpret_cast<const unsigned char*>(data.data()) + offset;
+    size_t available = data.size() - offset;
+    if (available < 2) {
+        return FrameStatus::INCOMPLETE;
+    }
+
+    bool masked = (bytes[1] & 0x80) != 0;
+    if (!masked || (bytes[0] & 0x70) != 0) {
+        return FrameStatus::ERROR;   // Clients must mask; no extensions were negotiated
+    }
+    size_t header = 2;
+    uint64_t length = bytes[1] & 0x7F;
+    if (length == 126) {
+        if (available < 4) return FrameStatus::INCOMPLETE;
+        length = static_cast<uint64_t>(bytes[2]) << 8 | bytes[3];
+        header = 4;
+    } else if (length == 127) {
+        if (available < 10) return FrameStatus::INCOMPLETE;
+        length = 0;
+        for (int i = 0; i < 8; ++i) {
+            length = length << 8 | bytes[2 + i];
+        }
+        header = 10;
+    }
+    if (length > maxPayload) {
+        return FrameStatus::ERROR;
+    }
+    if (available < header + 4 + length) {
+        return FrameStatus::INCOMPLETE;
+    }
+
+    const unsigned char* mask = bytes + header;
+    const unsigned char* payload = mask + 4;
+    frame.fin = (bytes[0] & 0x80) != 0;
+    frame.opcode = static_cast<WebSocketOpcode>(bytes[0] & 0x0F);
+    frame.payload.resize(static_cast<size_t>(length));
+    for (size_t i = 0; i < length; ++i) {
+        frame.payload[i] = static_cast<char>(payload[i] ^ mask[i % 4]);
+    }
+    offset += header + 4 + static_cast<size_t>(length);
+    return FrameStatus::OK;
+}
+
+void encodeWebSocketFrame(WebSocketOpcode opcode, const std::string& payload, std::string& out) {
+    out.push_back(static_cast<char>(0x80 | static_cast<uint8_t>(opcode)));
+    size_t length = payload.size();
+    if (length < 126) {
+        out.push_back(static_cast<char>(length));
+    } else if (length <= 0xFFFF) {
+        out.push_back(static_cast<char>(126));
+        out.push_back(static_cast<char>(length >> 8));
+        out.push_back(static_cast<char>(length & 0xFF));
+    } else {
+        out.push_back(static_cast<char>(127));
+        for (int shift = 56; shift >= 0; shift -= 8) {
+            out.push_back(static_cast<char>((static_cast<uint64_t>(length) >> shift) & 0xFF));
+        }
+    }
+    out += payload;
+}
@@ -0,0 +1,59 @@
+/*
+WebSocket - server side of RFC 6455 for sudoku_api serve
+Just what the push channel needs: the HTTP/1.1 upgrade handshake, and
+framing for masked client frames in and unmasked server frames out.
+Extensions and subprotocols are not negotiated. The handshake's SHA-1 and
+base64 are implemented here, so there are no library dependencies.
+*/
+
+#ifndef SUDOKU_API_WEBSOCKET_H
+#define SUDOKU_API_WEBSOCKET_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+enum class WebSocketOpcode : uint8_t {
+    CONTINUATION = 0x0,
+    TEXT = 0x1,
+    BINARY = 0x2,
+    CLOSE = 0x8,
+    PING = 0x9,
+    PONG = 0xA
+};
+
+struct WebSocketFrame {
+    bool fin = true;
+    WebSocketOpcode opcode = WebSocketOpcode::TEXT;
+    std::string payload;   // Unmasked
+};
+
+enum class FrameStatus {
+    INCOMPLETE,   // Read more and call again
+    OK,
+    ERROR         // Protocol violation; close the connection
+};
+
+// Length of the HTTP request head (through the blank line) at the start of
+// data, or 0 while it has not all arrived
+size_t findHttpHeadEnd(const std::string& data);
+
+// Fills response with the 101 Switching Protocols reply for a WebSocket
+// upgrade request, or with a 400 reply (and returns false) for anything else.
+// Browsers let any page open a WebSocket to any host and say which page it
+// was in the Origin header, so a request whose Origin is not in
+// allowedOrigins (compared case-insensitively) gets a 403. Requests without
+// an Origin come from programs rather than browser pages and are accepted.
+bool acceptWebSocketUpgrade(const std::string& requestHead, const std::vector<std::string>& allowedOrigins,
+                            std::string& response);
+
+// Decodes one client frame at data[offset] and advances offset past it.
+// Unmasked frames and payloads over maxPayload are errors.
+FrameStatus decodeWebSocketFrame(const std::string& data, size_t& offset, WebSocketFrame& frame,
+                                 size_t maxPayload);
+
+// Appends one unfragmented server frame
+void encodeWebSocketFrame(WebSocketOpcode opcode, const std::string& payload, std::string& out);
+
+#endif // SUDOKU_API_WEBSOCKET_H
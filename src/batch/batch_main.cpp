@@ -0,0 +1,448 @@
+/*
+Batch solver for puzzle files
+Streams puzzles from files or stdin through a reader -> solver tasks ->
+ordered writer pipeline. Each puzzle is one task on the shared executor.
+Only a bounded window of puzzles is in flight at any time, so memory stays
+constant however large the input is, while the executor keeps every core
+busy. Output order always matches input order.
+
+Usage: sudoku_batch [--solver NAME|auto] [--threads N] [--window N]
+                    [--format tsv|lines] [--parse-only] [FILE...]
+                    (no FILE or "-" = stdin)
+
+Compressed .sdkc corpora (see sudoku_corpus) are decoded block by block;
+text files are read through CorpusReader (io_uring or pread, several large reads
+in flight) and records are sliced straight out of its buffers; stdin falls
+back to line-by-line reads. --parse-only stops after parsing and reports the
+input throughput, to check that reading keeps up with the solver pool.
+
+tsv output:   index <TAB> status <TAB> time_ms <TAB> board
+lines output: the solved (or best partial) board, one per line
+status is one of solved, unsolved, invalid (conflicting givens), error (bad input)
+*/
+
+#include "../io/corpus_format.h"
+#include "../io/corpus_reader.h"
+#include "../io/puzzle_format.h"
+#include "../solver/solver_factory.h"
+#include "../util/executor.h"
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace {
+
+struct BatchRecord {
+    long index;
+    std::string cells;     // Normalised cells; empty when `error` is set
+    std::string error;
+};
+
+struct BatchResult {
+    std::string status;
+    std::string board;
+    double timeMs = 0.0;
+    std::string message;
+};
+
+// Reorders results and writes them as soon as the next index is available.
+// The reader calls admit() first, which bounds how far ahead of the writer
+// it may run - this window is what keeps memory constant.
+class OrderedWriter {
+public:
+    OrderedWriter(FILE* out, bool tsv, size_t window)
+        : out(out), tsv(tsv), window(window), nextIndex(0) {}
+
+    void admit(long index) {
+        std::unique_lock<std::mutex> lock(mutex);
+        drained.wait(lock, [&]() { return index - nextIndex < static_cast<long>(window); });
+    }
+
+    void submit(long index, BatchResult result) {
+        std::lock_guard<std::mutex> lock(mutex);
+        pending.emplace(index, std::move(result));
+        bool wrote = false;
+        for (auto it = pending.find(nextIndex); it != pending.end(); it = pending.find(nextIndex)) {
+            write(it->first, it->second);
+            pending.erase(it);
+            nextIndex++;
+            wrote = true;
+        }
+        if (wrote) {
+            drained.notify_all();
+        }
+    }
+
+    std::map<std::string, long> getStatusCounts() const { return statusCounts; }
+
+private:
+    FILE* out;
+    bool tsv;
+    size_t window;
+    long nextIndex;
+    std::map<long, BatchResult> pending;
+    std::map<std::string, long> statusCounts;
+    std::mutex mutex;
+    std::condition_variable drained;
+
+    void write(long index, const BatchResult& result) {
+        statusCounts[result.status]++;
+        if (tsv) {
+            std::fprintf(out, "%ld\t%s\t%.3f\t%s\n", index, result.status.c_str(), result.timeMs,
+                         result.message.empty() ? result.board.c_str() : result.message.c_str());
+        } else {
+            std::fprintf(out, "%s\n", result.message.empty() ? result.board.c_str() : "");
+        }
+    }
+};
+
+// Solvers used by one executor thread; `fallback` is only set in auto mode.
+// Reentrant solvers are shared by every thread, others are owned per thread.
+struct WorkerSolvers {
+    SudokuSolver* primary = nullptr;
+    SudokuSolver* fallback = nullptr;
+};
+
+struct WorkerState {
+    std::unique_ptr<SudokuSolver> ownPrimary;
+    std::unique_ptr<SudokuSolver> ownFallback;
+    WorkerSolvers solvers;
+    Board board{3};
+};
+
+int countGivens(const Board& board) {
+    int size = board.getBoardSize();
+    int givens = 0;
+    for (int row = 0; row < size; ++row) {
+        for (int col = 0; col < size; ++col) {
+            if (board.getCell(row, col).getValue() != 0) givens++;
+        }
+    }
+    return givens;
+}
+
+// Auto mode: plain backtracking is fastest while many givens prune the search
+// (easy/medium in sudoku_bench); sparser puzzles first get constraint
+// propagation, whose placements are all forced, and backtracking finishes the rest.
+bool solveAuto(WorkerSolvers& solvers, Board& board, SolveContext& context) {
+    int cells = board.getBoardSize() * board.getBoardSize();
+    if (countGivens(board) * 9 >= cells * 4) {
+        return solvers.fallback->solve(board, context);
+    }
+    // Each solve() starts its context afresh, so the constraint pass gets its
+    // own and its moves and time are added to the fallback's
+    SolveContext constraintPass = context;
+    if (solvers.primary->solve(board, constraintPass) && board.isComplete()) {
+        context = constraintPass;
+        return true;
+    }
+    bool solved = solvers.fallback->solve(board, context);
+    context.movesCount += constraintPass.movesCount;
+    context.solveTimeMs += constraintPass.solveTimeMs;
+    context.counters += constraintPass.counters;
+    return solved;
+}
+
+BatchResult solveRecord(const BatchRecord& record, WorkerSolvers& solvers, Board& board) {
+    BatchResult result;
+    if (!record.error.empty()) {
+        result.status = "error";
+        result.message = record.error;
+        return result;
+    }
+
+    std::string error;
+    if (!boardFromCells(record.cells, board, error)) {
+        result.status = "error";
+        result.message = error;
+        return result;
+    }
+    if (!board.isValid()) {
+        result.status = "invalid";
+        result.board = boardToLine(board);
+        return result;
+    }
+
+    auto start = std::chrono::high_resolution_clock::now();
+    SolveContext context;
+    bool attempt = solvers.fallback ? solveAuto(solvers, board, context)
+                                    : solvers.primary->solve(board, context);
+    bool solved = attempt && board.isComplete() && board.isValid();
+    result.timeMs = std::chrono::duration<double, std::milli>(
+        std::chrono::high_resolution_clock::now() - start).count();
+
+    result.status = solved ? "solved" : "unsolved";
+    result.board = boardToLine(board);
+    return result;
+}
+
+// Runs each record as a task on the shared executor. Every executor thread
+// (plus the reading thread once it helps in finish()) gets its own board, and
+// its own solvers unless they are reentrant, created on first use by that
+// thread so they live on its NUMA node.
+class SolveDispatcher {
+public:
+    SolveDispatcher(const std::string& solverName, bool autoSolver, OrderedWriter& writer)
+        : solverName(solverName), autoSolver(autoSolver), writer(writer),
+          group(TaskPriority::NORMAL), states(Executor::shared().getConcurrency()) {
+        sharedPrimary = SolverFactory::createSolver(solverName);
+        sharedFallback = autoSolver ? SolverFactory::createSolver("backtrack") : nullptr;
+        bool reentrant = sharedPrimary && sharedPrimary->isReentrant() &&
+                         (!sharedFallback || sharedFallback->isReentrant());
+        if (!reentrant) {
+            sharedPrimary.reset();
+            sharedFallback.reset();
+        }
+    }
+
+    void submit(BatchRecord record) {
+        group.run([this, record]() {
+            WorkerState& state = currentState();
+            writer.submit(record.index, solveRecord(record, state.solvers, state.board));
+        });
+    }
+
+    void finish() { group.wait(); }
+
+private:
+    std::string solverName;
+    bool autoSolver;
+    OrderedWriter& writer;
+    TaskGroup group;
+    std::unique_ptr<SudokuSolver> sharedPrimary;
+    std::unique_ptr<SudokuSolver> sharedFallback;
+    std::vector<std::unique_ptr<WorkerState>> states;
+
+    WorkerState& currentState() {
+        int worker = Executor::currentWorker();
+        std::unique_ptr<WorkerState>& state = states[worker >= 0 ? worker : states.size() - 1];
+        if (!state) {
+            state.reset(new WorkerState());
+            if (sharedPrimary) {
+                state->solvers.primary = sharedPrimary.get();
+                state->solvers.fallback = sharedFallback.get();
+            } else {
+                state->ownPrimary = SolverFactory::createSolver(solverName);
+                state->ownFallback = autoSolver ? SolverFactory::createSolver("backtrack") : nullptr;
+                state->solvers.primary = state->ownPrimary.get();
+                state->solvers.fallback = state->ownFallback.get();
+            }
+        }
+        return *state;
+    }
+};
+
+// Turns assembler results into solve tasks, numbering them in input order
+class RecordEmitter {
+public:
+    RecordEmitter(const std::string& source, long index, SolveDispatcher* dispatcher, OrderedWriter* writer)
+        : source(source), index(index), dispatcher(dispatcher), writer(writer) {}
+
+    void addLine(const char* data, size_t length) {
+        emit(assembler.addLine(data, length, cells, error));
+    }
+
+    // An already-normalised puzzle, e.g. from a compressed corpus
+    void addCells(const char* data, size_t length) {
+        cells.assign(data, length);
+        emit(PuzzleLineAssembler::Result::PUZZLE);
+    }
+
+    long finish() {
+        emit(assembler.finish(error));
+        return index;
+    }
+
+private:
+    std::string source;
+    long index;
+    SolveDispatcher* dispatcher;   // Null in --parse-only mode
+    OrderedWriter* writer;
+    PuzzleLineAssembler assembler;
+    std::string cells;
+    std::string error;
+
+    void emit(PuzzleLineAssembler::Result result) {
+        if (result == PuzzleLineAssembler::Result::NONE) return;
+        if (dispatcher) {
+            writer->admit(index);
+            if (result == PuzzleLineAssembler::Result::PUZZLE) {
+                dispatcher->submit({index, std::move(cells), ""});
+            } else {
+                dispatcher->submit({index, "", source + ": " + error});
+            }
+        }
+        index++;
+    }
+};
+
+// Feeds every puzzle in `in` to the emitter; returns the next free index
+long readPuzzles(std::istream& in, RecordEmitter& emitter) {
+    std::string line;
+    while (std::getline(in, line)) {
+        emitter.addLine(line.data(), line.size());
+    }
+    return emitter.finish();
+}
+
+// Same for a file, slicing lines out of the reader's chunks without copying
+long readPuzzleFile(CorpusReader& reader, RecordEmitter& emitter) {
+    CorpusChunk chunk;
+    while (reader.next(chunk)) {
+        const char* line = chunk.data;
+        const char* end = chunk.data + chunk.length;
+        while (line < end) {
+            const char* newline = static_cast<const char*>(std::memchr(line, '\n', end - line));
+            const char* lineEnd = newline ? newline : end;
+            emitter.addLine(line, static_cast<size_t>(lineEnd - line));
+            line = lineEnd + 1;
+        }
+        reader.release(chunk);
+    }
+    return emitter.finish();
+}
+
+// Same for a compressed corpus; false if a block fails to decode
+bool readCorpusFile(CorpusFile& corpus, RecordEmitter& emitter, long& index, std::string& error) {
+    std::string block;
+    size_t cellCount = corpus.cellsPerPuzzle();
+    bool ok = true;
+    for (uint32_t b = 0; ok && b < corpus.getHeader().blockCount; ++b) {
+        ok = corpus.readBlock(b, block, error);
+        for (size_t offset = 0; ok && offset < block.size(); offset += cellCount) {
+            emitter.addCells(block.data() + offset, cellCount);
+        }
+    }
+    index = emitter.finish();
+    return ok;
+}
+
+}
+
+int main(int argc, char* argv[]) {
+    std::string solverName = "auto";
+    int threads = 0;
+    size_t window = 0;
+    bool tsv = true;
+    bool parseOnly = false;
+    std::vector<std::string> inputs;
+
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--solver" && i + 1 < argc) {
+            solverName = argv[++i];
+        } else if (arg == "--threads" && i + 1 < argc) {
+            threads = std::atoi(argv[++i]);
+        } else if (arg == "--window" && i + 1 < argc) {
+            window = static_cast<size_t>(std::max(1, std::atoi(argv[++i])));
+        } else if (arg == "--format" && i + 1 < argc) {
+            std::string format = argv[++i];
+            if (format != "tsv" && format != "lines") {
+                std::cerr << "Unknown format: " << format << " (expected tsv or lines)\n";
+                return 1;
+            }
+            tsv = format == "tsv";
+        } else if (arg == "--parse-only") {
+            parseOnly = true;
+        } else if (arg == "--help" || arg == "-h" || (arg.size() > 1 && arg[0] == '-' && arg != "-")) {
+            std::cerr << "Usage: sudoku_batch [--solver NAME|auto] [--threads N] [--window N]\n"
+                      << "                    [--format tsv|lines] [--parse-only] [FILE...]\n";
+            return arg == "--help" || arg == "-h" ? 0 : 1;
+        } else {
+            inputs.push_back(arg);
+        }
+    }
+    if (inputs.empty()) {
+        inputs.push_back("-");
+    }
+
+    bool autoSolver = solverName == "auto";
+    std::string resolvedSolver = autoSolver ? "constraint" : solverName;
+    if (!SolverFactory::createSolver(resolvedSolver)) {
+        std::cerr << "Unknown solver: " << solverName << "\n";
+        return 1;
+    }
+
+    if (threads > 0) {
+        Executor::Options options;
+        options.threads = threads;
+        Executor::configureShared(options);
+    }
+    threads = Executor::shared().getThreadCount();
+    if (window == 0) {
+        window = static_cast<size_t>(threads) * 64;
+    }
+
+    OrderedWriter writer(stdout, tsv, window);
+    SolveDispatcher dispatcher(resolvedSolver, autoSolver, writer);
+    SolveDispatcher* target = parseOnly ? nullptr : &dispatcher;
+
+    auto start = std::chrono::high_resolution_clock::now();
+
+    long index = 0;
+    uint64_t bytes = 0;
+    std::string backend = "stdin";
+    bool inputFailed = false;
+    for (const std::string& input : inputs) {
+        if (input == "-") {
+            RecordEmitter emitter("stdin", index, target, &writer);
+            index = readPuzzles(std::cin, emitter);
+            continue;
+        }
+        std::string error;
+        if (isCorpusFile(input)) {
+            CorpusFile corpus;
+            RecordEmitter emitter(input, index, target, &writer);
+            if (!corpus.open(input, error) || !readCorpusFile(corpus, emitter, index, error)) {
+                std::cerr << "❌ " << error << "\n";
+                inputFailed = true;
+            }
+            bytes += corpus.getHeader().indexOffset;
+            backend = "sdkc";
+            continue;
+        }
+        CorpusReader reader(input);
+        if (!reader.open(error)) {
+            std::cerr << "❌ Cannot open " << error << "\n";
+            inputFailed = true;
+            continue;
+        }
+        RecordEmitter emitter(input, index, target, &writer);
+        index = readPuzzleFile(reader, emitter);
+        bytes += reader.getBytesRead();
+        backend = reader.getBackend();
+        if (!reader.getError().empty()) {
+            std::cerr << "❌ " << reader.getError() << "\n";
+            inputFailed = true;
+        }
+    }
+
+    if (parseOnly) {
+        double seconds = std::chrono::duration<double>(std::chrono::high_resolution_clock::now() - start).count();
+        std::cerr << "📖 Parsed " << index << " puzzles, " << bytes / (1024.0 * 1024.0) << " MiB in "
+                  << seconds << " s (" << (seconds > 0 ? bytes / (1024.0 * 1024.0) / seconds : 0.0) << " MiB/s, "
+                  << (seconds > 0 ? index / seconds : 0.0) << " puzzles/s) via " << backend << "\n";
+        return inputFailed ? 1 : 0;
+    }
+
+    dispatcher.finish();
+    std::fflush(stdout);
+
+    double seconds = std::chrono::duration<double>(std::chrono::high_resolution_clock::now() - start).count();
+    auto counts = writer.getStatusCounts();
+    std::cerr << "📦 " << index << " puzzles with " << solverName << " on " << threads << " threads: "
+              << counts["solved"] << " solved, " << counts["unsolved"] << " unsolved, "
+              << counts["invalid"] << " invalid, " << counts["error"] << " errors in "
+              << seconds << " s (" << (seconds > 0 ? index / seconds : 0.0) << " puzzles/s)\n";
+
+    return inputFailed ? 1 : 0;
+}
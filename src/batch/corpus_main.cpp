@@ -0,0 +1,213 @@
+/*
+Corpus tool for compressed puzzle files (.sdkc, see io/corpus_format.h)
+
+Usage: sudoku_corpus pack [--block N] OUT.sdkc [FILE...]   text -> corpus (no FILE or "-" = stdin)
+       sudoku_corpus unpack IN.sdkc                        corpus -> one puzzle per line
+       sudoku_corpus get IN.sdkc INDEX...                  random access by puzzle index
+       sudoku_corpus info IN.sdkc                          header and difficulty histogram
+
+sudoku_batch reads .sdkc files directly, so packed corpora can be solved
+without unpacking them first.
+*/
+
+#include "../io/corpus_format.h"
+#include "../io/corpus_reader.h"
+#include "../io/puzzle_format.h"
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <string>
+#include <vector>
+
+namespace {
+
+int usage() {
+    std::cerr << "Usage: sudoku_corpus pack [--block N] OUT.sdkc [FILE...]\n"
+              << "       sudoku_corpus unpack IN.sdkc\n"
+              << "       sudoku_corpus get IN.sdkc INDEX...\n"
+              << "       sudoku_corpus info IN.sdkc\n";
+    return 1;
+}
+
+// '0' blanks back to the '.' used by text corpora
+void writeCells(std::string cells) {
+    for (char& c : cells) {
+        if (c == '0') c = '.';
+    }
+    cells += '\n';
+    std::fwrite(cells.data(), 1, cells.size(), stdout);
+}
+
+int pack(int argc, char* argv[]) {
+    uint32_t blockSize = CorpusWriter::kDefaultBlockSize;
+    std::vector<std::string> args;
+    for (int i = 0; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--block" && i + 1 < argc) {
+            blockSize = static_cast<uint32_t>(std::max(1, std::atoi(argv[++i])));
+        } else {
+            args.push_back(arg);
+        }
+    }
+    if (args.empty()) {
+        return usage();
+    }
+    std::vector<std::string> inputs(args.begin() + 1, args.end());
+    if (inputs.empty()) {
+        inputs.push_back("-");
+    }
+
+    CorpusWriter writer(blockSize);
+    std::string error;
+    if (!writer.open(args[0], error)) {
+        std::cerr << "❌ " << error << "\n";
+        return 1;
+    }
+
+    uint64_t inputBytes = 0;
+    long skipped = 0;
+    bool failed = false;
+    for (const std::string& input : inputs) {
+        PuzzleLineAssembler assembler;
+        std::string cells;
+        auto add = [&](PuzzleLineAssembler::Result result) {
+            if (result == PuzzleLineAssembler::Result::NONE) return;
+            if (result == PuzzleLineAssembler::Result::PUZZLE && writer.add(cells, error)) return;
+            std::cerr << "⚠️  " << input << ": " << error << " (skipped)\n";
+            skipped++;
+        };
+        auto addLines = [&](const char* data, size_t length) {
+            const char* end = data + length;
+            while (data < end) {
+                const char* newline = static_cast<const char*>(std::memchr(data, '\n', end - data));
+                const char* lineEnd = newline ? newline : end;
+                add(assembler.addLine(data, static_cast<size_t>(lineEnd - data), cells, error));
+                data = lineEnd + 1;
+            }
+        };
+
+        if (input == "-") {
+            std::string line;
+            while (std::getline(std::cin, line)) {
+                inputBytes += line.size() + 1;
+                add(assembler.addLine(line.data(), line.size(), cells, error));
+            }
+        } else {
+            CorpusReader reader(input);
+            if (!reader.open(error)) {
+                std::cerr << "❌ Cannot open " << error << "\n";
+                failed = true;
+                continue;
+            }
+            CorpusChunk chunk;
+            while (reader.next(chunk)) {
+                addLines(chunk.data, chunk.length);
+                reader.release(chunk);
+            }
+            inputBytes += reader.getBytesRead();
+            if (!reader.getError().empty()) {
+                std::cerr << "❌ " << reader.getError() << "\n";
+                failed = true;
+            }
+        }
+        add(assembler.finish(error));
+    }
+
+    if (!writer.close(error)) {
+        std::cerr << "❌ " << error << "\n";
+        return 1;
+    }
+    const CorpusHeader& header = writer.getHeader();
+    uint64_t packedBytes = header.indexOffset + header.blockCount * 8ull;
+    std::cerr << "📦 Packed " << header.puzzleCount << " puzzles into " << header.blockCount << " blocks: "
+              << inputBytes << " -> " << packedBytes << " bytes ("
+              << (header.puzzleCount ? static_cast<double>(packedBytes) / header.puzzleCount : 0.0)
+              << " bytes/puzzle)";
+    if (skipped > 0) {
+        std::cerr << ", " << skipped << " skipped";
+    }
+    std::cerr << "\n";
+    return failed ? 1 : 0;
+}
+
+int unpack(const std::string& path) {
+    CorpusFile corpus;
+    std::string error;
+    if (!corpus.open(path, error)) {
+        std::cerr << "❌ " << error << "\n";
+        return 1;
+    }
+    std::string block;
+    size_t cellCount = corpus.cellsPerPuzzle();
+    for (uint32_t b = 0; b < corpus.getHeader().blockCount; ++b) {
+        if (!corpus.readBlock(b, block, error)) {
+            std::cerr << "❌ " << error << "\n";
+            return 1;
+        }
+        for (size_t offset = 0; offset < block.size(); offset += cellCount) {
+            writeCells(block.substr(offset, cellCount));
+        }
+    }
+    return 0;
+}
+
+int get(const std::string& path, int argc, char* argv[]) {
+    CorpusFile corpus;
+    std::string error;
+    if (!corpus.open(path, error)) {
+        std::cerr << "❌ " << error << "\n";
+        return 1;
+    }
+    std::string cells;
+    for (int i = 0; i < argc; ++i) {
+        if (!corpus.getPuzzle(std::strtoull(argv[i], nullptr, 10), cells, error)) {
+            std::cerr << "❌ " << error << "\n";
+            return 1;
+        }
+        writeCells(cells);
+    }
+    return 0;
+}
+
+int info(const std::string& path) {
+    CorpusFile corpus;
+    std::string error;
+    if (!corpus.open(path, error)) {
+        std::cerr << "❌ " << error << "\n";
+        return 1;
+    }
+    const CorpusHeader& header = corpus.getHeader();
+    uint64_t bytes = header.indexOffset + header.blockCount * 8ull;
+    std::cout << "puzzles:     " << header.puzzleCount << "\n"
+              << "board:       " << header.boardSize << "x" << header.boardSize << "\n"
+              << "blocks:      " << header.blockCount << " x " << header.blockSize << " puzzles\n"
+              << "bytes:       " << bytes << " ("
+              << (header.puzzleCount ? static_cast<double>(bytes) / header.puzzleCount : 0.0) << " per puzzle)\n";
+    for (int i = 0; i < kCorpusDifficultyCount; ++i) {
+        std::cout << "  " << corpusDifficultyName(i) << ":" << std::string(11 - std::strlen(corpusDifficultyName(i)), ' ')
+                  << header.difficultyHistogram[i] << "\n";
+    }
+    return 0;
+}
+
+}
+
+int main(int argc, char* argv[]) {
+    if (argc < 3) {
+        return usage();
+    }
+    std::string command = argv[1];
+    if (command == "pack") {
+        return pack(argc - 2, argv + 2);
+    }
+    if (command == "unpack" && argc == 3) {
+        return unpack(argv[2]);
+    }
+    if (command == "get" && argc >= 4) {
+        return get(argv[2], argc - 3, argv + 3);
+    }
+    if (command == "info" && argc == 3) {
+        return info(argv[2]);
+    }
+    return usage();
+}
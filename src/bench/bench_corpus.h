@@ -0,0 +1,65 @@
+/*
+Reproducible puzzle corpora shared by the benchmark executables
+The same seed always yields the same puzzles, so numbers from different
+builds (or a stored baseline) measure the code, not the input.
+*/
+
+#ifndef SUDOKU_BENCH_CORPUS_H
+#define SUDOKU_BENCH_CORPUS_H
+
+#include "../model/board.h"
+#include "../model/sudoku_generator.h"
+#include <sstream>
+#include <string>
+#include <utility>
+#include <vector>
+
+struct BenchCorpus {
+    std::string name;
+    std::vector<Board> puzzles;
+};
+
+// One 9x9 corpus per difficulty level: easy, medium, hard, expert
+inline std::vector<BenchCorpus> buildBenchCorpora(int puzzlesPerCorpus, unsigned int seed) {
+    const std::pair<const char*, SudokuGenerator::Difficulty> levels[] = {
+        {"easy", SudokuGenerator::EASY},
+        {"medium", SudokuGenerator::MEDIUM},
+        {"hard", SudokuGenerator::HARD},
+        {"expert", SudokuGenerator::EXPERT}
+    };
+
+    SudokuGenerator generator(seed);
+    std::vector<BenchCorpus> corpora;
+    for (const auto& level : levels) {
+        BenchCorpus corpus{level.first, {}};
+        while (static_cast<int>(corpus.puzzles.size()) < puzzlesPerCorpus) {
+            Board puzzle(3);
+            if (generator.generateCompleteGrid(puzzle) &&
+                generator.createPuzzleFromCompleteGrid(puzzle, level.second)) {
+                corpus.puzzles.push_back(puzzle);
+            }
+        }
+        corpora.push_back(std::move(corpus));
+    }
+    return corpora;
+}
+
+// [[5,3,0,...],...] - the simple array form accepted by solve_custom_puzzle
+inline std::string boardToArrayJson(const Board& board) {
+    int size = board.getBoardSize();
+    std::ostringstream json;
+    json << "[";
+    for (int row = 0; row < size; ++row) {
+        if (row > 0) json << ",";
+        json << "[";
+        for (int col = 0; col < size; ++col) {
+            if (col > 0) json << ",";
+            json << board.getCell(row, col).getValue();
+        }
+        json << "]";
+    }
+    json << "]";
+    return json.str();
+}
+
+#endif // SUDOKU_BENCH_CORPUS_H
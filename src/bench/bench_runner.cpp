@@ -0,0 +1,478 @@
+/*
+Benchmark runner with regression baselines
+Runs the solver and API benchmarks several times over a reproducible corpus
+and summarises each one as the median over repetitions with a
+distribution-free confidence interval (order statistics of the median). Results
+can be saved as a versioned JSON baseline and later runs compared against it:
+a benchmark only counts as regressed when its median moved past the
+threshold AND its confidence interval no longer overlaps the baseline's, so
+ordinary run-to-run noise does not fail the build.
+
+Exit status: 0 = no regression, 1 = regression, 2 = usage or baseline error.
+
+Usage: sudoku_bench [--puzzles N] [--repetitions R] [--seed S] [--solvers a,b,...]
+                    [--no-api] [--filter TEXT] [--save PATH] [--compare PATH]
+                    [--threshold PERCENT]
+*/
+
+#include "bench_corpus.h"
+#include "../api/json_api.h"
+#include "../solver/solver_factory.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <ctime>
+#include <fstream>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+
+const int kBaselineFormatVersion = 1;
+const double kConfidenceLevel = 0.95;
+
+// A benchmark is a fixed list of items, each timed individually
+struct BenchCase {
+    std::string name;
+    int items;
+    std::function<void(int)> runItem;
+};
+
+struct Estimate {
+    double median = 0.0;
+    double low = 0.0;
+    double high = 0.0;
+};
+
+struct BenchSummary {
+    std::string name;
+    int repetitions = 0;
+    int items = 0;
+    Estimate puzzlesPerSec;
+    Estimate p50Ms;
+    Estimate p99Ms;
+};
+
+// ============================================================================
+// Statistics
+// ============================================================================
+
+double percentile(std::vector<double> values, double fraction) {
+    if (values.empty()) return 0.0;
+    std::sort(values.begin(), values.end());
+    double rank = fraction * (values.size() - 1);
+    size_t lower = static_cast<size_t>(std::floor(rank));
+    size_t upper = std::min(values.size() - 1, lower + 1);
+    return values[lower] + (rank - lower) * (values[upper] - values[lower]);
+}
+
+// Median plus a confidence interval from order statistics: with n samples the
+// median lies between the k-th smallest and k-th largest value with probability
+// 1 - 2 * P(Binomial(n, 1/2) < k). Needs no assumption about the distribution.
+Estimate estimateMedian(std::vector<double> samples) {
+    Estimate estimate;
+    if (samples.empty()) return estimate;
+    std::sort(samples.begin(), samples.end());
+    estimate.median = percentile(samples, 0.5);
+
+    int n = static_cast<int>(samples.size());
+    double alpha = 1.0 - kConfidenceLevel;
+    double cumulative = 0.0;
+    double coefficient = 1.0;           // C(n, i)
+    double scale = std::pow(0.5, n);
+    int k = 0;
+    for (int i = 0; i <= n / 2; ++i) {
+        double next = cumulative + coefficient * scale;
+        if (next > alpha / 2) break;
+        cumulative = next;
+        k = i + 1;
+        coefficient = coefficient * (n - i) / (i + 1);
+    }
+
+    // Too few samples for the requested level: fall back to the full range
+    int lowIndex = std::max(0, k - 1);
+    estimate.low = samples[lowIndex];
+    estimate.high = samples[n - 1 - lowIndex];
+    return estimate;
+}
+
+BenchSummary runBenchmark(const BenchCase& bench, int repetitions) {
+    using Clock = std::chrono::high_resolution_clock;
+
+    // One unmeasured pass warms caches, lazily loaded models and the allocator
+    for (int item = 0; item < bench.items; ++item) {
+        bench.runItem(item);
+    }
+
+    std::vector<double> throughput, p50, p99;
+    for (int rep = 0; rep < repetitions; ++rep) {
+        std::vector<double> latencies;
+        latencies.reserve(bench.items);
+
+        auto passStart = Clock::now();
+        for (int item = 0; item < bench.items; ++item) {
+            auto start = Clock::now();
+            bench.runItem(item);
+            latencies.push_back(std::chrono::duration<double, std::milli>(Clock::now() - start).count());
+        }
+        double passMs = std::chrono::duration<double, std::milli>(Clock::now() - passStart).count();
+
+        throughput.push_back(passMs > 0 ? 1000.0 * bench.items / passMs : 0.0);
+        p50.push_back(percentile(latencies, 0.50));
+        p99.push_back(percentile(latencies, 0.99));
+    }
+
+    BenchSummary summary;
+    summary.name = bench.name;
+    summary.repetitions = repetitions;
+    summary.items = bench.items;
+    summary.puzzlesPerSec = estimateMedian(throughput);
+    summary.p50Ms = estimateMedian(p50);
+    summary.p99Ms = estimateMedian(p99);
+    return summary;
+}
+
+// ============================================================================
+// Baseline file
+// ============================================================================
+
+std::string estimateJson(const std::string& key, const Estimate& estimate) {
+    std::ostringstream json;
+    json << std::setprecision(6)
+         << "\"" << key << "\":" << estimate.median << ","
+         << "\"" << key << "_ci\":[" << estimate.low << "," << estimate.high << "]";
+    return json.str();
+}
+
+bool saveBaseline(const std::string& path, const std::vector<BenchSummary>& summaries,
+                  int puzzles, int repetitions, unsigned int seed) {
+    std::ofstream file(path);
+    if (!file.is_open()) {
+        return false;
+    }
+
+    std::time_t now = std::time(nullptr);
+    char created[32];
+    std::strftime(created, sizeof(created), "%Y-%m-%dT%H:%M:%SZ", std::gmtime(&now));
+
+    file << "{\n";
+    file << "  \"format_version\": " << kBaselineFormatVersion << ",\n";
+    file << "  \"created\": \"" << created << "\",\n";
+    file << "  \"compiler\": \"" << __VERSION__ << "\",\n";
+    file << "  \"hardware_threads\": " << std::thread::hardware_concurrency() << ",\n";
+    file << "  \"puzzles_per_corpus\": " << puzzles << ",\n";
+    file << "  \"repetitions\": " << repetitions << ",\n";
+    file << "  \"seed\": " << seed << ",\n";
+    file << "  \"benchmarks\": [\n";
+    // One benchmark per line keeps the file diffable and trivial to parse back
+    for (size_t i = 0; i < summaries.size(); ++i) {
+        const BenchSummary& s = summaries[i];
+        file << "    {\"name\":\"" << s.name << "\",\"items\":" << s.items
+             << ",\"repetitions\":" << s.repetitions << ","
+             << estimateJson("puzzles_per_sec", s.puzzlesPerSec) << ","
+             << estimateJson("p50_ms", s.p50Ms) << ","
+             << estimateJson("p99_ms", s.p99Ms) << "}"
+             << (i + 1 < summaries.size() ? "," : "") << "\n";
+    }
+    file << "  ]\n";
+    file << "}\n";
+    return true;
+}
+
+bool extractNumber(const std::string& line, const std::string& key, double& value) {
+    size_t pos = line.find("\"" + key + "\":");
+    if (pos == std::string::npos) return false;
+    pos += key.size() + 3;
+    if (pos < line.size() && line[pos] == '[') pos++;
+    value = std::atof(line.c_str() + pos);
+    return true;
+}
+
+bool extractEstimate(const std::string& line, const std::string& key, Estimate& estimate) {
+    if (!extractNumber(line, key, estimate.median)) return false;
+    size_t pos = line.find("\"" + key + "_ci\":[");
+    if (pos == std::string::npos) {
+        estimate.low = estimate.high = estimate.median;
+        return true;
+    }
+    pos += key.size() + 7;
+    estimate.low = std::atof(line.c_str() + pos);
+    size_t comma = line.find(',', pos);
+    estimate.high = comma == std::string::npos ? estimate.low : std::atof(line.c_str() + comma + 1);
+    return true;
+}
+
+// Baselines are only comparable when they were measured on the same corpus
+struct BaselineCorpus {
+    double puzzles = -1;
+    double seed = -1;
+};
+
+bool loadBaseline(const std::string& path, std::map<std::string, BenchSummary>& baseline,
+                  BaselineCorpus& corpus, std::string& error) {
+    std::ifstream file(path);
+    if (!file.is_open()) {
+        error = "cannot open " + path;
+        return false;
+    }
+
+    std::string line;
+    bool versionSeen = false;
+    while (std::getline(file, line)) {
+        double version = 0;
+        if (extractNumber(line, "format_version", version)) {
+            if (static_cast<int>(version) != kBaselineFormatVersion) {
+                error = "baseline format_version " + std::to_string(static_cast<int>(version)) +
+                        " is not supported (expected " + std::to_string(kBaselineFormatVersion) + ")";
+                return false;
+            }
+            versionSeen = true;
+            continue;
+        }
+        if (extractNumber(line, "puzzles_per_corpus", corpus.puzzles) || extractNumber(line, "seed", corpus.seed)) {
+            continue;
+        }
+
+        size_t namePos = line.find("\"name\":\"");
+        if (namePos == std::string::npos) continue;
+        namePos += 8;
+        BenchSummary summary;
+        summary.name = line.substr(namePos, line.find('"', namePos) - namePos);
+        extractEstimate(line, "puzzles_per_sec", summary.puzzlesPerSec);
+        extractEstimate(line, "p50_ms", summary.p50Ms);
+        extractEstimate(line, "p99_ms", summary.p99Ms);
+        baseline[summary.name] = summary;
+    }
+
+    if (!versionSeen) {
+        error = path + " has no format_version";
+        return false;
+    }
+    return true;
+}
+
+// ============================================================================
+// Comparison
+// ============================================================================
+
+enum class Verdict { OK, IMPROVED, REGRESSED, NOISY };
+
+// higherIsBetter: throughput; otherwise latency
+Verdict judge(const Estimate& base, const Estimate& current, double threshold, bool higherIsBetter) {
+    if (base.median <= 0) return Verdict::OK;
+    double change = (current.median - base.median) / base.median;
+    double worse = higherIsBetter ? -change : change;
+    bool separated = current.high < base.low || current.low > base.high;
+
+    if (worse > threshold) return separated ? Verdict::REGRESSED : Verdict::NOISY;
+    if (-worse > threshold && separated) return Verdict::IMPROVED;
+    return Verdict::OK;
+}
+
+const char* verdictLabel(Verdict verdict) {
+    switch (verdict) {
+        case Verdict::IMPROVED: return "improved";
+        case Verdict::REGRESSED: return "REGRESSED";
+        case Verdict::NOISY: return "noisy";
+        default: return "ok";
+    }
+}
+
+std::string formatEstimate(const Estimate& estimate) {
+    std::ostringstream out;
+    out << std::fixed << std::setprecision(3) << estimate.median
+        << " [" << estimate.low << ", " << estimate.high << "]";
+    return out.str();
+}
+
+bool compareRow(const std::string& name, const char* metric, const Estimate& base, const Estimate& current,
+                double threshold, bool higherIsBetter) {
+    Verdict verdict = judge(base, current, threshold, higherIsBetter);
+    double change = base.median > 0 ? 100.0 * (current.median - base.median) / base.median : 0.0;
+
+    std::cout << "  " << std::left << std::setw(40) << name << std::setw(16) << metric << std::right
+              << std::setw(34) << formatEstimate(base) << std::setw(34) << formatEstimate(current)
+              << std::setw(9) << std::fixed << std::setprecision(1) << change << "%  "
+              << verdictLabel(verdict) << "\n";
+    return verdict == Verdict::REGRESSED;
+}
+
+// ============================================================================
+// Benchmark definitions
+// ============================================================================
+
+std::vector<BenchCase> buildCases(const std::vector<BenchCorpus>& corpora,
+                                  const std::vector<std::string>& solverNames, bool includeApi,
+                                  std::vector<std::unique_ptr<SudokuSolver>>& solvers,
+                                  std::unique_ptr<SudokuJsonApi>& api,
+                                  std::vector<std::string>& customParams) {
+    std::vector<BenchCase> cases;
+
+    for (const std::string& solverName : solverNames) {
+        auto solver = SolverFactory::createSolver(solverName);
+        if (!solver) {
+            std::cerr << "⚠️  Unknown solver: " << solverName << "\n";
+            continue;
+        }
+        SudokuSolver* raw = solver.get();
+        solvers.push_back(std::move(solver));
+
+        for (const BenchCorpus& corpus : corpora) {
+            const BenchCorpus* corpusPtr = &corpus;
+            cases.push_back({"solver/" + solverName + "/" + corpus.name, static_cast<int>(corpus.puzzles.size()),
+                             [raw, corpusPtr](int item) {
+                                 Board board = corpusPtr->puzzles[item];
+                                 raw->solve(board);
+                             }});
+        }
+    }
+
+    if (includeApi) {
+        // In-process API path: parsing, solver reuse, solving and JSON serialisation
+        api = std::make_unique<SudokuJsonApi>();
+        SudokuJsonApi* apiPtr = api.get();
+
+        const BenchCorpus& medium = corpora[1];
+        for (const std::string& solverName : {std::string("backtrack"), std::string("constraint")}) {
+            size_t first = customParams.size();
+            for (const Board& puzzle : medium.puzzles) {
+                customParams.push_back(solverName + "|" + boardToArrayJson(puzzle));
+            }
+            const std::vector<std::string>* params = &customParams;
+            cases.push_back({"api/solve_custom_puzzle/" + solverName, static_cast<int>(medium.puzzles.size()),
+                             [apiPtr, params, first](int item) {
+                                 apiPtr->processCommand("solve_custom_puzzle", (*params)[first + item]);
+                             }});
+        }
+
+        cases.push_back({"api/get_board", 200, [apiPtr](int) { apiPtr->processCommand("get_board", ""); }});
+        cases.push_back({"api/get_status", 200, [apiPtr](int) { apiPtr->processCommand("get_status", ""); }});
+    }
+
+    return cases;
+}
+
+}
+
+int main(int argc, char* argv[]) {
+    int puzzles = 10;
+    int repetitions = 7;
+    unsigned int seed = 12345;
+    double thresholdPercent = 10.0;
+    bool includeApi = true;
+    std::string filter, savePath, comparePath;
+    std::vector<std::string> solverNames = {"backtrack", "constraint"};
+
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--puzzles" && i + 1 < argc) {
+            puzzles = std::max(1, std::atoi(argv[++i]));
+        } else if (arg == "--repetitions" && i + 1 < argc) {
+            repetitions = std::max(1, std::atoi(argv[++i]));
+        } else if (arg == "--seed" && i + 1 < argc) {
+            seed = static_cast<unsigned int>(std::strtoul(argv[++i], nullptr, 10));
+        } else if (arg == "--solvers" && i + 1 < argc) {
+            solverNames.clear();
+            std::istringstream iss(argv[++i]);
+            std::string token;
+            while (std::getline(iss, token, ',')) {
+                if (!token.empty()) solverNames.push_back(token);
+            }
+        } else if (arg == "--no-api") {
+            includeApi = false;
+        } else if (arg == "--filter" && i + 1 < argc) {
+            filter = argv[++i];
+        } else if (arg == "--save" && i + 1 < argc) {
+            savePath = argv[++i];
+        } else if (arg == "--compare" && i + 1 < argc) {
+            comparePath = argv[++i];
+        } else if (arg == "--threshold" && i + 1 < argc) {
+            thresholdPercent = std::atof(argv[++i]);
+        } else {
+            std::cerr << "Usage: sudoku_bench [--puzzles N] [--repetitions R] [--seed S] [--solvers a,b,...]\n"
+                      << "                    [--no-api] [--filter TEXT] [--save PATH] [--compare PATH]\n"
+                      << "                    [--threshold PERCENT]\n";
+            return 2;
+        }
+    }
+
+    // Load the baseline first so a bad path fails before minutes of benchmarking
+    std::map<std::string, BenchSummary> baseline;
+    if (!comparePath.empty()) {
+        std::string error;
+        BaselineCorpus corpus;
+        if (!loadBaseline(comparePath, baseline, corpus, error)) {
+            std::cerr << "❌ " << error << "\n";
+            return 2;
+        }
+        if (static_cast<int>(corpus.puzzles) != puzzles || static_cast<unsigned int>(corpus.seed) != seed) {
+            std::cerr << "❌ " << comparePath << " was recorded with --puzzles " << corpus.puzzles
+                      << " --seed " << corpus.seed << "; rerun with the same corpus\n";
+            return 2;
+        }
+    }
+
+    std::cout << "📏 Benchmarks: " << puzzles << " puzzles per corpus, " << repetitions
+              << " repetitions, seed " << seed << "\n";
+
+    std::vector<BenchCorpus> corpora = buildBenchCorpora(puzzles, seed);
+    std::vector<std::unique_ptr<SudokuSolver>> solvers;
+    std::unique_ptr<SudokuJsonApi> api;
+    std::vector<std::string> customParams;
+    std::vector<BenchCase> cases = buildCases(corpora, solverNames, includeApi, solvers, api, customParams);
+
+    std::vector<BenchSummary> summaries;
+    for (const BenchCase& bench : cases) {
+        if (!filter.empty() && bench.name.find(filter) == std::string::npos) continue;
+
+        BenchSummary summary = runBenchmark(bench, repetitions);
+        summaries.push_back(summary);
+        std::cout << "  " << std::left << std::setw(40) << summary.name << std::right
+                  << " puzzles/s " << std::setw(26) << formatEstimate(summary.puzzlesPerSec)
+                  << "  p99 ms " << std::setw(26) << formatEstimate(summary.p99Ms) << "\n";
+    }
+
+    if (!savePath.empty()) {
+        if (!saveBaseline(savePath, summaries, puzzles, repetitions, seed)) {
+            std::cerr << "❌ Cannot write baseline to " << savePath << "\n";
+            return 2;
+        }
+        std::cout << "💾 Baseline saved to " << savePath << "\n";
+    }
+
+    if (comparePath.empty()) {
+        return 0;
+    }
+
+    double threshold = thresholdPercent / 100.0;
+    int regressions = 0;
+    std::cout << "\n🔍 Comparison against " << comparePath << " (threshold " << thresholdPercent
+              << "%, " << static_cast<int>(kConfidenceLevel * 100) << "% CI of the median)\n";
+    for (const BenchSummary& current : summaries) {
+        auto it = baseline.find(current.name);
+        if (it == baseline.end()) {
+            std::cout << "  " << std::left << std::setw(40) << current.name << "not in baseline\n";
+            continue;
+        }
+        if (compareRow(current.name, "puzzles/s", it->second.puzzlesPerSec, current.puzzlesPerSec, threshold, true)) {
+            regressions++;
+        }
+        if (compareRow(current.name, "p99 ms", it->second.p99Ms, current.p99Ms, threshold, false)) {
+            regressions++;
+        }
+    }
+
+    if (regressions > 0) {
+        std::cout << "❌ " << regressions << " regression(s) beyond " << thresholdPercent << "%\n";
+        return 1;
+    }
+    std::cout << "✅ No regressions\n";
+    return 0;
+}
@@ -0,0 +1,294 @@
+/*
+Scripted replay benchmark for GameController
+Feeds a recorded command sequence through GameController::handleCommand with
+a NullView, so the full controller path (solver creation in solvePuzzle and
+enableStepByStepSolving, getNextAIMove, puzzle generation, move validation)
+is measured without a terminal, reproducibly, in CI. Each command's latency
+and heap allocations (global operator new) are recorded; the summary has one
+row per command with the median, p99 and mean time and the allocations and
+bytes per call. Calls that fail (a rejected move, a solve that gets stuck)
+are reported in a separate "<command> failed" row, so their timings never
+mix with those of calls that did the full work.
+
+solve, hint and hints use the trained model in models/ when run from the
+repository root; the untrained network often gets stuck before the board is
+complete, which shows up as "solve failed" rows.
+
+Scripts hold one command per line, written as at the console prompt:
+    load                    # '#' starts a comment
+    enable_ai
+    hint x20                # xN repeats the line N times
+    m 1 3 4                 # move: row col value (1-based, 0 clears)
+    solve
+    generate
+Without --script a built-in sequence covering every command is replayed.
+The generator is seeded, so every repetition does the same work.
+
+Usage: sudoku_controller_bench [--script PATH] [--repetitions R] [--seed S] [--verbose]
+*/
+
+#include "../controller/game_controller.h"
+#include "../solver/neuro_symbolic_solver.h"
+#include "../view/null_view.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <new>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace {
+
+std::atomic<uint64_t> gAllocations{0};
+std::atomic<uint64_t> gAllocatedBytes{0};
+
+}
+
+// Every allocation in the process is counted; the replay is the only work running
+void* operator new(std::size_t size) {
+    gAllocations.fetch_add(1, std::memory_order_relaxed);
+    gAllocatedBytes.fetch_add(size, std::memory_order_relaxed);
+    if (void* block = std::malloc(size == 0 ? 1 : size)) {
+        return block;
+    }
+    throw std::bad_alloc();
+}
+
+// Out of line, so GCC does not pair an inlined free() with a new-expression
+__attribute__((noinline)) void operator delete(void* block) noexcept {
+    std::free(block);
+}
+
+__attribute__((noinline)) void operator delete(void* block, std::size_t) noexcept {
+    std::free(block);
+}
+
+namespace {
+
+const char* const kDefaultScript =
+    "load\n"
+    "m 1 3 4\n"
+    "m 1 4 6\n"
+    "m 1 4 0\n"
+    "m 1 3 9\n"            // Breaks a rule: rejected
+    "enable_ai\n"
+    "hints\n"
+    "hint x10\n"
+    "solve\n"
+    "clear\n"
+    "generate\n"
+    "hint x10\n"
+    "solve\n"
+    "disable_ai\n"
+    "generate x3\n"
+    "help\n";
+
+// Console spellings -> the name a command is reported under
+const std::map<std::string, std::string> kCommandNames = {
+    {"m", "move"}, {"move", "move"},
+    {"g", "generate"}, {"generate", "generate"},
+    {"h", "help"}, {"help", "help"},
+    {"c", "clear"}, {"clear", "clear"},
+    {"l", "load"}, {"load", "load"},
+    {"s", "solve"}, {"solve", "solve"},
+    {"ai", "hint"}, {"hint", "hint"},
+    {"enable_ai", "enable_ai"}, {"enable", "enable_ai"},
+    {"disable_ai", "disable_ai"}, {"disable", "disable_ai"},
+    {"hints", "hints"}, {"possible", "hints"}
+};
+
+struct ScriptStep {
+    std::string command;   // As passed to handleCommand
+    std::string name;      // Reporting name
+    int row = 0, col = 0, value = 0;
+};
+
+struct CommandStats {
+    std::vector<double> micros;
+    uint64_t allocations = 0;
+    uint64_t bytes = 0;
+};
+
+bool parseScript(std::istream& in, std::vector<ScriptStep>& steps, std::string& error) {
+    std::string line;
+    int lineNumber = 0;
+    while (std::getline(in, line)) {
+        ++lineNumber;
+        line = line.substr(0, line.find('#'));
+        std::istringstream tokens(line);
+        std::vector<std::string> words;
+        std::string word;
+        while (tokens >> word) words.push_back(word);
+        if (words.empty()) continue;
+
+        int repeat = 1;
+        if (words.size() > 1 && words.back().size() > 1 && words.back()[0] == 'x') {
+            repeat = std::atoi(words.back().c_str() + 1);
+            words.pop_back();
+        }
+        auto name = kCommandNames.find(words[0]);
+        if (name == kCommandNames.end() || repeat < 1) {
+            error = "line " + std::to_string(lineNumber) + ": unknown command '" + line + "'";
+            return false;
+        }
+
+        ScriptStep step;
+        step.command = words[0];
+        step.name = name->second;
+        if (step.name == "move") {
+            if (words.size() != 4) {
+                error = "line " + std::to_string(lineNumber) + ": move needs row col value";
+                return false;
+            }
+            step.row = std::atoi(words[1].c_str());
+            step.col = std::atoi(words[2].c_str());
+            step.value = std::atoi(words[3].c_str());
+        } else if (words.size() != 1) {
+            error = "line " + std::to_string(lineNumber) + ": unexpected arguments";
+            return false;
+        }
+        steps.insert(steps.end(), repeat, step);
+    }
+    return true;
+}
+
+double percentile(std::vector<double> values, double fraction) {
+    if (values.empty()) return 0.0;
+    std::sort(values.begin(), values.end());
+    return values[static_cast<size_t>(fraction * (values.size() - 1) + 0.5)];
+}
+
+void printHeader() {
+    std::cout << std::left << std::setw(16) << "command" << std::right << std::setw(7) << "calls"
+              << std::setw(11) << "p50 us" << std::setw(11) << "p99 us"
+              << std::setw(11) << "mean us" << std::setw(11) << "allocs" << std::setw(11) << "KiB" << "\n";
+}
+
+void printRow(const std::string& name, const CommandStats& stats) {
+    size_t calls = stats.micros.size();
+    double total = 0.0;
+    for (double us : stats.micros) total += us;
+    double perCall = calls > 0 ? 1.0 / calls : 0.0;
+
+    std::cout << std::left << std::setw(16) << name << std::right << std::setw(7) << calls
+              << std::fixed << std::setprecision(1)
+              << std::setw(11) << percentile(stats.micros, 0.5)
+              << std::setw(11) << percentile(stats.micros, 0.99)
+              << std::setw(11) << total * perCall
+              << std::setw(11) << stats.allocations * perCall
+              << std::setw(11) << stats.bytes * perCall / 1024.0 << "\n";
+}
+
+}
+
+int main(int argc, char* argv[]) {
+    std::string scriptPath;
+    int repetitions = 5;
+    unsigned int seed = 12345;
+    bool verbose = false;
+
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--script" && i + 1 < argc) {
+            scriptPath = argv[++i];
+        } else if (arg == "--repetitions" && i + 1 < argc) {
+            repetitions = std::max(1, std::atoi(argv[++i]));
+        } else if (arg == "--seed" && i + 1 < argc) {
+            seed = static_cast<unsigned int>(std::strtoul(argv[++i], nullptr, 10));
+        } else if (arg == "--verbose") {
+            verbose = true;
+        } else {
+            std::cerr << "Usage: sudoku_controller_bench [--script PATH] [--repetitions R] [--seed S] [--verbose]\n";
+            return 2;
+        }
+    }
+
+    std::vector<ScriptStep> steps;
+    std::string error;
+    bool parsed;
+    if (scriptPath.empty()) {
+        std::istringstream script(kDefaultScript);
+        parsed = parseScript(script, steps, error);
+    } else {
+        std::ifstream script(scriptPath);
+        if (!script.is_open()) {
+            std::cerr << "❌ Cannot open script: " << scriptPath << "\n";
+            return 2;
+        }
+        parsed = parseScript(script, steps, error);
+    }
+    if (!parsed) {
+        std::cerr << "❌ " << (scriptPath.empty() ? "built-in script" : scriptPath) << " " << error << "\n";
+        return 2;
+    }
+
+    std::cout << "🎮 Controller replay: " << steps.size() << " commands from "
+              << (scriptPath.empty() ? "the built-in script" : scriptPath)
+              << ", " << repetitions << " repetitions, seed " << seed << "\n";
+    if (!std::ifstream(NeuroSymbolicSolver::modelPathFor(9)).good()) {
+        std::cout << "⚠️  No trained model at " << NeuroSymbolicSolver::modelPathFor(9)
+                  << ": solves run on the untrained network and mostly fail\n";
+    }
+
+    std::map<std::string, CommandStats> stats;
+    std::vector<std::string> order;   // Report in order of first appearance
+    CommandStats total;
+    long totalFailed = 0;
+
+    for (int rep = 0; rep < repetitions; ++rep) {
+        auto ownedView = std::make_unique<NullView>();
+        NullView& view = *ownedView;
+        GameController controller(std::move(ownedView));
+        controller.seedGenerator(seed);
+
+        for (size_t i = 0; i < steps.size(); ++i) {
+            const ScriptStep& step = steps[i];
+            if (step.name == "move") {
+                view.queueMove(step.row, step.col, step.value);
+            }
+            long errorsBefore = view.getErrorCount();
+            uint64_t allocationsBefore = gAllocations.load(std::memory_order_relaxed);
+            uint64_t bytesBefore = gAllocatedBytes.load(std::memory_order_relaxed);
+            std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+
+            bool handled = controller.handleCommand(step.command);
+
+            double micros = std::chrono::duration<double, std::micro>(
+                std::chrono::steady_clock::now() - start).count();
+            uint64_t allocations = gAllocations.load(std::memory_order_relaxed) - allocationsBefore;
+            uint64_t bytes = gAllocatedBytes.load(std::memory_order_relaxed) - bytesBefore;
+            bool failed = !handled || view.getErrorCount() != errorsBefore;
+
+            std::string row = failed ? step.name + " failed" : step.name;
+            if (stats.find(row) == stats.end()) order.push_back(row);
+            for (CommandStats* target : {&stats[row], &total}) {
+                target->micros.push_back(micros);
+                target->allocations += allocations;
+                target->bytes += bytes;
+            }
+            if (failed) totalFailed++;
+            if (verbose) {
+                std::cout << "  rep " << rep << " #" << i << " " << step.name << (failed ? " (failed)" : "")
+                          << " " << std::fixed << std::setprecision(1) << micros << " us, "
+                          << allocations << " allocs\n";
+            }
+        }
+    }
+
+    printHeader();
+    for (const std::string& name : order) {
+        printRow(name, stats[name]);
+    }
+    printRow("all", total);
+    if (totalFailed > 0) {
+        std::cout << totalFailed << " of " << total.micros.size() << " calls failed\n";
+    }
+    return 0;
+}
@@ -0,0 +1,160 @@
+/*
+Solver benchmark with hardware performance counters
+Solves a reproducible corpus per difficulty with each solver and reports wall
+time next to cycles, instructions, L1d/LLC misses and branch misses, so
+data-layout changes in Board or the solvers can be judged by what the CPU
+actually did rather than by wall time alone.
+
+Usage: sudoku_solver_bench [--solvers a,b,...] [--puzzles N] [--seed S] [--no-counters]
+*/
+
+#include "bench_corpus.h"
+#include "../solver/solver_factory.h"
+#include "../util/perf_counters.h"
+#include <algorithm>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace {
+
+struct CorpusResult {
+    int solved = 0;
+    int attempted = 0;
+    double totalMs = 0.0;
+    PerfSample counters;
+    bool countersSeen = false;
+};
+
+std::string formatCount(int64_t value, int puzzles) {
+    if (value < 0 || puzzles == 0) return "n/a";
+    std::ostringstream out;
+    out << std::fixed << std::setprecision(1) << (static_cast<double>(value) / puzzles / 1000.0) << "k";
+    return out.str();
+}
+
+std::string formatRatio(double value, int precision = 2) {
+    if (value < 0) return "n/a";
+    std::ostringstream out;
+    out << std::fixed << std::setprecision(precision) << value;
+    return out.str();
+}
+
+void printHeader() {
+    std::cout << std::left << std::setw(16) << "solver" << std::setw(8) << "corpus"
+              << std::right << std::setw(8) << "solved" << std::setw(11) << "ms/puzzle"
+              << std::setw(10) << "puzzle/s" << std::setw(12) << "cyc/puzzle"
+              << std::setw(12) << "ins/puzzle" << std::setw(6) << "IPC"
+              << std::setw(9) << "L1d/ki" << std::setw(9) << "LLC/ki" << std::setw(9) << "br/ki" << "\n";
+}
+
+void printRow(const std::string& solver, const std::string& corpus, const CorpusResult& result) {
+    double msPerPuzzle = result.attempted > 0 ? result.totalMs / result.attempted : 0.0;
+    double puzzlesPerSec = result.totalMs > 0 ? 1000.0 * result.attempted / result.totalMs : 0.0;
+    const PerfSample& c = result.counters;
+
+    std::cout << std::left << std::setw(16) << solver << std::setw(8) << corpus << std::right
+              << std::setw(8) << (std::to_string(result.solved) + "/" + std::to_string(result.attempted))
+              << std::setw(11) << formatRatio(msPerPuzzle, 3)
+              << std::setw(10) << formatRatio(puzzlesPerSec, 1)
+              << std::setw(12) << formatCount(c.cycles, result.attempted)
+              << std::setw(12) << formatCount(c.instructions, result.attempted)
+              << std::setw(6) << formatRatio(c.instructionsPerCycle())
+              << std::setw(9) << formatRatio(c.l1dMissesPerKiloInstruction())
+              << std::setw(9) << formatRatio(c.llcMissesPerKiloInstruction())
+              << std::setw(9) << formatRatio(c.branchMissesPerKiloInstruction()) << "\n";
+}
+
+CorpusResult runCorpus(SudokuSolver& solver, const BenchCorpus& corpus, bool counters) {
+    CorpusResult result;
+    solver.setCollectCounters(counters);
+
+    for (const Board& puzzle : corpus.puzzles) {
+        Board board = puzzle;
+        bool solved = solver.solve(board) && board.isComplete() && board.isValid();
+
+        result.attempted++;
+        if (solved) result.solved++;
+        result.totalMs += solver.getSolveTimeMs();
+
+        // Sum counters across the corpus; the first sample seeds the total
+        if (counters) {
+            if (!result.countersSeen) {
+                result.counters = solver.getSolveCounters();
+                result.countersSeen = true;
+            } else {
+                result.counters += solver.getSolveCounters();
+            }
+        }
+    }
+    return result;
+}
+
+}
+
+int main(int argc, char* argv[]) {
+    std::vector<std::string> solverNames = {"backtrack", "constraint", "neuro_symbolic"};
+    int puzzles = 10;
+    unsigned int seed = 12345;
+    bool counters = true;
+
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--solvers" && i + 1 < argc) {
+            solverNames.clear();
+            std::istringstream iss(argv[++i]);
+            std::string token;
+            while (std::getline(iss, token, ',')) {
+                if (!token.empty()) solverNames.push_back(token);
+            }
+        } else if (arg == "--puzzles" && i + 1 < argc) {
+            puzzles = std::max(1, std::atoi(argv[++i]));
+        } else if (arg == "--seed" && i + 1 < argc) {
+            seed = static_cast<unsigned int>(std::strtoul(argv[++i], nullptr, 10));
+        } else if (arg == "--no-counters") {
+            counters = false;
+        } else {
+            std::cerr << "Usage: sudoku_solver_bench [--solvers a,b,...] [--puzzles N] [--seed S] [--no-counters]\n";
+            return 1;
+        }
+    }
+
+    if (counters && !PerfCounters::forThread().isAvailable()) {
+        std::cerr << "⚠️  Hardware counters unavailable: " << PerfCounters::unavailableReason() << "\n";
+        counters = false;
+    }
+
+    std::cout << "🧮 Solver benchmark: " << puzzles << " puzzles per corpus, seed " << seed << "\n";
+    std::vector<BenchCorpus> corpora = buildBenchCorpora(puzzles, seed);
+
+    printHeader();
+    for (const std::string& name : solverNames) {
+        auto solver = SolverFactory::createSolver(name);
+        if (!solver) {
+            std::cerr << "⚠️  Unknown solver: " << name << "\n";
+            continue;
+        }
+
+        CorpusResult total;
+        for (const BenchCorpus& corpus : corpora) {
+            CorpusResult result = runCorpus(*solver, corpus, counters);
+            printRow(name, corpus.name, result);
+
+            total.solved += result.solved;
+            total.attempted += result.attempted;
+            total.totalMs += result.totalMs;
+            if (!total.countersSeen) {
+                total.counters = result.counters;
+                total.countersSeen = result.countersSeen;
+            } else {
+                total.counters += result.counters;
+            }
+        }
+        printRow(name, "all", total);
+    }
+
+    return 0;
+}
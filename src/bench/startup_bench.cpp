@@ -0,0 +1,167 @@
+/*
+Startup benchmark for the sudoku_api binary
+Measures cold-start latency the way the Flask bridge sees it (one process per
+request) and the in-process cost of constructing SudokuJsonApi and running a
+single command, so regressions in static initialisation or eager model
+loading show up immediately.
+
+Usage: sudoku_startup_bench [--api PATH] [--runs N] [--command NAME[:PARAMS]]...
+*/
+
+#include "../api/json_api.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <fcntl.h>
+#include <iomanip>
+#include <iostream>
+#include <spawn.h>
+#include <string>
+#include <sys/wait.h>
+#include <unistd.h>
+#include <vector>
+
+extern char** environ;
+
+namespace {
+
+struct BenchCommand {
+    std::string name;
+    std::string params;
+};
+
+struct LatencyStats {
+    double minMs;
+    double medianMs;
+    double p95Ms;
+    double meanMs;
+};
+
+LatencyStats summarize(std::vector<double> samples) {
+    std::sort(samples.begin(), samples.end());
+    double total = 0.0;
+    for (double sample : samples) total += sample;
+
+    size_t p95Index = std::min(samples.size() - 1, static_cast<size_t>(samples.size() * 0.95));
+    return {samples.front(), samples[samples.size() / 2], samples[p95Index], total / samples.size()};
+}
+
+void printStats(const std::string& label, const LatencyStats& stats) {
+    std::cout << "  " << std::left << std::setw(34) << label << std::right << std::fixed << std::setprecision(3)
+              << " min " << std::setw(8) << stats.minMs
+              << "  median " << std::setw(8) << stats.medianMs
+              << "  p95 " << std::setw(8) << stats.p95Ms
+              << "  mean " << std::setw(8) << stats.meanMs << " ms\n";
+}
+
+// Spawn the API binary once with stdout/stderr discarded; returns wall time or -1
+double runProcessOnce(const std::string& apiPath, const BenchCommand& command) {
+    posix_spawn_file_actions_t actions;
+    posix_spawn_file_actions_init(&actions);
+    posix_spawn_file_actions_addopen(&actions, STDOUT_FILENO, "/dev/null", O_WRONLY, 0);
+    posix_spawn_file_actions_addopen(&actions, STDERR_FILENO, "/dev/null", O_WRONLY, 0);
+
+    std::vector<char*> argv;
+    argv.push_back(const_cast<char*>(apiPath.c_str()));
+    argv.push_back(const_cast<char*>(command.name.c_str()));
+    if (!command.params.empty()) {
+        argv.push_back(const_cast<char*>(command.params.c_str()));
+    }
+    argv.push_back(nullptr);
+
+    auto start = std::chrono::high_resolution_clock::now();
+    pid_t pid;
+    int rc = posix_spawn(&pid, apiPath.c_str(), &actions, nullptr, argv.data(), environ);
+    posix_spawn_file_actions_destroy(&actions);
+    if (rc != 0) {
+        return -1.0;
+    }
+
+    int status = 0;
+    waitpid(pid, &status, 0);
+    auto end = std::chrono::high_resolution_clock::now();
+    return std::chrono::duration<double, std::milli>(end - start).count();
+}
+
+double runInProcessOnce(const BenchCommand& command) {
+    auto start = std::chrono::high_resolution_clock::now();
+    SudokuJsonApi api;
+    std::string response = api.processCommand(command.name, command.params);
+    auto end = std::chrono::high_resolution_clock::now();
+    return response.empty() ? -1.0 : std::chrono::duration<double, std::milli>(end - start).count();
+}
+
+}
+
+int main(int argc, char* argv[]) {
+    std::string apiPath = "build/bin/sudoku_api";
+    int runs = 20;
+    std::vector<BenchCommand> commands;
+
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--api" && i + 1 < argc) {
+            apiPath = argv[++i];
+        } else if (arg == "--runs" && i + 1 < argc) {
+            runs = std::max(1, std::atoi(argv[++i]));
+        } else if (arg == "--command" && i + 1 < argc) {
+            std::string spec = argv[++i];
+            size_t colon = spec.find(':');
+            if (colon == std::string::npos) {
+                commands.push_back({spec, ""});
+            } else {
+                commands.push_back({spec.substr(0, colon), spec.substr(colon + 1)});
+            }
+        } else {
+            std::cerr << "Usage: sudoku_startup_bench [--api PATH] [--runs N] [--command NAME[:PARAMS]]...\n";
+            return 1;
+        }
+    }
+
+    if (commands.empty()) {
+        // Read-only commands, so repeated runs do not change the saved game
+        commands = {
+            {"get_board", ""},
+            {"get_status", ""},
+            {"training_stats", ""},
+            {"get_ai_move", "backtrack"},
+            {"get_ai_move", "neuro_symbolic"}
+        };
+    }
+
+    bool haveBinary = access(apiPath.c_str(), X_OK) == 0;
+    if (!haveBinary) {
+        std::cerr << "⚠️  " << apiPath << " not found, skipping process-per-request runs\n";
+    }
+
+    std::cout << "🚀 sudoku_api startup benchmark (" << runs << " runs per command)\n";
+
+    for (const auto& command : commands) {
+        std::string label = command.name + (command.params.empty() ? "" : " " + command.params);
+        std::cout << label << "\n";
+
+        if (haveBinary) {
+            std::vector<double> samples;
+            for (int run = 0; run < runs; ++run) {
+                double ms = runProcessOnce(apiPath, command);
+                if (ms >= 0) samples.push_back(ms);
+            }
+            if (!samples.empty()) {
+                printStats("process spawn + exit", summarize(samples));
+            }
+        }
+
+        // In-process numbers isolate our own construction cost from exec/dynamic loading
+        std::vector<double> samples;
+        for (int run = 0; run < runs; ++run) {
+            double ms = runInProcessOnce(command);
+            if (ms >= 0) samples.push_back(ms);
+        }
+        if (!samples.empty()) {
+            printStats("in-process construct + command", summarize(samples));
+        }
+    }
+
+    return 0;
+}
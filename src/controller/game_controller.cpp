@@ -5,6 +5,13 @@ GameController implementation for coordinating game logic and UI.
 #include "game_controller.h"
 #include "../view/console_view.h"
 #include "../view/web_view.h"
+#include <chrono>
+
+namespace {
+// Solver steps between progress callbacks, and the fastest the view is redrawn
+constexpr int kProgressInterval = 8;
+constexpr std::chrono::milliseconds kProgressFrameInterval(30);
+}
 
 GameController::GameController(std::unique_ptr<SudokuView> view, int gridSize) 
     : board(gridSize), view(std::move(view)), moveCount(0), gameRunning(false), stepByStepMode(false) {}
@@ -267,17 +274,27 @@ bool GameController::solvePuzzle(SolverType solverType) {
     // Make a copy to solve
     Board solutionBoard = board;
     
-    // Solve the puzzle
-    bool solved = aiSolver->solve(solutionBoard);
+    // Solve the puzzle, letting the view animate the working board
+    SolveContext context;
+    context.progressInterval = kProgressInterval;
+    std::chrono::steady_clock::time_point lastFrame = std::chrono::steady_clock::now();
+    context.onProgress = [this, &lastFrame](const Board& working, int step) {
+        std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+        if (now - lastFrame >= kProgressFrameInterval) {
+            lastFrame = now;
+            view->showSolveProgress(working, step);
+        }
+    };
+    bool solved = aiSolver->solve(solutionBoard, context);
     
     if (solved) {
         // Update the board with solution
         board = solutionBoard;
-        moveCount += aiSolver->getMovesCount();
+        moveCount += context.movesCount;
         
         view->showSuccess("✨ Puzzle solved by " + aiSolver->getSolverName() + "!");
-        view->showMessage("📊 Solver used " + std::to_string(aiSolver->getMovesCount()) + " moves");
-        view->showMessage("⏱️  Solve time: " + std::to_string(aiSolver->getSolveTimeMs()) + " ms");
+        view->showMessage("📊 Solver used " + std::to_string(context.movesCount) + " moves");
+        view->showMessage("⏱️  Solve time: " + std::to_string(context.solveTimeMs) + " ms");
         
         checkGameState(); // Check if game is won
         return true;
@@ -33,6 +33,9 @@ public:
     void generateNewPuzzle(SudokuGenerator::Difficulty difficulty = SudokuGenerator::MEDIUM);
     void clearBoard();
     
+    // Makes generated puzzles reproducible (scripted replays, benchmarks)
+    void seedGenerator(unsigned int seed) { generator = SudokuGenerator(seed); }
+    
     // AI Solver integration
     bool solvePuzzle(SolverType solverType = SolverType::BACKTRACK);
     bool getNextAIMove();
@@ -0,0 +1,532 @@
+/*
+Compressed puzzle corpus implementation
+The entropy coder is the classic LZMA-style binary range coder with 11-bit
+adaptive probabilities; every block starts from a fresh model.
+*/
+
+#include "corpus_format.h"
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <unistd.h>
+
+namespace {
+
+const char kMagic[4] = {'S', 'D', 'K', 'C'};
+const uint16_t kVersion = 1;
+const size_t kHeaderSize = 64;
+
+// ========== Range coder ==========
+
+const int kProbBits = 11;
+const uint16_t kProbInit = 1 << (kProbBits - 1);
+const int kMoveBits = 5;
+const uint32_t kTopValue = 1u << 24;
+
+class RangeEncoder {
+public:
+    explicit RangeEncoder(std::string& out)
+        : out(out), low(0), range(0xFFFFFFFFu), cache(0), cacheSize(1) {}
+
+    void encodeBit(uint16_t& prob, int bit) {
+        uint32_t bound = (range >> kProbBits) * prob;
+        if (bit == 0) {
+            range = bound;
+            prob += ((1 << kProbBits) - prob) >> kMoveBits;
+        } else {
+            low += bound;
+            range -= bound;
+            prob -= prob >> kMoveBits;
+        }
+        while (range < kTopValue) {
+            range <<= 8;
+            shiftLow();
+        }
+    }
+
+    void flush() {
+        for (int i = 0; i < 5; ++i) {
+            shiftLow();
+        }
+    }
+
+private:
+    std::string& out;
+    uint64_t low;
+    uint32_t range;
+    uint8_t cache;
+    uint64_t cacheSize;
+
+    void shiftLow() {
+        if (static_cast<uint32_t>(low) < 0xFF000000u || (low >> 32) != 0) {
+            uint8_t carry = static_cast<uint8_t>(low >> 32);
+            uint8_t pending = cache;
+            do {
+                out.push_back(static_cast<char>(static_cast<uint8_t>(pending + carry)));
+                pending = 0xFF;
+            } while (--cacheSize != 0);
+            cache = static_cast<uint8_t>(low >> 24);
+        }
+        cacheSize++;
+        low = (low & 0x00FFFFFFu) << 8;
+    }
+};
+
+class RangeDecoder {
+public:
+    RangeDecoder(const unsigned char* data, size_t length)
+        : data(data), end(data + length), range(0xFFFFFFFFu), code(0) {
+        for (int i = 0; i < 5; ++i) {
+            code = (code << 8) | nextByte();
+        }
+    }
+
+    int decodeBit(uint16_t& prob) {
+        uint32_t bound = (range >> kProbBits) * prob;
+        int bit;
+        if (code < bound) {
+            range = bound;
+            prob += ((1 << kProbBits) - prob) >> kMoveBits;
+            bit = 0;
+        } else {
+            code -= bound;
+            range -= bound;
+            prob -= prob >> kMoveBits;
+            bit = 1;
+        }
+        while (range < kTopValue) {
+            range <<= 8;
+            code = (code << 8) | nextByte();
+        }
+        return bit;
+    }
+
+private:
+    const unsigned char* data;
+    const unsigned char* end;
+    uint32_t range;
+    uint32_t code;
+
+    // Past the end reads as zeros; corruption shows up as impossible digits
+    uint32_t nextByte() { return data < end ? *data++ : 0; }
+};
+
+// ========== Puzzle model ==========
+
+// Adaptive probabilities for one block
+class PuzzleModel {
+public:
+    PuzzleModel(int boardSize)
+        : size(boardSize), cellCount(static_cast<size_t>(boardSize) * boardSize),
+          boxSide(boardSize == 4 ? 2 : 3),
+          bitmapProbs(cellCount * 3, kProbInit), digitProbs(10 * 16, kProbInit) {}
+
+    void encode(RangeEncoder& encoder, const char* cells) {
+        for (size_t i = 0; i < cellCount; ++i) {
+            encoder.encodeBit(bitmapProb(cells, i), cells[i] != '0');
+        }
+        resetMasks();
+        for (size_t i = 0; i < cellCount; ++i) {
+            if (cells[i] == '0') continue;
+            int digit = cells[i] - '0';
+            uint16_t allowed = allowedAt(i);
+            int candidates = popcount(allowed);
+            uint16_t below = static_cast<uint16_t>((1u << digit) - 1);
+            int rank = (allowed >> digit) & 1
+                ? popcount(allowed & below)
+                : candidates + popcount(static_cast<uint16_t>(~allowed & fullMask() & below));
+            uint16_t* probs = &digitProbs[candidates * 16];
+            int node = 1;
+            for (int bit = 3; bit >= 0; --bit) {
+                int value = (rank >> bit) & 1;
+                encoder.encodeBit(probs[node], value);
+                node = node * 2 + value;
+            }
+            place(i, digit);
+        }
+    }
+
+    bool decode(RangeDecoder& decoder, char* cells) {
+        for (size_t i = 0; i < cellCount; ++i) {
+            cells[i] = decoder.decodeBit(bitmapProb(cells, i)) ? '1' : '0';
+        }
+        resetMasks();
+        for (size_t i = 0; i < cellCount; ++i) {
+            if (cells[i] == '0') continue;
+            uint16_t allowed = allowedAt(i);
+            int candidates = popcount(allowed);
+            uint16_t* probs = &digitProbs[candidates * 16];
+            int node = 1;
+            for (int bit = 0; bit < 4; ++bit) {
+                node = node * 2 + decoder.decodeBit(probs[node]);
+            }
+            int rank = node - 16;
+            int digit = rank < candidates
+                ? nthSetBit(allowed, rank)
+                : nthSetBit(static_cast<uint16_t>(~allowed & fullMask()), rank - candidates);
+            if (digit <= 0) {
+                return false;
+            }
+            cells[i] = static_cast<char>('0' + digit);
+            place(i, digit);
+        }
+        return true;
+    }
+
+private:
+    int size;
+    size_t cellCount;
+    int boxSide;
+    std::vector<uint16_t> bitmapProbs;   // [cell][partner blank, partner given, partner not yet coded]
+    std::vector<uint16_t> digitProbs;    // [candidate count][bit-tree node]
+    uint16_t rowMasks[9];
+    uint16_t colMasks[9];
+    uint16_t boxMasks[9];
+
+    uint16_t& bitmapProb(const char* cells, size_t cell) {
+        size_t partner = cellCount - 1 - cell;
+        int context = partner < cell ? (cells[partner] != '0') : 2;
+        return bitmapProbs[cell * 3 + context];
+    }
+
+    uint16_t fullMask() const { return static_cast<uint16_t>(((1u << (size + 1)) - 1) & ~1u); }
+
+    void resetMasks() {
+        std::fill(rowMasks, rowMasks + 9, 0);
+        std::fill(colMasks, colMasks + 9, 0);
+        std::fill(boxMasks, boxMasks + 9, 0);
+    }
+
+    int boxOf(int row, int col) const { return (row / boxSide) * boxSide + col / boxSide; }
+
+    uint16_t allowedAt(size_t cell) const {
+        int row = static_cast<int>(cell) / size;
+        int col = static_cast<int>(cell) % size;
+        uint16_t used = rowMasks[row] | colMasks[col] | boxMasks[boxOf(row, col)];
+        return static_cast<uint16_t>(~used & fullMask());
+    }
+
+    void place(size_t cell, int digit) {
+        int row = static_cast<int>(cell) / size;
+        int col = static_cast<int>(cell) % size;
+        uint16_t bit = static_cast<uint16_t>(1u << digit);
+        rowMasks[row] |= bit;
+        colMasks[col] |= bit;
+        boxMasks[boxOf(row, col)] |= bit;
+    }
+
+    static int popcount(uint16_t mask) { return __builtin_popcount(mask); }
+
+    // Digit of the n-th set bit (0-based), or 0 if there is none
+    static int nthSetBit(uint16_t mask, int n) {
+        for (int digit = 1; digit < 16; ++digit) {
+            if ((mask >> digit) & 1) {
+                if (n-- == 0) return digit;
+            }
+        }
+        return 0;
+    }
+};
+
+// ========== Header encoding ==========
+
+void putU16(unsigned char* at, uint16_t value) {
+    for (int i = 0; i < 2; ++i) at[i] = static_cast<unsigned char>(value >> (8 * i));
+}
+
+void putU32(unsigned char* at, uint32_t value) {
+    for (int i = 0; i < 4; ++i) at[i] = static_cast<unsigned char>(value >> (8 * i));
+}
+
+void putU64(unsigned char* at, uint64_t value) {
+    for (int i = 0; i < 8; ++i) at[i] = static_cast<unsigned char>(value >> (8 * i));
+}
+
+uint64_t getLE(const unsigned char* at, int bytes) {
+    uint64_t value = 0;
+    for (int i = bytes - 1; i >= 0; --i) value = (value << 8) | at[i];
+    return value;
+}
+
+void encodeHeader(const CorpusHeader& header, unsigned char* out) {
+    std::memset(out, 0, kHeaderSize);
+    std::memcpy(out, kMagic, 4);
+    putU16(out + 4, kVersion);
+    out[6] = static_cast<unsigned char>(header.boardSize);
+    putU32(out + 8, header.blockSize);
+    putU32(out + 12, header.blockCount);
+    putU64(out + 16, header.puzzleCount);
+    putU64(out + 24, header.indexOffset);
+    for (int i = 0; i < kCorpusDifficultyCount; ++i) {
+        putU64(out + 32 + 8 * i, header.difficultyHistogram[i]);
+    }
+}
+
+bool decodeHeader(const unsigned char* in, CorpusHeader& header, std::string& error) {
+    if (std::memcmp(in, kMagic, 4) != 0) {
+        error = "not a puzzle corpus";
+        return false;
+    }
+    uint16_t version = static_cast<uint16_t>(getLE(in + 4, 2));
+    if (version != kVersion) {
+        error = "unsupported corpus version " + std::to_string(version);
+        return false;
+    }
+    header.boardSize = in[6];
+    header.blockSize = static_cast<uint32_t>(getLE(in + 8, 4));
+    header.blockCount = static_cast<uint32_t>(getLE(in + 12, 4));
+    header.puzzleCount = getLE(in + 16, 8);
+    header.indexOffset = getLE(in + 24, 8);
+    for (int i = 0; i < kCorpusDifficultyCount; ++i) {
+        header.difficultyHistogram[i] = getLE(in + 32 + 8 * i, 8);
+    }
+
+    bool sizeOk = header.boardSize == 4 || header.boardSize == 9 ||
+                  (header.boardSize == 0 && header.puzzleCount == 0);
+    uint64_t expectedBlocks = header.blockSize == 0 ? 0
+        : (header.puzzleCount + header.blockSize - 1) / header.blockSize;
+    if (!sizeOk || header.blockSize == 0 || expectedBlocks != header.blockCount) {
+        error = "corrupt corpus header";
+        return false;
+    }
+    return true;
+}
+
+bool validCells(const std::string& cells, int boardSize) {
+    for (char c : cells) {
+        if (c < '0' || c > '0' + boardSize) return false;
+    }
+    return true;
+}
+
+}
+
+// ========== Difficulty ==========
+
+const char* corpusDifficultyName(int difficulty) {
+    static const char* names[] = {"easy", "medium", "hard", "expert"};
+    return difficulty >= 0 && difficulty < kCorpusDifficultyCount ? names[difficulty] : "unknown";
+}
+
+// Blank counts halfway between SudokuGenerator's EASY/MEDIUM/HARD/EXPERT
+// targets (30/40/50/55 of 81), scaled for smaller boards
+CorpusDifficulty corpusDifficultyForCells(const std::string& cells) {
+    size_t blanks = static_cast<size_t>(std::count(cells.begin(), cells.end(), '0'));
+    double blankShare = cells.empty() ? 0.0 : static_cast<double>(blanks) * 81.0 / cells.size();
+    if (blankShare < 35.0) return CorpusDifficulty::EASY;
+    if (blankShare < 45.0) return CorpusDifficulty::MEDIUM;
+    if (blankShare < 52.5) return CorpusDifficulty::HARD;
+    return CorpusDifficulty::EXPERT;
+}
+
+bool isCorpusFile(const std::string& path) {
+    FILE* file = std::fopen(path.c_str(), "rb");
+    if (!file) return false;
+    char magic[4];
+    bool match = std::fread(magic, 1, 4, file) == 4 && std::memcmp(magic, kMagic, 4) == 0;
+    std::fclose(file);
+    return match;
+}
+
+// ========== CorpusWriter ==========
+
+CorpusWriter::CorpusWriter(uint32_t blockSize)
+    : file(nullptr), pendingCount(0), offset(0) {
+    header.blockSize = std::max<uint32_t>(1, blockSize);
+}
+
+CorpusWriter::~CorpusWriter() {
+    // An unfinished corpus keeps its zeroed header, so it is never mistaken for a valid one
+    if (file) {
+        std::fclose(file);
+    }
+}
+
+bool CorpusWriter::open(const std::string& path, std::string& error) {
+    this->path = path;
+    file = std::fopen(path.c_str(), "wb");
+    if (!file) {
+        error = path + ": " + std::strerror(errno);
+        return false;
+    }
+    unsigned char placeholder[kHeaderSize] = {};
+    if (std::fwrite(placeholder, 1, kHeaderSize, file) != kHeaderSize) {
+        error = path + ": " + std::strerror(errno);
+        return false;
+    }
+    offset = kHeaderSize;
+    return true;
+}
+
+bool CorpusWriter::add(const std::string& cells, std::string& error) {
+    int boardSize = cells.size() == 81 ? 9 : cells.size() == 16 ? 4 : 0;
+    if (boardSize == 0 || !validCells(cells, boardSize)) {
+        error = "not a normalised 4x4 or 9x9 puzzle";
+        return false;
+    }
+    if (header.boardSize == 0) {
+        header.boardSize = boardSize;
+    } else if (header.boardSize != boardSize) {
+        error = "corpus holds " + std::to_string(header.boardSize) + "x" + std::to_string(header.boardSize) +
+                " puzzles, got " + std::to_string(boardSize) + "x" + std::to_string(boardSize);
+        return false;
+    }
+
+    pendingCells += cells;
+    pendingCount++;
+    header.puzzleCount++;
+    header.difficultyHistogram[static_cast<int>(corpusDifficultyForCells(cells))]++;
+    return pendingCount < header.blockSize || flushBlock(error);
+}
+
+bool CorpusWriter::flushBlock(std::string& error) {
+    if (pendingCount == 0) {
+        return true;
+    }
+    std::string compressed;
+    compressed.reserve(pendingCells.size() / 4);
+    RangeEncoder encoder(compressed);
+    PuzzleModel model(header.boardSize);
+    size_t cellCount = static_cast<size_t>(header.boardSize) * header.boardSize;
+    for (uint32_t i = 0; i < pendingCount; ++i) {
+        model.encode(encoder, pendingCells.data() + i * cellCount);
+    }
+    encoder.flush();
+
+    if (std::fwrite(compressed.data(), 1, compressed.size(), file) != compressed.size()) {
+        error = path + ": " + std::strerror(errno);
+        return false;
+    }
+    blockOffsets.push_back(offset);
+    offset += compressed.size();
+    header.blockCount++;
+    pendingCells.clear();
+    pendingCount = 0;
+    return true;
+}
+
+bool CorpusWriter::close(std::string& error) {
+    if (!file) {
+        error = "corpus not open";
+        return false;
+    }
+    if (!flushBlock(error)) {
+        return false;
+    }
+
+    header.indexOffset = offset;
+    std::vector<unsigned char> index(blockOffsets.size() * 8);
+    for (size_t i = 0; i < blockOffsets.size(); ++i) {
+        putU64(&index[i * 8], blockOffsets[i]);
+    }
+    unsigned char encoded[kHeaderSize];
+    encodeHeader(header, encoded);
+
+    bool ok = std::fwrite(index.data(), 1, index.size(), file) == index.size() &&
+              std::fseek(file, 0, SEEK_SET) == 0 &&
+              std::fwrite(encoded, 1, kHeaderSize, file) == kHeaderSize;
+    ok = std::fclose(file) == 0 && ok;
+    file = nullptr;
+    if (!ok) {
+        error = path + ": " + std::strerror(errno);
+    }
+    return ok;
+}
+
+// ========== CorpusFile ==========
+
+CorpusFile::CorpusFile() : fd(-1), cachedBlock(-1) {}
+
+CorpusFile::~CorpusFile() {
+    if (fd >= 0) {
+        close(fd);
+    }
+}
+
+bool CorpusFile::open(const std::string& path, std::string& error) {
+    this->path = path;
+    fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        error = path + ": " + std::strerror(errno);
+        return false;
+    }
+
+    unsigned char encoded[kHeaderSize];
+    if (pread(fd, encoded, kHeaderSize, 0) != static_cast<ssize_t>(kHeaderSize)) {
+        error = path + ": not a puzzle corpus";
+        return false;
+    }
+    if (!decodeHeader(encoded, header, error)) {
+        error = path + ": " + error;
+        return false;
+    }
+
+    std::vector<unsigned char> index(static_cast<size_t>(header.blockCount) * 8);
+    if (!index.empty() &&
+        pread(fd, index.data(), index.size(), static_cast<off_t>(header.indexOffset)) !=
+            static_cast<ssize_t>(index.size())) {
+        error = path + ": truncated block index";
+        return false;
+    }
+    blockOffsets.resize(header.blockCount);
+    for (uint32_t i = 0; i < header.blockCount; ++i) {
+        blockOffsets[i] = getLE(&index[i * 8], 8);
+        uint64_t previous = i == 0 ? kHeaderSize : blockOffsets[i - 1];
+        if (blockOffsets[i] < previous || blockOffsets[i] > header.indexOffset) {
+            error = path + ": corrupt block index";
+            return false;
+        }
+    }
+    return true;
+}
+
+bool CorpusFile::readBlock(uint32_t block, std::string& cells, std::string& error) {
+    if (block >= header.blockCount) {
+        error = "block " + std::to_string(block) + " out of range";
+        return false;
+    }
+    uint64_t start = blockOffsets[block];
+    uint64_t end = block + 1 < header.blockCount ? blockOffsets[block + 1] : header.indexOffset;
+    compressed.resize(static_cast<size_t>(end - start));
+    if (!compressed.empty() &&
+        pread(fd, &compressed[0], compressed.size(), static_cast<off_t>(start)) !=
+            static_cast<ssize_t>(compressed.size())) {
+        error = path + ": truncated block " + std::to_string(block);
+        return false;
+    }
+
+    uint64_t first = static_cast<uint64_t>(block) * header.blockSize;
+    size_t count = static_cast<size_t>(std::min<uint64_t>(header.blockSize, header.puzzleCount - first));
+    size_t cellCount = cellsPerPuzzle();
+    cells.resize(count * cellCount);
+
+    RangeDecoder decoder(reinterpret_cast<const unsigned char*>(compressed.data()), compressed.size());
+    PuzzleModel model(header.boardSize);
+    for (size_t i = 0; i < count; ++i) {
+        if (!model.decode(decoder, &cells[i * cellCount])) {
+            error = path + ": corrupt block " + std::to_string(block);
+            return false;
+        }
+    }
+    return true;
+}
+
+bool CorpusFile::getPuzzle(uint64_t index, std::string& cells, std::string& error) {
+    if (index >= header.puzzleCount) {
+        error = "puzzle " + std::to_string(index) + " out of range (corpus has " +
+                std::to_string(header.puzzleCount) + ")";
+        return false;
+    }
+    long block = static_cast<long>(index / header.blockSize);
+    if (block != cachedBlock) {
+        cachedBlock = -1;
+        if (!readBlock(static_cast<uint32_t>(block), cachedCells, error)) {
+            return false;
+        }
+        cachedBlock = block;
+    }
+    size_t cellCount = cellsPerPuzzle();
+    cells.assign(cachedCells, static_cast<size_t>(index % header.blockSize) * cellCount, cellCount);
+    return true;
+}
@@ -0,0 +1,112 @@
+/*
+Compressed puzzle corpus (.sdkc)
+A seekable container for large puzzle collections. Puzzles are grouped into
+fixed-size blocks; each block is one range-coded stream holding, per puzzle,
+the givens bitmap followed by the given digits. Both are modelled adaptively:
+bitmap bits by cell position and the 180-degree partner cell (most published
+puzzles are symmetric), digits by their rank among the values still allowed
+by earlier givens in the same row, column and box. Blocks are independent, so
+puzzle i is found through the block index without touching other blocks.
+
+Layout (little-endian):
+  header   64 bytes  magic "SDKC", version, board size, puzzles per block,
+                     block count, puzzle count, index offset and a
+                     difficulty histogram (easy/medium/hard/expert by blanks)
+  blocks   ...       compressed block streams, back to back
+  index    8 bytes per block: file offset of the block
+
+Puzzles go in and come out as normalised cell strings (see puzzle_format.h).
+*/
+
+#ifndef SUDOKU_IO_CORPUS_FORMAT_H
+#define SUDOKU_IO_CORPUS_FORMAT_H
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+// Difficulty bands used by the header histogram, matching SudokuGenerator's levels
+enum class CorpusDifficulty { EASY = 0, MEDIUM, HARD, EXPERT };
+const int kCorpusDifficultyCount = 4;
+const char* corpusDifficultyName(int difficulty);
+CorpusDifficulty corpusDifficultyForCells(const std::string& cells);
+
+struct CorpusHeader {
+    int boardSize = 0;
+    uint32_t blockSize = 0;          // Puzzles per block (the last block may hold fewer)
+    uint32_t blockCount = 0;
+    uint64_t puzzleCount = 0;
+    uint64_t indexOffset = 0;
+    std::array<uint64_t, kCorpusDifficultyCount> difficultyHistogram{};
+};
+
+// True when the file starts with the corpus magic
+bool isCorpusFile(const std::string& path);
+
+class CorpusWriter {
+public:
+    static const uint32_t kDefaultBlockSize = 1024;
+
+    explicit CorpusWriter(uint32_t blockSize = kDefaultBlockSize);
+    ~CorpusWriter();
+
+    CorpusWriter(const CorpusWriter&) = delete;
+    CorpusWriter& operator=(const CorpusWriter&) = delete;
+
+    bool open(const std::string& path, std::string& error);
+
+    // Adds one puzzle; every puzzle in a corpus must have the same board size
+    bool add(const std::string& cells, std::string& error);
+
+    // Flushes the last block, writes the index and the final header
+    bool close(std::string& error);
+
+    const CorpusHeader& getHeader() const { return header; }
+
+private:
+    FILE* file;
+    std::string path;
+    CorpusHeader header;
+    std::string pendingCells;        // Puzzles of the block being filled, back to back
+    uint32_t pendingCount;
+    std::vector<uint64_t> blockOffsets;
+    uint64_t offset;
+
+    bool flushBlock(std::string& error);
+};
+
+class CorpusFile {
+public:
+    CorpusFile();
+    ~CorpusFile();
+
+    CorpusFile(const CorpusFile&) = delete;
+    CorpusFile& operator=(const CorpusFile&) = delete;
+
+    // Reads the header and the block index
+    bool open(const std::string& path, std::string& error);
+
+    const CorpusHeader& getHeader() const { return header; }
+    uint64_t size() const { return header.puzzleCount; }
+    size_t cellsPerPuzzle() const { return static_cast<size_t>(header.boardSize) * header.boardSize; }
+
+    // Decodes a whole block: cellsPerPuzzle() characters per puzzle, back to back
+    bool readBlock(uint32_t block, std::string& cells, std::string& error);
+
+    // Puzzle i; decodes (and caches) only the block that holds it
+    bool getPuzzle(uint64_t index, std::string& cells, std::string& error);
+
+private:
+    int fd;
+    std::string path;
+    CorpusHeader header;
+    std::vector<uint64_t> blockOffsets;
+    std::string compressed;          // Scratch for the block being decoded
+    std::string cachedCells;
+    long cachedBlock;
+};
+
+#endif // SUDOKU_IO_CORPUS_FORMAT_H
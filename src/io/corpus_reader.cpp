@@ -0,0 +1,493 @@
+/*
+Bulk corpus reader implementation
+io_uring is driven through the raw syscalls and the mmapped SQ/CQ rings, so
+there is no liburing dependency; if io_uring_setup() is unavailable (old
+kernel, seccomp, container policy) the same loop runs on synchronous pread().
+*/
+
+#include "corpus_reader.h"
+#include "../util/logger.h"
+#include <algorithm>
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+#include <fcntl.h>
+#include <linux/io_uring.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+namespace {
+
+const size_t kPageSize = 4096;
+
+size_t roundUpToPage(size_t bytes) {
+    return (bytes + kPageSize - 1) / kPageSize * kPageSize;
+}
+
+std::string errnoText(int code) {
+    return std::strerror(code);
+}
+
+}
+
+// ========== io_uring ==========
+
+class CorpusReader::Uring {
+public:
+    static std::unique_ptr<Uring> create(unsigned entries, std::string& reason) {
+        std::unique_ptr<Uring> ring(new Uring());
+        if (!ring->setup(entries, reason)) {
+            return nullptr;
+        }
+        return ring;
+    }
+
+    ~Uring() {
+        if (sqes != MAP_FAILED) munmap(sqes, sqesSize);
+        if (cqRing != MAP_FAILED && cqRing != sqRing) munmap(cqRing, cqRingSize);
+        if (sqRing != MAP_FAILED) munmap(sqRing, sqRingSize);
+        if (ringFd >= 0) close(ringFd);
+    }
+
+    // Queues a read; the caller never has more reads outstanding than entries
+    void queueRead(int fd, char* data, unsigned length, uint64_t offset, uint64_t tag) {
+        unsigned tail = *sqTail;
+        unsigned index = tail & *sqMask;
+        io_uring_sqe& sqe = sqes[index];
+        std::memset(&sqe, 0, sizeof(sqe));
+        sqe.opcode = IORING_OP_READ;
+        sqe.fd = fd;
+        sqe.addr = reinterpret_cast<uint64_t>(data);
+        sqe.len = length;
+        sqe.off = offset;
+        sqe.user_data = tag;
+        sqArray[index] = index;
+        __atomic_store_n(sqTail, tail + 1, __ATOMIC_RELEASE);
+        unsubmitted++;
+    }
+
+    // Submits queued reads and optionally blocks until `waitFor` complete
+    bool enter(unsigned waitFor, std::string& error) {
+        while (unsubmitted > 0 || waitFor > 0) {
+            long result = syscall(__NR_io_uring_enter, ringFd, unsubmitted, waitFor,
+                                  waitFor > 0 ? IORING_ENTER_GETEVENTS : 0u, nullptr, 0);
+            if (result < 0) {
+                if (errno == EINTR) continue;
+                error = "io_uring_enter: " + errnoText(errno);
+                return false;
+            }
+            unsubmitted -= static_cast<unsigned>(result);
+            waitFor = 0;
+        }
+        return true;
+    }
+
+    // Calls handler(tag, result) for each completion already posted
+    template <typename Handler>
+    void reap(Handler handler) {
+        unsigned head = *cqHead;
+        unsigned tail = __atomic_load_n(cqTail, __ATOMIC_ACQUIRE);
+        for (; head != tail; ++head) {
+            const io_uring_cqe& cqe = cqes[head & *cqMask];
+            handler(cqe.user_data, cqe.res);
+        }
+        __atomic_store_n(cqHead, head, __ATOMIC_RELEASE);
+    }
+
+private:
+    int ringFd = -1;
+    void* sqRing = MAP_FAILED;
+    void* cqRing = MAP_FAILED;
+    io_uring_sqe* sqes = static_cast<io_uring_sqe*>(MAP_FAILED);
+    size_t sqRingSize = 0;
+    size_t cqRingSize = 0;
+    size_t sqesSize = 0;
+    unsigned* sqTail = nullptr;
+    unsigned* sqMask = nullptr;
+    unsigned* sqArray = nullptr;
+    unsigned* cqHead = nullptr;
+    unsigned* cqTail = nullptr;
+    unsigned* cqMask = nullptr;
+    io_uring_cqe* cqes = nullptr;
+    unsigned unsubmitted = 0;
+
+    Uring() = default;
+
+    bool setup(unsigned entries, std::string& reason) {
+        io_uring_params params;
+        std::memset(&params, 0, sizeof(params));
+        ringFd = static_cast<int>(syscall(__NR_io_uring_setup, entries, &params));
+        if (ringFd < 0) {
+            reason = "io_uring_setup: " + errnoText(errno);
+            return false;
+        }
+
+        sqRingSize = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+        cqRingSize = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+        bool singleMmap = (params.features & IORING_FEAT_SINGLE_MMAP) != 0;
+        if (singleMmap) {
+            sqRingSize = cqRingSize = std::max(sqRingSize, cqRingSize);
+        }
+
+        sqRing = mmap(nullptr, sqRingSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+                      ringFd, IORING_OFF_SQ_RING);
+        if (sqRing == MAP_FAILED) {
+            reason = "mmap SQ ring: " + errnoText(errno);
+            return false;
+        }
+        cqRing = singleMmap ? sqRing
+                            : mmap(nullptr, cqRingSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+                                   ringFd, IORING_OFF_CQ_RING);
+        if (cqRing == MAP_FAILED) {
+            reason = "mmap CQ ring: " + errnoText(errno);
+            return false;
+        }
+        sqesSize = params.sq_entries * sizeof(io_uring_sqe);
+        sqes = static_cast<io_uring_sqe*>(mmap(nullptr, sqesSize, PROT_READ | PROT_WRITE,
+                                               MAP_SHARED | MAP_POPULATE, ringFd, IORING_OFF_SQES));
+        if (sqes == MAP_FAILED) {
+            reason = "mmap SQEs: " + errnoText(errno);
+            return false;
+        }
+
+        char* sq = static_cast<char*>(sqRing);
+        char* cq = static_cast<char*>(cqRing);
+        sqTail = reinterpret_cast<unsigned*>(sq + params.sq_off.tail);
+        sqMask = reinterpret_cast<unsigned*>(sq + params.sq_off.ring_mask);
+        sqArray = reinterpret_cast<unsigned*>(sq + params.sq_off.array);
+        cqHead = reinterpret_cast<unsigned*>(cq + params.cq_off.head);
+        cqTail = reinterpret_cast<unsigned*>(cq + params.cq_off.tail);
+        cqMask = reinterpret_cast<unsigned*>(cq + params.cq_off.ring_mask);
+        cqes = reinterpret_cast<io_uring_cqe*>(cq + params.cq_off.cqes);
+        return true;
+    }
+};
+
+// ========== CorpusReader ==========
+
+CorpusReader::CorpusReader(const std::string& path) : CorpusReader(path, Options()) {}
+
+CorpusReader::CorpusReader(const std::string& path, const Options& options)
+    : path(path), options(options), headroom(0), fd(-1), direct(false), bufferedFd(-1), fileSize(0),
+      ready(static_cast<size_t>(std::max(1, options.inFlight)) + 2),
+      released(static_cast<size_t>(std::max(1, options.inFlight)) + 2),
+      stopping(false), bytesRead(0), finished(false),
+      nextEmit(0), pendingReads(0), failed(false) {
+    this->options.chunkSize = roundUpToPage(std::max<size_t>(options.chunkSize, kPageSize));
+    this->options.inFlight = std::max(1, options.inFlight);
+    headroom = roundUpToPage(std::max<size_t>(options.maxLineLength, 1));
+}
+
+CorpusReader::~CorpusReader() {
+    stopping.store(true, std::memory_order_relaxed);
+    if (thread.joinable()) {
+        thread.join();
+    }
+    for (Buffer& buffer : buffers) {
+        std::free(buffer.memory);
+    }
+    if (fd >= 0) {
+        close(fd);
+    }
+    if (bufferedFd >= 0) {
+        close(bufferedFd);
+    }
+}
+
+bool CorpusReader::open(std::string& error) {
+    if (options.direct) {
+        fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC | O_DIRECT);
+        if (fd < 0 && errno == EINVAL) {
+            SUDOKU_LOG_DEBUG("corpus", "O_DIRECT unsupported, using buffered reads path=" << path);
+        }
+        direct = fd >= 0;
+    }
+    if (fd < 0) {
+        fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    }
+    if (fd < 0) {
+        error = path + ": " + errnoText(errno);
+        return false;
+    }
+
+    struct stat info;
+    if (fstat(fd, &info) != 0) {
+        error = path + ": " + errnoText(errno);
+        return false;
+    }
+    if (!S_ISREG(info.st_mode)) {
+        error = path + ": not a regular file";
+        return false;
+    }
+    fileSize = static_cast<uint64_t>(info.st_size);
+    posix_fadvise(fd, 0, 0, POSIX_FADV_SEQUENTIAL);
+
+    buffers.resize(options.inFlight);
+    for (int i = 0; i < options.inFlight; ++i) {
+        void* memory = nullptr;
+        if (posix_memalign(&memory, kPageSize, headroom + options.chunkSize) != 0) {
+            error = path + ": cannot allocate read buffers";
+            return false;
+        }
+        buffers[i].memory = static_cast<char*>(memory);
+        idle.push_back(i);
+    }
+
+    if (options.useUring) {
+        std::string reason;
+        uring = Uring::create(static_cast<unsigned>(options.inFlight), reason);
+        if (!uring) {
+            SUDOKU_LOG_DEBUG("corpus", "io_uring unavailable, using pread reason=\"" << reason << "\"");
+        }
+    }
+
+    thread = std::thread(&CorpusReader::run, this);
+    return true;
+}
+
+bool CorpusReader::next(CorpusChunk& chunk) {
+    if (finished) {
+        return false;
+    }
+    ready.pop(chunk);
+    if (chunk.data == nullptr) {
+        finished = true;
+        return false;
+    }
+    return true;
+}
+
+void CorpusReader::release(const CorpusChunk& chunk) {
+    released.push(chunk.buffer);
+}
+
+std::string CorpusReader::getError() const {
+    std::lock_guard<std::mutex> lock(errorMutex);
+    return error;
+}
+
+void CorpusReader::fail(const std::string& message) {
+    std::lock_guard<std::mutex> lock(errorMutex);
+    if (error.empty()) {
+        error = path + ": " + message;
+    }
+    failed = true;
+}
+
+void CorpusReader::run() {
+    readAll();
+
+    // Buffers may only be freed once the kernel is done with them
+    std::string ignored;
+    while (uring && pendingReads > 0 && uring->enter(1, ignored)) {
+        uring->reap([&](uint64_t, int) { pendingReads--; });
+    }
+    ready.push(CorpusChunk());
+}
+
+void CorpusReader::readAll() {
+    uint64_t offset = 0;
+    long nextSequence = 0;
+
+    while (!failed && !stopping.load(std::memory_order_relaxed)) {
+        int index;
+        while (released.tryPop(index)) {
+            idle.push_back(index);
+        }
+
+        // Keep every idle buffer busy with the next chunk of the file
+        while (!idle.empty() && offset < fileSize) {
+            int index = idle.back();
+            Buffer& buffer = buffers[index];
+            buffer.sequence = nextSequence++;
+            buffer.length = 0;
+            buffer.wanted = static_cast<size_t>(std::min<uint64_t>(options.chunkSize, fileSize - offset));
+            buffer.offset = offset;
+            buffer.complete = false;
+            idle.pop_back();
+            // Chunks tile the file; a short read is continued below, never skipped
+            offset += buffer.wanted;
+            if (uring) {
+                queueRemainder(index);
+            } else {
+                while (!buffer.complete) {
+                    int readFd;
+                    size_t length;
+                    if (!remainderRead(buffer, readFd, length)) {
+                        return;
+                    }
+                    ssize_t result;
+                    do {
+                        result = pread(readFd, buffer.memory + headroom + buffer.length, length,
+                                       static_cast<off_t>(buffer.offset + buffer.length));
+                    } while (result < 0 && errno == EINTR);
+                    if (result < 0) {
+                        fail("read: " + errnoText(errno));
+                        return;
+                    }
+                    readCompleted(buffer, static_cast<size_t>(result));
+                }
+            }
+        }
+
+        if (uring) {
+            std::string message;
+            if (!uring->enter(0, message)) {
+                fail(message);
+                return;
+            }
+            uring->reap([&](uint64_t tag, int result) {
+                pendingReads--;
+                if (result < 0) {
+                    fail("read: " + errnoText(-result));
+                    return;
+                }
+                Buffer& buffer = buffers[tag];
+                readCompleted(buffer, static_cast<size_t>(result));
+                if (!buffer.complete) {
+                    // Short read: ask for the rest, submitted with the next enter()
+                    queueRemainder(static_cast<int>(tag));
+                }
+            });
+            if (failed) return;
+        }
+
+        bool progressed = emitCompleted();
+        if (failed) return;
+        if (nextEmit == nextSequence && offset >= fileSize) {
+            break;
+        }
+        if (progressed) {
+            continue;
+        }
+
+        // Nothing to hand over yet: wait for a read, or for the parser to return a buffer
+        if (uring && pendingReads > 0) {
+            std::string message;
+            if (!uring->enter(1, message)) {
+                fail(message);
+                return;
+            }
+        } else if (!waitForIdle()) {
+            return;
+        }
+    }
+
+    // A final line without a trailing newline
+    if (!failed && !carry.empty() && (!idle.empty() || waitForIdle())) {
+        Buffer& buffer = buffers[idle.back()];
+        char* start = buffer.memory + headroom - carry.size();
+        std::memcpy(start, carry.data(), carry.size());
+        ready.push({start, carry.size(), idle.back()});
+        idle.pop_back();
+        carry.clear();
+    }
+}
+
+// Reads the part of a buffer's chunk that has not arrived yet
+void CorpusReader::queueRemainder(int index) {
+    Buffer& buffer = buffers[index];
+    int readFd;
+    size_t length;
+    if (!remainderRead(buffer, readFd, length)) {
+        return;
+    }
+    uring->queueRead(readFd, buffer.memory + headroom + buffer.length, static_cast<unsigned>(length),
+                     buffer.offset + buffer.length, static_cast<uint64_t>(index));
+    pendingReads++;
+}
+
+// Descriptor and length for the rest of a buffer's chunk. O_DIRECT needs the
+// offset, length and address aligned: chunks start aligned, the last one's
+// length is rounded up (the read stops at EOF), and a remainder a short read
+// left unaligned goes through a buffered descriptor instead
+bool CorpusReader::remainderRead(const Buffer& buffer, int& readFd, size_t& length) {
+    readFd = fd;
+    length = buffer.wanted - buffer.length;
+    if (!direct) {
+        return true;
+    }
+    if (buffer.length % kPageSize == 0) {
+        length = roundUpToPage(length);
+        return true;
+    }
+    if (bufferedFd < 0) {
+        bufferedFd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+        if (bufferedFd < 0) {
+            fail("open: " + errnoText(errno));
+            return false;
+        }
+        SUDOKU_LOG_DEBUG("corpus", "unaligned short read, reading the rest buffered path=" << path);
+    }
+    readFd = bufferedFd;
+    return true;
+}
+
+// Accounts `bytes` more of a buffer's chunk. It is complete once it holds the
+// whole chunk, or when a read returns nothing (the file shrank since open).
+// Bytes past the chunk (the file grew since open) are not counted
+void CorpusReader::readCompleted(Buffer& buffer, size_t bytes) {
+    bytes = std::min(bytes, buffer.wanted - buffer.length);
+    buffer.length += bytes;
+    buffer.complete = bytes == 0 || buffer.length >= buffer.wanted;
+    bytesRead.fetch_add(bytes, std::memory_order_relaxed);
+}
+
+// Hands completed chunks to the parser in file order, cut at the last newline
+bool CorpusReader::emitCompleted() {
+    bool progressed = false;
+    for (;;) {
+        auto it = std::find_if(buffers.begin(), buffers.end(), [&](const Buffer& buffer) {
+            return buffer.complete && buffer.sequence == nextEmit;
+        });
+        if (it == buffers.end()) {
+            return progressed;
+        }
+        progressed = true;
+        nextEmit++;
+        int index = static_cast<int>(it - buffers.begin());
+        Buffer& buffer = *it;
+        buffer.complete = false;
+        buffer.sequence = -1;
+
+        char* data = buffer.memory + headroom;
+        const char* lastNewline = buffer.length > 0
+            ? static_cast<const char*>(memrchr(data, '\n', buffer.length)) : nullptr;
+        if (lastNewline == nullptr) {
+            // No line ends in this chunk (or it is past EOF): keep accumulating
+            carry.append(data, buffer.length);
+            idle.push_back(index);
+        } else {
+            size_t complete = static_cast<size_t>(lastNewline - data) + 1;
+            std::string tail(data + complete, buffer.length - complete);
+            char* start = data - carry.size();
+            std::memcpy(start, carry.data(), carry.size());
+            ready.push({start, carry.size() + complete, index});
+            carry.swap(tail);
+        }
+
+        if (carry.size() > headroom) {
+            fail("line longer than " + std::to_string(headroom) + " bytes");
+            return progressed;
+        }
+    }
+}
+
+// Blocks until the parser returns a buffer; false when asked to stop
+bool CorpusReader::waitForIdle() {
+    int index;
+    for (int spins = 0; !released.tryPop(index); ++spins) {
+        if (stopping.load(std::memory_order_relaxed)) {
+            return false;
+        }
+        if (spins < 64) {
+            std::this_thread::yield();
+        } else {
+            std::this_thread::sleep_for(std::chrono::microseconds(50));
+        }
+    }
+    idle.push_back(index);
+    return true;
+}
@@ -0,0 +1,121 @@
+/*
+Bulk corpus reader
+Reads a puzzle file in large aligned chunks with several reads in flight,
+using io_uring when the kernel allows it and plain pread() otherwise. A
+background thread issues the reads and hands chunks to the parsing stage
+through a lock-free SPSC queue; every chunk holds whole lines only, so the
+parser slices records straight out of the read buffer. Only the few bytes of
+a line that straddles two reads are copied, into headroom in front of the
+next chunk.
+
+    CorpusReader reader(path);
+    if (!reader.open(error)) ...
+    CorpusChunk chunk;
+    while (reader.next(chunk)) {
+        ... chunk.data[0 .. chunk.length) ...
+        reader.release(chunk);
+    }
+    if (!reader.getError().empty()) ...
+*/
+
+#ifndef SUDOKU_IO_CORPUS_READER_H
+#define SUDOKU_IO_CORPUS_READER_H
+
+#include "../util/spsc_queue.h"
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+struct CorpusChunk {
+    const char* data = nullptr;
+    size_t length = 0;         // Whole lines; the last one may lack its '\n' at EOF
+    int buffer = -1;           // Owning buffer, handed back through release()
+};
+
+class CorpusReader {
+public:
+    struct Options {
+        size_t chunkSize = 1 << 20;     // Bytes per read (rounded up to 4 KiB)
+        int inFlight = 8;               // Buffers, and so reads outstanding at once
+        size_t maxLineLength = 64 << 10; // Headroom for a line split across reads
+        bool useUring = true;           // false forces the pread path
+        bool direct = false;            // O_DIRECT, falling back to buffered I/O
+    };
+
+    explicit CorpusReader(const std::string& path);
+    CorpusReader(const std::string& path, const Options& options);
+    ~CorpusReader();
+
+    CorpusReader(const CorpusReader&) = delete;
+    CorpusReader& operator=(const CorpusReader&) = delete;
+
+    // Opens the file and starts the read thread
+    bool open(std::string& error);
+
+    // Next chunk in file order; false at end of input or after an error
+    bool next(CorpusChunk& chunk);
+
+    // Returns a chunk's buffer for reuse; every chunk from next() must come back
+    void release(const CorpusChunk& chunk);
+
+    // "io_uring" or "pread"
+    const char* getBackend() const { return uring ? "io_uring" : "pread"; }
+
+    // Read error, if reading stopped early
+    std::string getError() const;
+
+    uint64_t getBytesRead() const { return bytesRead.load(std::memory_order_relaxed); }
+
+private:
+    class Uring;
+
+    struct Buffer {
+        char* memory = nullptr;   // Headroom for a carried-over line, then chunkSize of data
+        size_t length = 0;        // Bytes read
+        size_t wanted = 0;        // Bytes of the file this chunk covers
+        uint64_t offset = 0;      // File offset of the chunk
+        long sequence = -1;       // Position in file order, -1 while idle
+        bool complete = false;
+    };
+
+    std::string path;
+    Options options;
+    size_t headroom;
+    int fd;
+    bool direct;                    // fd was opened with O_DIRECT
+    int bufferedFd;                 // For remainders O_DIRECT cannot read, opened on first use
+    uint64_t fileSize;
+    std::unique_ptr<Uring> uring;
+    std::vector<Buffer> buffers;
+    SpscQueue<CorpusChunk> ready;   // Read thread -> parser; data == nullptr marks the end
+    SpscQueue<int> released;        // Parser -> read thread
+    std::thread thread;
+    std::atomic<bool> stopping;
+    std::atomic<uint64_t> bytesRead;
+    mutable std::mutex errorMutex;
+    std::string error;
+    bool finished;
+
+    // Read-thread state
+    std::vector<int> idle;
+    std::string carry;              // Partial line at the end of the last chunk emitted
+    long nextEmit;
+    int pendingReads;
+    bool failed;
+
+    void run();
+    void readAll();
+    void queueRemainder(int index);
+    bool remainderRead(const Buffer& buffer, int& readFd, size_t& length);
+    void readCompleted(Buffer& buffer, size_t bytes);
+    bool emitCompleted();
+    bool waitForIdle();
+    void fail(const std::string& message);
+};
+
+#endif // SUDOKU_IO_CORPUS_READER_H
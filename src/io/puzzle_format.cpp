@@ -0,0 +1,147 @@
+/*
+Plain-text puzzle format implementation
+*/
+
+#include "puzzle_format.h"
+
+namespace {
+
+// Blank-cell markers used by the common collections
+bool isBlankMarker(char c) {
+    return c == '.' || c == '0' || c == '_';
+}
+
+bool isCellChar(char c) {
+    return (c >= '1' && c <= '9') || isBlankMarker(c);
+}
+
+}
+
+PuzzleLineAssembler::PuzzleLineAssembler()
+    : rowLength(0), lineNumber(0), partialStartLine(0), puzzleLine(0) {}
+
+PuzzleLineAssembler::Result PuzzleLineAssembler::addLine(const char* data, size_t length,
+                                                         std::string& cells, std::string& error) {
+    lineNumber++;
+
+    // Comment lines never carry cells; blank lines only separate puzzles
+    size_t start = 0;
+    while (start < length && (data[start] == ' ' || data[start] == '\t')) start++;
+    if (start < length && data[start] == '#') {
+        return Result::NONE;
+    }
+
+    std::string lineCells;
+    lineCells.reserve(length);
+    for (size_t i = start; i < length; ++i) {
+        char c = data[i];
+        if (isCellChar(c)) {
+            lineCells += isBlankMarker(c) ? '0' : c;
+        } else if (c != ' ' && c != '\t' && c != '|' && c != '+' && c != '-' && c != '\r') {
+            partial.clear();
+            rowLength = 0;
+            error = "line " + std::to_string(lineNumber) + ": unexpected character '" + std::string(1, c) + "'";
+            return Result::ERROR;
+        }
+    }
+
+    if (lineCells.empty()) {
+        // Blank line or a "------+------" rule between boxes
+        return Result::NONE;
+    }
+
+    // A whole puzzle on one line
+    if (partial.empty() && boardSizeForCellCount(lineCells.size()) != 0 && lineCells.size() > 9) {
+        cells = std::move(lineCells);
+        puzzleLine = lineNumber;
+        return Result::PUZZLE;
+    }
+
+    // One row of a multi-line grid
+    if (partial.empty()) {
+        if (lineCells.size() != 4 && lineCells.size() != 9) {
+            error = "line " + std::to_string(lineNumber) + ": expected a grid row or a full puzzle, got " +
+                    std::to_string(lineCells.size()) + " cells";
+            return Result::ERROR;
+        }
+        rowLength = static_cast<int>(lineCells.size());
+        partialStartLine = lineNumber;
+    } else if (static_cast<int>(lineCells.size()) != rowLength) {
+        error = "line " + std::to_string(lineNumber) + ": grid row has " + std::to_string(lineCells.size()) +
+                " cells, expected " + std::to_string(rowLength);
+        partial.clear();
+        rowLength = 0;
+        return Result::ERROR;
+    }
+
+    partial += lineCells;
+    if (static_cast<int>(partial.size()) == rowLength * rowLength) {
+        cells = std::move(partial);
+        partial.clear();
+        rowLength = 0;
+        puzzleLine = partialStartLine;
+        return Result::PUZZLE;
+    }
+    return Result::NONE;
+}
+
+PuzzleLineAssembler::Result PuzzleLineAssembler::finish(std::string& error) {
+    if (partial.empty()) {
+        return Result::NONE;
+    }
+    error = "line " + std::to_string(partialStartLine) + ": incomplete grid (" +
+            std::to_string(partial.size() / rowLength) + " of " + std::to_string(rowLength) + " rows)";
+    partial.clear();
+    rowLength = 0;
+    return Result::ERROR;
+}
+
+int boardSizeForCellCount(size_t cellCount) {
+    switch (cellCount) {
+        case 16: return 4;
+        case 81: return 9;
+        default: return 0;
+    }
+}
+
+bool boardFromCells(const std::string& cells, Board& board, std::string& error) {
+    int size = boardSizeForCellCount(cells.size());
+    if (size == 0) {
+        error = "unsupported puzzle with " + std::to_string(cells.size()) + " cells";
+        return false;
+    }
+
+    int gridSize = size == 4 ? 2 : 3;
+    if (board.getGridSize() != gridSize) {
+        board = Board(gridSize);
+    }
+
+    for (int row = 0; row < size; ++row) {
+        for (int col = 0; col < size; ++col) {
+            int value = cells[row * size + col] - '0';
+            if (value > size) {
+                error = "value " + std::to_string(value) + " out of range for a " +
+                        std::to_string(size) + "x" + std::to_string(size) + " board";
+                return false;
+            }
+            Cell& cell = board.getCell(row, col);
+            cell.setLocked(false);
+            cell.setValue(value);
+            cell.setLocked(value != 0);
+        }
+    }
+    return true;
+}
+
+std::string boardToLine(const Board& board) {
+    int size = board.getBoardSize();
+    std::string line;
+    line.reserve(size * size);
+    for (int row = 0; row < size; ++row) {
+        for (int col = 0; col < size; ++col) {
+            int value = board.getCell(row, col).getValue();
+            line += value == 0 ? '.' : static_cast<char>('0' + value);
+        }
+    }
+    return line;
+}
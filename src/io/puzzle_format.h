@@ -0,0 +1,54 @@
+/*
+Plain-text puzzle formats
+Understands the two layouts common in puzzle collections:
+  - one puzzle per line: 81 (or 16 for 4x4) cells, '.' or '0' for blanks
+  - multi-line grids: one row per line, optional '|', '+', '-' and space
+    separators, blank or '#' comment lines between puzzles
+Lines are fed in as raw byte ranges, so callers can hand over slices of a
+larger read buffer without copying. Complete puzzles come out as a
+normalised cell string ("530070000...") that converts to a Board.
+*/
+
+#ifndef SUDOKU_IO_PUZZLE_FORMAT_H
+#define SUDOKU_IO_PUZZLE_FORMAT_H
+
+#include "../model/board.h"
+#include <cstddef>
+#include <string>
+
+class PuzzleLineAssembler {
+public:
+    enum class Result {
+        NONE,       // Line consumed (blank, comment, separator or partial grid row)
+        PUZZLE,     // A complete puzzle is in `cells`
+        ERROR       // Malformed input; `error` explains, any partial grid is dropped
+    };
+
+    PuzzleLineAssembler();
+
+    Result addLine(const char* data, size_t length, std::string& cells, std::string& error);
+
+    // Input ended: reports a half-finished multi-line grid as an error
+    Result finish(std::string& error);
+
+    // Line number of the first line of the puzzle most recently returned
+    long getPuzzleLine() const { return puzzleLine; }
+
+private:
+    std::string partial;     // Rows of a multi-line grid collected so far
+    int rowLength;           // Cells per row of the grid being collected
+    long lineNumber;
+    long partialStartLine;
+    long puzzleLine;
+};
+
+// Cells per side for a normalised cell string (81 -> 9, 16 -> 4), or 0
+int boardSizeForCellCount(size_t cellCount);
+
+// Normalised cell string -> Board (givens locked); false with reason on bad input
+bool boardFromCells(const std::string& cells, Board& board, std::string& error);
+
+// Board -> single-line form with digits and '.' for blanks
+std::string boardToLine(const Board& board);
+
+#endif // SUDOKU_IO_PUZZLE_FORMAT_H
@@ -0,0 +1,104 @@
+/*
+Board JSON writer implementation
+*/
+
+#include "board_json.h"
+#include <charconv>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+namespace {
+
+// Longest text a cell can produce: {"value":-2147483648,"locked":false},
+constexpr size_t kMaxCellChars = 37;
+
+char* writeInt(char* out, int value) {
+    return std::to_chars(out, out + 11, value).ptr;
+}
+
+char* writeText(char* out, const char* text, size_t length) {
+    std::memcpy(out, text, length);
+    return out + length;
+}
+
+// Values seen per row, column and box, one bit per value
+class UnitTracker {
+public:
+    explicit UnitTracker(int size) : size(size), words(size / 64 + 1) {
+        bits.assign(static_cast<size_t>(3 * size * words), 0);
+    }
+
+    // False when the value was already in one of the cell's units
+    bool add(int row, int col, int box, int value) {
+        uint64_t mask = uint64_t(1) << (value % 64);
+        int word = value / 64;
+        uint64_t& inRow = bits[static_cast<size_t>(row * words + word)];
+        uint64_t& inCol = bits[static_cast<size_t>((size + col) * words + word)];
+        uint64_t& inBox = bits[static_cast<size_t>((2 * size + box) * words + word)];
+        bool fresh = !((inRow | inCol | inBox) & mask);
+        inRow |= mask;
+        inCol |= mask;
+        inBox |= mask;
+        return fresh;
+    }
+
+private:
+    int size;
+    int words;
+    std::vector<uint64_t> bits;
+};
+
+}
+
+BoardScan appendBoardJson(std::string& out, const Board& board, BoardJsonLayout layout) {
+    int size = board.getBoardSize();
+    int gridSize = board.getGridSize();
+    bool cells = layout == BoardJsonLayout::CELLS;
+    BoardScan scan;
+    scan.cells = size * size;
+    UnitTracker units(size);
+
+    // Sized for the worst case up front, written through a cursor, trimmed at the end
+    size_t start = out.size();
+    out.resize(start + static_cast<size_t>(scan.cells) * kMaxCellChars + static_cast<size_t>(size) * 3 + 16);
+    char* cursor = &out[start];
+    cursor = cells ? writeText(cursor, "{\"cells\":[", 10) : writeText(cursor, "[", 1);
+    for (int row = 0; row < size; ++row) {
+        if (row > 0) *cursor++ = ',';
+        *cursor++ = '[';
+        int gridRow = row / gridSize;
+        int cellRow = row % gridSize;
+        // Walk the row subgrid by subgrid rather than dividing per cell
+        for (int gridCol = 0; gridCol < gridSize; ++gridCol) {
+            const Grid& grid = board.getGrid(gridRow, gridCol);
+            int box = gridRow * gridSize + gridCol;
+            for (int cellCol = 0; cellCol < gridSize; ++cellCol) {
+                const Cell& cell = grid.getCell(cellRow, cellCol);
+                int col = gridCol * gridSize + cellCol;
+                int value = cell.getValue();
+                if (col > 0) *cursor++ = ',';
+                if (cells) {
+                    cursor = writeText(cursor, "{\"value\":", 9);
+                    cursor = writeInt(cursor, value);
+                    cursor = cell.isLocked() ? writeText(cursor, ",\"locked\":true}", 15)
+                                             : writeText(cursor, ",\"locked\":false}", 16);
+                } else {
+                    cursor = writeInt(cursor, value);
+                }
+
+                if (value == 0) {
+                    continue;
+                }
+                ++scan.filled;
+                if (value < 0 || value > size || !units.add(row, col, box, value)) {
+                    scan.conflict = true;
+                }
+            }
+        }
+        *cursor++ = ']';
+    }
+    cursor = cells ? writeText(cursor, "]}", 2) : writeText(cursor, "]", 1);
+    out.resize(static_cast<size_t>(cursor - out.data()));
+    return scan;
+}
@@ -0,0 +1,38 @@
+/*
+Board JSON writer shared by the API responses and WebView
+Boards are appended straight into a caller-owned string, at any board size,
+instead of going through a stream or a JSON document per cell. Two layouts:
+
+  VALUES: [[5,3,0,...],[6,0,0,...],...]                              (WebView)
+  CELLS:  {"cells":[[{"value":5,"locked":true},...],...]}    (SudokuJsonApi)
+
+While it walks the cells the writer also tracks how many are filled and
+whether any row, column or box repeats a value, so callers that report
+completeness get it from the same pass instead of calling isComplete() and
+isValid() (each another walk over the board) afterwards.
+*/
+
+#ifndef SUDOKU_MODEL_BOARD_JSON_H
+#define SUDOKU_MODEL_BOARD_JSON_H
+
+#include "board.h"
+#include <string>
+
+enum class BoardJsonLayout {
+    VALUES,
+    CELLS
+};
+
+// What the writer saw; isSolved() matches isComplete() && isValid()
+struct BoardScan {
+    int cells = 0;
+    int filled = 0;
+    bool conflict = false;   // Some row, column or box holds a value twice
+
+    bool isComplete() const { return filled == cells; }
+    bool isSolved() const { return filled == cells && !conflict; }
+};
+
+BoardScan appendBoardJson(std::string& out, const Board& board, BoardJsonLayout layout);
+
+#endif // SUDOKU_MODEL_BOARD_JSON_H
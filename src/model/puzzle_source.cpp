@@ -0,0 +1,78 @@
+/*
+PuzzleSource implementations
+*/
+
+#include "puzzle_source.h"
+#include "../util/executor.h"
+#include <algorithm>
+#include <mutex>
+
+VectorPuzzleSource::VectorPuzzleSource(const std::vector<std::pair<Board, Board>>& data)
+    : data(data), nextIndex(0) {}
+
+bool VectorPuzzleSource::next(std::pair<Board, Board>& pair) {
+    size_t index = nextIndex.fetch_add(1);
+    if (index >= data.size()) {
+        return false;
+    }
+    pair = data[index];
+    return true;
+}
+
+GeneratedPuzzleSource::GeneratedPuzzleSource(int count, int gridSize)
+    : count(count), gridSize(gridSize), nextIndex(0), failures(0) {}
+
+bool GeneratedPuzzleSource::next(std::pair<Board, Board>& pair) {
+    // Each thread keeps its own generator so generation runs in parallel
+    thread_local SudokuGenerator generator;
+
+    int index;
+    while ((index = nextIndex.fetch_add(1)) < count) {
+        Board completeBoard(gridSize);
+        if (generator.generateCompleteGrid(completeBoard)) {
+            Board puzzle = completeBoard;
+            if (generator.createPuzzleFromCompleteGrid(puzzle, SudokuGenerator::difficultyForIndex(index))) {
+                pair = std::make_pair(puzzle, completeBoard);
+                return true;
+            }
+        }
+        failures++;
+    }
+    return false;
+}
+
+std::vector<std::pair<Board, Board>> collectPuzzles(PuzzleSource& source, size_t maxCount, int threads) {
+    Executor& executor = Executor::shared();
+    if (threads <= 0) {
+        threads = executor.getConcurrency();
+    }
+    threads = static_cast<int>(std::min<size_t>(threads, std::max<size_t>(1, maxCount)));
+
+    // Each task fills its own shard (allocated on its worker's NUMA node);
+    // shards are merged once at the end
+    std::vector<std::pair<Board, Board>> result;
+    result.reserve(maxCount);
+    std::mutex resultMutex;
+    std::atomic<size_t> claimed(0);
+
+    auto worker = [&]() {
+        std::vector<std::pair<Board, Board>> shard;
+        std::pair<Board, Board> pair;
+        while (claimed.fetch_add(1) < maxCount && source.next(pair)) {
+            shard.push_back(std::move(pair));
+        }
+        std::lock_guard<std::mutex> lock(resultMutex);
+        for (auto& item : shard) {
+            result.push_back(std::move(item));
+        }
+    };
+
+    // Dataset building is background work: interactive tasks go first
+    TaskGroup group(TaskPriority::BACKGROUND, executor);
+    for (int i = 0; i < threads; ++i) {
+        group.run(worker);
+    }
+    group.wait();
+
+    return result;
+}
@@ -0,0 +1,59 @@
+/*
+PuzzleSource - streaming supply of (puzzle, solution) pairs
+Lets evaluation and training consume datasets one pair at a time instead of
+holding the whole set in memory. Every source must be safe to call from
+multiple threads at once; next() returns false once the source is exhausted.
+*/
+
+#ifndef SUDOKU_MODEL_PUZZLE_SOURCE_H
+#define SUDOKU_MODEL_PUZZLE_SOURCE_H
+
+#include "board.h"
+#include "sudoku_generator.h"
+#include <atomic>
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+class PuzzleSource {
+public:
+    virtual ~PuzzleSource() = default;
+
+    // Fetch the next pair; thread-safe
+    virtual bool next(std::pair<Board, Board>& pair) = 0;
+};
+
+// Serves pairs from an in-memory dataset without copying the whole set
+class VectorPuzzleSource : public PuzzleSource {
+public:
+    explicit VectorPuzzleSource(const std::vector<std::pair<Board, Board>>& data);
+
+    bool next(std::pair<Board, Board>& pair) override;
+
+private:
+    const std::vector<std::pair<Board, Board>>& data;
+    std::atomic<size_t> nextIndex;
+};
+
+// Generates `count` fresh pairs on demand, mixing all difficulty levels
+class GeneratedPuzzleSource : public PuzzleSource {
+public:
+    GeneratedPuzzleSource(int count, int gridSize = 3);
+
+    bool next(std::pair<Board, Board>& pair) override;
+
+    // Pairs that had to be skipped because generation failed
+    int getFailures() const { return failures.load(); }
+
+private:
+    int count;
+    int gridSize;
+    std::atomic<int> nextIndex;
+    std::atomic<int> failures;
+};
+
+// Pull up to maxCount pairs from a source with `threads` tasks on the shared
+// executor (0 = as many as it can run at once)
+std::vector<std::pair<Board, Board>> collectPuzzles(PuzzleSource& source, size_t maxCount, int threads = 0);
+
+#endif // SUDOKU_MODEL_PUZZLE_SOURCE_H
@@ -6,11 +6,21 @@ Generates valid Sudoku puzzles using backtracking algorithm
 #include "sudoku_generator.h"
 #include <algorithm>
 #include <chrono>
+#include <cstdlib>
 
 SudokuGenerator::SudokuGenerator() 
     : rng(std::chrono::steady_clock::now().time_since_epoch().count()) {
 }
 
+SudokuGenerator::SudokuGenerator(unsigned int seed)
+    : rng(seed) {
+}
+
+SudokuGenerator::Difficulty SudokuGenerator::difficultyForIndex(int index) {
+    static const Difficulty levels[] = {EASY, MEDIUM, HARD, EXPERT};
+    return levels[std::abs(index) % 4];
+}
+
 bool SudokuGenerator::generateCompleteGrid(Board& board) {
     // Clear the board first
     for (int i = 0; i < board.getBoardSize(); i++) {
@@ -13,6 +13,7 @@ Uses backtracking algorithm to generate complete grids and then removes cells fo
 class SudokuGenerator {
 public:
     SudokuGenerator();
+    explicit SudokuGenerator(unsigned int seed);   // Reproducible puzzles (benchmarks)
     
     // Generate a complete, valid Sudoku grid
     bool generateCompleteGrid(Board& board);
@@ -31,6 +32,9 @@ public:
         EXPERT = 55    // Remove 55 cells
     };
     
+    // Even mix of all difficulties, cycling EASY -> EXPERT by index
+    static Difficulty difficultyForIndex(int index);
+    
 private:
     std::mt19937 rng;
     
@@ -24,7 +24,8 @@ public:
     AINeuralSolver();
     
     // Core solving methods
-    bool solve(Board& board) override;
+    using SudokuSolver::solve;
+    bool solve(Board& board, SolveContext& context) override;
     bool canSolve(const Board& board) const override;
     
     // AI-powered move prediction
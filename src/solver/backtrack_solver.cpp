@@ -6,20 +6,11 @@ Backtracking Solver Implementation
 #include <algorithm>
 #include <random>
 
-BacktrackSolver::BacktrackSolver() : currentStep(0) {
-    reset();
-}
+BacktrackSolver::BacktrackSolver() {}
 
-bool BacktrackSolver::solve(Board& board) {
-    auto startTime = std::chrono::high_resolution_clock::now();
-    
-    reset();
-    bool result = solveRecursive(board);
-    
-    auto endTime = std::chrono::high_resolution_clock::now();
-    solveTimeMs = std::chrono::duration<double, std::milli>(endTime - startTime).count();
-    
-    return result;
+bool BacktrackSolver::solve(Board& board, SolveContext& context) {
+    SolveTimer timer(context);
+    return solveRecursive(board, context);
 }
 
 bool BacktrackSolver::canSolve(const Board& board) const {
@@ -27,7 +18,7 @@ bool BacktrackSolver::canSolve(const Board& board) const {
     return board.isValid();
 }
 
-bool BacktrackSolver::solveRecursive(Board& board) {
+bool BacktrackSolver::solveRecursive(Board& board, SolveContext& context) const {
     int row, col;
     
     // Find empty cell
@@ -41,10 +32,11 @@ bool BacktrackSolver::solveRecursive(Board& board) {
         if (isValidMove(board, row, col, value)) {
             // Make move
             board.getCell(row, col).setValue(value);
-            movesCount++;
+            context.movesCount++;
+            context.reportProgress(board, context.movesCount);
             
             // Recursively solve
-            if (solveRecursive(board)) {
+            if (solveRecursive(board, context)) {
                 return true;
             }
             
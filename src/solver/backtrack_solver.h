@@ -13,8 +13,11 @@ class BacktrackSolver : public SudokuSolver {
 public:
     BacktrackSolver();
     
-    // Core solving methods
-    bool solve(Board& board) override;
+    // Core solving methods; no per-call state in the object, so one instance
+    // can be shared by all threads
+    using SudokuSolver::solve;
+    bool solve(Board& board, SolveContext& context) override;
+    bool isReentrant() const override { return true; }
     bool canSolve(const Board& board) const override;
     
     // Step-by-step solving
@@ -29,14 +32,9 @@ public:
     }
 
 private:
-    bool solveRecursive(Board& board);
+    bool solveRecursive(Board& board, SolveContext& context) const;
     bool findEmptyCell(const Board& board, int& row, int& col) const;
     double calculateSmartConfidence(const Board& board, int row, int col, int value, int possibilityCount) const;
-    
-    // For step-by-step solving
-    mutable Board workingBoard;
-    mutable std::vector<SolverMove> moveHistory;
-    mutable int currentStep;
 };
 
 #endif // SUDOKU_BACKTRACK_SOLVER_H
@@ -18,7 +18,8 @@ ConstraintSolver::ConstraintSolver() {
     };
 }
 
-bool ConstraintSolver::solve(Board& board) {
+bool ConstraintSolver::solve(Board& board, SolveContext& context) {
+    SolveTimer timer(context);
     bool progress = true;
     while (progress && !isBoardComplete(board)) {
         progress = false;
@@ -30,6 +31,8 @@ bool ConstraintSolver::solve(Board& board) {
                 // Apply the first move found
                 if (!moves.empty()) {
                     board.getCell(moves[0].row, moves[0].col).setValue(moves[0].value);
+                    context.movesCount++;
+                    context.reportProgress(board, context.movesCount);
                     progress = true;
                     break;
                 }
@@ -85,7 +88,7 @@ std::vector<SolverMove> ConstraintSolver::getAllPossibleMoves(const Board& board
     return allMoves;
 }
 
-bool ConstraintSolver::nakedSingles(Board& board, std::vector<SolverMove>& moves) {
+bool ConstraintSolver::nakedSingles(Board& board, std::vector<SolverMove>& moves) const {
     int size = board.getBoardSize();
     bool found = false;
     
@@ -110,7 +113,7 @@ bool ConstraintSolver::nakedSingles(Board& board, std::vector<SolverMove>& moves
     return found;
 }
 
-bool ConstraintSolver::hiddenSingles(Board& board, std::vector<SolverMove>& moves) {
+bool ConstraintSolver::hiddenSingles(Board& board, std::vector<SolverMove>& moves) const {
     int size = board.getBoardSize();
     int gridSize = static_cast<int>(sqrt(size));
     bool found = false;
@@ -189,7 +192,7 @@ bool ConstraintSolver::hiddenSingles(Board& board, std::vector<SolverMove>& move
     return found;
 }
 
-bool ConstraintSolver::nakedPairs(Board& board, std::vector<SolverMove>& moves) {
+bool ConstraintSolver::nakedPairs(Board& board, std::vector<SolverMove>& moves) const {
     // Simplified naked pairs - find cells with exactly 2 candidates
     int size = board.getBoardSize();
     bool found = false;
@@ -216,7 +219,7 @@ bool ConstraintSolver::nakedPairs(Board& board, std::vector<SolverMove>& moves)
     return found;
 }
 
-bool ConstraintSolver::pointingPairs(Board& board, std::vector<SolverMove>& moves) {
+bool ConstraintSolver::pointingPairs(Board& board, std::vector<SolverMove>& moves) const {
     // Simplified pointing pairs - advanced technique
     // For now, return false (not implemented)
     return false;
@@ -236,7 +239,7 @@ std::set<int> ConstraintSolver::getCandidates(const Board& board, int row, int c
 }
 
 bool ConstraintSolver::eliminateCandidate(std::map<std::pair<int,int>, std::set<int>>& candidates, 
-                                        int row, int col, int value) {
+                                        int row, int col, int value) const {
     auto it = candidates.find({row, col});
     if (it != candidates.end()) {
         return it->second.erase(value) > 0;
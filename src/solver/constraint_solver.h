@@ -15,8 +15,11 @@ class ConstraintSolver : public SudokuSolver {
 public:
     ConstraintSolver();
     
-    // Core solving methods
-    bool solve(Board& board) override;
+    // Core solving methods; the strategy table is fixed at construction, so
+    // one instance can be shared by all threads
+    using SudokuSolver::solve;
+    bool solve(Board& board, SolveContext& context) override;
+    bool isReentrant() const override { return true; }
     bool canSolve(const Board& board) const override;
     
     // Step-by-step solving with intelligent reasoning
@@ -32,17 +35,17 @@ public:
 
 private:
     // Constraint propagation techniques
-    bool nakedSingles(Board& board, std::vector<SolverMove>& moves);
-    bool hiddenSingles(Board& board, std::vector<SolverMove>& moves);
-    bool nakedPairs(Board& board, std::vector<SolverMove>& moves);
-    bool pointingPairs(Board& board, std::vector<SolverMove>& moves);
+    bool nakedSingles(Board& board, std::vector<SolverMove>& moves) const;
+    bool hiddenSingles(Board& board, std::vector<SolverMove>& moves) const;
+    bool nakedPairs(Board& board, std::vector<SolverMove>& moves) const;
+    bool pointingPairs(Board& board, std::vector<SolverMove>& moves) const;
     
     // Helper methods
     std::set<int> getCandidates(const Board& board, int row, int col) const;
     bool eliminateCandidate(std::map<std::pair<int,int>, std::set<int>>& candidates, 
-                           int row, int col, int value);
+                           int row, int col, int value) const;
     
-    // Strategy execution order (from easiest to hardest)
+    // Strategy execution order (from easiest to hardest); read-only after construction
     std::vector<std::function<bool(Board&, std::vector<SolverMove>&)>> strategies;
     
     // Confidence calculation based on strategy used
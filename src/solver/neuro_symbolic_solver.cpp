@@ -5,17 +5,22 @@ Demonstrates hybrid AI combining neural networks with symbolic reasoning
 
 #include "neuro_symbolic_solver.h"
 #include "../model/sudoku_generator.h"
+#include "../util/executor.h"
+#include "../util/logger.h"
+#include "../util/trace.h"
 #include <algorithm>
+#include <atomic>
 #include <cmath>
 #include <random>
 #include <numeric>
-#include <iostream>
 #include <iomanip>
 #include <chrono>
 #include <sstream>
 #include <fstream>
 #include <filesystem>
-#include <filesystem>
+#include <functional>
+#include <fcntl.h>
+#include <unistd.h>
 
 // ============================================================================
 // SudokuNeuralNetwork Implementation
@@ -81,7 +86,7 @@ void SudokuNeuralNetwork::adaptToBoardSize(int newSize) {
 }
 
 std::vector<double> SudokuNeuralNetwork::extractFeatures(const Board& board, int row, int col, int value, 
-                                                      const std::vector<double>& symbolicHints) {
+                                                      const std::vector<double>& symbolicHints) const {
     std::vector<double> features;
     features.reserve(inputSize);
     
@@ -148,6 +153,19 @@ std::vector<double> SudokuNeuralNetwork::extractFeatures(const Board& board, int
 }
 
 double SudokuNeuralNetwork::forward(const std::vector<double>& features) {
+    std::vector<double> hiddenOutputs;
+    double result = forward(features, hiddenOutputs);
+    
+    // Keep activations on the neurons for the backward pass in updateWeights
+    for (size_t i = 0; i < hiddenLayer.size(); ++i) {
+        hiddenLayer[i].output = hiddenOutputs[i];
+    }
+    return result;
+}
+
+double SudokuNeuralNetwork::forward(const std::vector<double>& features, std::vector<double>& hiddenOutputs) const {
+    hiddenOutputs.resize(hiddenLayer.size());
+    
     // Forward pass through hidden layer
     for (size_t i = 0; i < hiddenLayer.size(); ++i) {
         double sum = hiddenLayer[i].bias;
@@ -155,13 +173,13 @@ double SudokuNeuralNetwork::forward(const std::vector<double>& features) {
             sum += features[j] * hiddenLayer[i].weights[j];
         }
         // ReLU activation
-        hiddenLayer[i].output = std::max(0.0, sum);
+        hiddenOutputs[i] = std::max(0.0, sum);
     }
     
     // Forward pass through output layer
     double sum = outputLayer[0].bias;
     for (size_t i = 0; i < hiddenLayer.size(); ++i) {
-        sum += hiddenLayer[i].output * outputLayer[0].weights[i];
+        sum += hiddenOutputs[i] * outputLayer[0].weights[i];
     }
     
     // Sigmoid activation for confidence (0-1)
@@ -174,11 +192,12 @@ double SudokuNeuralNetwork::predictMoveConfidence(const Board& board, int row, i
     return forward(features);
 }
 
-double SudokuNeuralNetwork::predictMoveConfidencePure(const Board& board, int row, int col, int value) {
+double SudokuNeuralNetwork::predictMoveConfidencePure(const Board& board, int row, int col, int value) const {
     // Pure neural prediction - NO symbolic hints, only pattern recognition
     std::vector<double> emptyHints(8, 0.0); // Default symbolic hints (all zeros)
     std::vector<double> features = extractFeatures(board, row, col, value, emptyHints);
-    return forward(features);
+    std::vector<double> hiddenOutputs;
+    return forward(features, hiddenOutputs);
 }
 
 void SudokuNeuralNetwork::updateWeights(const Board& board, int row, int col, int value, bool wasCorrect,
@@ -409,19 +428,27 @@ std::vector<double> SymbolicReasoner::generateSymbolicHints(const Board& board,
 // ============================================================================
 
 NeuroSymbolicSolver::NeuroSymbolicSolver(int boardSize) 
-    : neuralNet(std::make_unique<SudokuNeuralNetwork>(boardSize))
-    , symbolicReasoner(std::make_unique<SymbolicReasoner>()) {
-    
-    // Try to load existing trained model for this board size
-    std::string modelPath = "models/neuro_symbolic_" + std::to_string(boardSize) + "x" + std::to_string(boardSize) + ".bin";
-    if (loadNetworkState(modelPath)) {
-        std::cout << "✅ Loaded pre-trained model for " << boardSize << "x" << boardSize << " puzzles" << std::endl;
-    } else {
-        std::cout << "🆕 Starting with fresh neural network for " << boardSize << "x" << boardSize << " puzzles" << std::endl;
+    : symbolicReasoner(std::make_unique<SymbolicReasoner>())
+    , initialBoardSize(boardSize) {
+    // The network and its model file are loaded on first use (see network())
+}
+
+SudokuNeuralNetwork& NeuroSymbolicSolver::network() {
+    if (!neuralNet) {
+        SUDOKU_TRACE_SPAN("model_load");
+        // Try to load existing trained model for this board size
+        std::string modelPath = modelPathFor(initialBoardSize);
+        if (loadNetworkState(modelPath)) {
+            SUDOKU_LOG_INFO("neuro_symbolic", "loaded pre-trained model size=" << initialBoardSize << " path=" << modelPath);
+        } else {
+            SUDOKU_LOG_INFO("neuro_symbolic", "starting with fresh network size=" << initialBoardSize);
+        }
     }
+    return *neuralNet;
 }
 
-bool NeuroSymbolicSolver::solve(Board& board) {
+bool NeuroSymbolicSolver::solve(Board& board, SolveContext& context) {
+    SolveTimer timer(context);
     bool progress = true;
     int iterations = 0;
     const int maxIterations = 10000; // Increased limit for neural network
@@ -433,7 +460,8 @@ bool NeuroSymbolicSolver::solve(Board& board) {
         if (getNextMove(board, move)) {
             board.getCell(move.row, move.col).setValue(move.value);
             progress = true;
-            movesCount++;
+            context.movesCount++;
+            context.reportProgress(board, context.movesCount);
         }
         
         iterations++;
@@ -458,7 +486,7 @@ bool NeuroSymbolicSolver::getNextMove(const Board& board, SolverMove& move) {
 std::vector<SolverMove> NeuroSymbolicSolver::getAllPossibleMoves(const Board& board) {
     // Auto-adapt to board size if needed
     int currentBoardSize = board.getBoardSize();
-    neuralNet->adaptToBoardSize(currentBoardSize);
+    network().adaptToBoardSize(currentBoardSize);
     
     // Generate all possible moves using symbolic-informed neural network
     std::vector<SolverMove> moves;
@@ -474,7 +502,7 @@ std::vector<SolverMove> NeuroSymbolicSolver::getAllPossibleMoves(const Board& bo
                         
                         // Always use symbolic-informed approach for solving (true neuro-symbolic)
                         std::vector<double> symbolicHints = symbolicReasoner->generateSymbolicHints(board, row, col, value);
-                        confidence = neuralNet->predictMoveConfidence(board, row, col, value, symbolicHints);
+                        confidence = network().predictMoveConfidence(board, row, col, value, symbolicHints);
                         
                         if (isTrainingMode) {
                             reasoning = "Training Mode - Symbolic-Informed: ";
@@ -514,7 +542,7 @@ std::vector<SolverMove> NeuroSymbolicSolver::getAllPossibleMovesPure(const Board
                 for (int value = 1; value <= size; ++value) {
                     if (symbolicReasoner->validateMove(board, row, col, value)) {
                         // Use PURE neural network prediction without symbolic hints
-                        double confidence = neuralNet->predictMoveConfidencePure(board, row, col, value);
+                        double confidence = network().predictMoveConfidencePure(board, row, col, value);
                         std::string reasoning = "Pure Neural Pattern Recognition";
                         
                         moves.emplace_back(row, col, value, reasoning, confidence);
@@ -533,7 +561,7 @@ std::vector<SolverMove> NeuroSymbolicSolver::getAllPossibleMovesPure(const Board
     return moves;
 }
 
-void NeuroSymbolicSolver::trainOnSolution(const Board& originalBoard, const Board& solvedBoard) {
+void NeuroSymbolicSolver::trainOnSolution(const Board& originalBoard, const Board& solvedBoard, bool autoSave) {
     // Extract training data from the solution path
     // Now training includes symbolic hints for better learning
     int size = originalBoard.getBoardSize();
@@ -548,7 +576,7 @@ void NeuroSymbolicSolver::trainOnSolution(const Board& originalBoard, const Boar
                 
                 // Train neural network: correct value should have high confidence
                 // The neural network now learns from both patterns AND logical reasoning!
-                neuralNet->updateWeights(originalBoard, row, col, correctValue, true, correctHints);
+                network().updateWeights(originalBoard, row, col, correctValue, true, correctHints);
                 
                 // Train on wrong values (they should have low confidence)
                 for (int wrongValue = 1; wrongValue <= size; ++wrongValue) {
@@ -557,20 +585,62 @@ void NeuroSymbolicSolver::trainOnSolution(const Board& originalBoard, const Boar
                         
                         // Generate symbolic hints for wrong moves too
                         std::vector<double> wrongHints = symbolicReasoner->generateSymbolicHints(originalBoard, row, col, wrongValue);
-                        neuralNet->updateWeights(originalBoard, row, col, wrongValue, false, wrongHints);
+                        network().updateWeights(originalBoard, row, col, wrongValue, false, wrongHints);
                     }
                 }
             }
         }
     }
     
-    // Auto-save the trained model
-    std::string modelPath = "models/neuro_symbolic_" + std::to_string(size) + "x" + std::to_string(size) + ".bin";
-    saveNetworkState(modelPath);
+    // Auto-save the trained model (batch trainers save once at the end instead)
+    if (autoSave) {
+        saveModel(size);
+    }
+}
+
+double NeuroSymbolicSolver::evaluateAccuracy(const std::vector<std::pair<Board, Board>>& validationSet) {
+    int correctMoves = 0;
+    int totalMoves = 0;
+    
+    for (const auto& pair : validationSet) {
+        const Board& puzzle = pair.first;
+        const Board& solution = pair.second;
+        int size = puzzle.getBoardSize();
+        network().adaptToBoardSize(size);
+        
+        for (int row = 0; row < size; ++row) {
+            for (int col = 0; col < size; ++col) {
+                if (puzzle.getCell(row, col).getValue() != 0) {
+                    continue;
+                }
+                
+                // Pick the valid value the pure network is most confident about
+                int bestValue = -1;
+                double bestConfidence = 0.0;
+                for (int value = 1; value <= size; ++value) {
+                    if (!symbolicReasoner->validateMove(puzzle, row, col, value)) {
+                        continue;
+                    }
+                    double confidence = network().predictMoveConfidencePure(puzzle, row, col, value);
+                    if (confidence > bestConfidence) {
+                        bestConfidence = confidence;
+                        bestValue = value;
+                    }
+                }
+                
+                if (bestValue == solution.getCell(row, col).getValue()) {
+                    correctMoves++;
+                }
+                totalMoves++;
+            }
+        }
+    }
+    
+    return totalMoves > 0 ? static_cast<double>(correctMoves) / totalMoves : 0.0;
 }
 
 void NeuroSymbolicSolver::adaptToBoardSize(int newSize) {
-    neuralNet->adaptToBoardSize(newSize);
+    network().adaptToBoardSize(newSize);
 }
 
 
@@ -578,7 +648,7 @@ void NeuroSymbolicSolver::adaptToBoardSize(int newSize) {
 void NeuroSymbolicSolver::learnFromError(const Board& board, const SolverMove& move, bool wasCorrect) {
     // Generate symbolic hints for learning from errors
     std::vector<double> hints = symbolicReasoner->generateSymbolicHints(board, move.row, move.col, move.value);
-    neuralNet->updateWeights(board, move.row, move.col, move.value, wasCorrect, hints);
+    network().updateWeights(board, move.row, move.col, move.value, wasCorrect, hints);
     
     if (wasCorrect) {
         correctPredictions++;
@@ -602,8 +672,8 @@ NeuroSymbolicSolver::CrossValidationResult NeuroSymbolicSolver::performCrossVali
     }
     
     if (verbose) {
-        std::cout << "🧪 Starting " << kFolds << "-fold cross-validation with " 
-                  << puzzleSolutionPairs.size() << " puzzle-solution pairs...\n";
+        SUDOKU_LOG_INFO("neuro_symbolic", "cross-validation start folds=" << kFolds
+                        << " pairs=" << puzzleSolutionPairs.size());
     }
     
     // Create k-folds
@@ -623,7 +693,7 @@ NeuroSymbolicSolver::CrossValidationResult NeuroSymbolicSolver::performCrossVali
     // Perform k-fold cross-validation
     for (int fold = 0; fold < kFolds; ++fold) {
         if (verbose) {
-            std::cout << "📊 Processing fold " << (fold + 1) << "/" << kFolds << "...\n";
+            SUDOKU_LOG_DEBUG("neuro_symbolic", "cross-validation fold=" << (fold + 1) << "/" << kFolds);
         }
         
         // Reset network for this fold
@@ -634,7 +704,8 @@ NeuroSymbolicSolver::CrossValidationResult NeuroSymbolicSolver::performCrossVali
         for (int trainFold = 0; trainFold < kFolds; ++trainFold) {
             if (trainFold != fold) {
                 for (const auto& pair : folds[trainFold]) {
-                    trainOnSolution(pair.first, pair.second);
+                    // A fold's network starts from scratch: saving it would replace the real model
+                    trainOnSolution(pair.first, pair.second, false);
                 }
             }
         }
@@ -652,8 +723,8 @@ NeuroSymbolicSolver::CrossValidationResult NeuroSymbolicSolver::performCrossVali
         totalSolveTime += foldTime;
         
         if (verbose) {
-            std::cout << "  ✅ Fold " << (fold + 1) << " accuracy: " 
-                      << std::fixed << std::setprecision(2) << (foldAccuracy * 100) << "%\n";
+            SUDOKU_LOG_INFO("neuro_symbolic", "cross-validation fold=" << (fold + 1)
+                            << " accuracy=" << std::fixed << std::setprecision(4) << foldAccuracy);
         }
     }
     
@@ -673,8 +744,8 @@ NeuroSymbolicSolver::CrossValidationResult NeuroSymbolicSolver::performCrossVali
     result.detailedReport = generateDetailedReport(result);
     
     if (verbose) {
-        std::cout << "\n🎯 Cross-Validation Results:\n";
-        std::cout << result.detailedReport << "\n";
+        SUDOKU_LOG_INFO("neuro_symbolic", "cross-validation done accuracy=" << result.accuracy
+                        << " report=" << result.detailedReport);
     }
     
     return result;
@@ -701,82 +772,106 @@ std::vector<std::vector<std::pair<Board, Board>>> NeuroSymbolicSolver::createKFo
 }
 
 double NeuroSymbolicSolver::testModelOnFold(const std::vector<std::pair<Board, Board>>& testFold, 
-                                           bool calculateMetrics) {
-    int correctMoves = 0;
-    int totalMoves = 0;
+                                           bool /*calculateMetrics*/) {
+    // Scores each empty cell once using the PURE neural network's best valid value
+    return evaluateAccuracy(testFold);
+}
+
+NeuroSymbolicSolver::PerformanceMetrics NeuroSymbolicSolver::calculatePerformanceMetrics(
+    const std::vector<std::pair<Board, Board>>& testSet, int tasks) {
+    VectorPuzzleSource source(testSet);
+    return calculatePerformanceMetrics(source, tasks);
+}
+
+NeuroSymbolicSolver::PerformanceMetrics NeuroSymbolicSolver::calculatePerformanceMetrics(
+    PuzzleSource& testSource, int tasks) {
+    
+    // Per-task confusion counters, merged once all tasks are done. Tasks count
+    // on their own stack (node-local, no false sharing) and publish once.
+    struct Counters {
+        int truePositives = 0;
+        int falsePositives = 0;
+        int trueNegatives = 0;
+        int falseNegatives = 0;
+        int puzzles = 0;
+        int predictions = 0;
+        double totalError = 0.0;
+    };
+    
+    Executor& executor = Executor::shared();
+    if (tasks <= 0) {
+        tasks = executor.getConcurrency();
+    }
     
-    for (const auto& pair : testFold) {
-        Board testBoard = pair.first;  // Puzzle
-        const Board& solution = pair.second;  // Known solution
-        
-        int size = testBoard.getBoardSize();
-        
-        // Test each empty cell
-        for (int row = 0; row < size; ++row) {
-            for (int col = 0; col < size; ++col) {
-                if (testBoard.getCell(row, col).getValue() == 0) {
-                    int correctValue = solution.getCell(row, col).getValue();
-                    
-                    // Get all possible moves for this position using PURE neural network
-                    std::vector<SolverMove> moves = getAllPossibleMovesPure(testBoard);
-                    
-                    // Find the move for this position with highest confidence
-                    SolverMove bestMove{-1, -1, -1, "", 0.0};
-                    for (const auto& move : moves) {
-                        if (move.row == row && move.col == col && move.confidence > bestMove.confidence) {
-                            bestMove = move;
-                        }
-                    }
-                    
-                    // Check if our prediction matches the correct solution
-                    if (bestMove.row != -1 && bestMove.value == correctValue) {
-                        correctMoves++;
+    // Inference below is read-only, so all workers share one network
+    const SudokuNeuralNetwork& net = network();
+    std::vector<Counters> perTask(tasks);
+    
+    TraceSession* trace = TraceSession::current();
+    auto worker = [&](Counters& counters) {
+        TraceThreadScope traceScope(trace);
+        SUDOKU_TRACE_SPAN("evaluate_worker");
+        std::pair<Board, Board> pair;
+        while (testSource.next(pair)) {
+            const Board& testBoard = pair.first;
+            const Board& solution = pair.second;
+            int size = testBoard.getBoardSize();
+            
+            // The network only understands the board size it was built for
+            if (size != net.getBoardSize()) {
+                continue;
+            }
+            counters.puzzles++;
+            
+            for (int row = 0; row < size; ++row) {
+                for (int col = 0; col < size; ++col) {
+                    if (testBoard.getCell(row, col).getValue() == 0) {
+                        int correctValue = solution.getCell(row, col).getValue();
+                        
+                        // Pure neural network prediction (no symbolic hints for true testing)
+                        double confidence = net.predictMoveConfidencePure(testBoard, row, col, correctValue);
+                        
+                        // Binary classification: high confidence (>0.5) = positive prediction
+                        bool predicted = confidence > 0.5;
+                        bool actual = true; // We're testing the correct value
+                        
+                        if (predicted && actual) counters.truePositives++;
+                        else if (predicted && !actual) counters.falsePositives++;
+                        else if (!predicted && actual) counters.falseNegatives++;
+                        else counters.trueNegatives++;
+                        
+                        // Calculate error for MAE
+                        counters.totalError += std::abs(1.0 - confidence); // Target is 1.0 for correct moves
+                        counters.predictions++;
                     }
-                    totalMoves++;
                 }
             }
         }
+    };
+    
+    TaskGroup group(TaskPriority::BACKGROUND, executor);
+    for (int i = 0; i < tasks; ++i) {
+        group.run([&worker, &perTask, i]() {
+            Counters counters;
+            worker(counters);
+            perTask[i] = counters;
+        });
     }
+    group.wait();
     
-    return totalMoves > 0 ? static_cast<double>(correctMoves) / totalMoves : 0.0;
-}
-
-NeuroSymbolicSolver::PerformanceMetrics NeuroSymbolicSolver::calculatePerformanceMetrics(
-    const std::vector<std::pair<Board, Board>>& testSet) {
-    
-    PerformanceMetrics metrics{0.0, 0.0, 0.0, 0.0, 0, 0, 0, 0};
-    
+    PerformanceMetrics metrics{0.0, 0.0, 0.0, 0.0, 0, 0, 0, 0, 0, tasks,
+                               std::min(tasks, executor.getConcurrency())};
     double totalError = 0.0;
     int totalPredictions = 0;
     
-    for (const auto& pair : testSet) {
-        Board testBoard = pair.first;
-        const Board& solution = pair.second;
-        int size = testBoard.getBoardSize();
-        
-        for (int row = 0; row < size; ++row) {
-            for (int col = 0; col < size; ++col) {
-                if (testBoard.getCell(row, col).getValue() == 0) {
-                    int correctValue = solution.getCell(row, col).getValue();
-                    
-                    // Pure neural network prediction (no symbolic hints for true testing)
-                    double confidence = neuralNet->predictMoveConfidencePure(testBoard, row, col, correctValue);
-                    
-                    // Binary classification: high confidence (>0.5) = positive prediction
-                    bool predicted = confidence > 0.5;
-                    bool actual = true; // We're testing the correct value
-                    
-                    if (predicted && actual) metrics.truePositives++;
-                    else if (predicted && !actual) metrics.falsePositives++;
-                    else if (!predicted && actual) metrics.falseNegatives++;
-                    else metrics.trueNegatives++;
-                    
-                    // Calculate error for MAE
-                    totalError += std::abs(1.0 - confidence); // Target is 1.0 for correct moves
-                    totalPredictions++;
-                }
-            }
-        }
+    for (const auto& counters : perTask) {
+        metrics.truePositives += counters.truePositives;
+        metrics.falsePositives += counters.falsePositives;
+        metrics.trueNegatives += counters.trueNegatives;
+        metrics.falseNegatives += counters.falseNegatives;
+        metrics.puzzlesEvaluated += counters.puzzles;
+        totalError += counters.totalError;
+        totalPredictions += counters.predictions;
     }
     
     // Calculate precision, recall, F1
@@ -895,6 +990,14 @@ void NeuroSymbolicSolver::resetNetwork() {
     totalPredictions = 0;
 }
 
+std::string NeuroSymbolicSolver::modelPathFor(int boardSize) {
+    return "models/neuro_symbolic_" + std::to_string(boardSize) + "x" + std::to_string(boardSize) + ".bin";
+}
+
+void NeuroSymbolicSolver::saveModel(int boardSize) {
+    saveNetworkState(modelPathFor(boardSize));
+}
+
 void NeuroSymbolicSolver::saveNetworkState(const std::string& filename) {
     try {
         // Create directory if it doesn't exist
@@ -903,20 +1006,27 @@ void NeuroSymbolicSolver::saveNetworkState(const std::string& filename) {
             std::filesystem::create_directories(filepath.parent_path());
         }
         
-        std::ofstream file(filename, std::ios::binary);
+        // Written beside the model and renamed over it, so a reader (or a
+        // crash) never sees a half-written model; the name is unique per
+        // writer so concurrent saves from other processes cannot interleave
+        static std::atomic<unsigned> saveCounter{0};
+        std::string temporary = filename + ".tmp." + std::to_string(::getpid()) + "." +
+                                std::to_string(saveCounter.fetch_add(1));
+        std::ofstream file(temporary, std::ios::binary | std::ios::trunc);
         if (!file.is_open()) {
-            std::cerr << "❌ Failed to open file for saving: " << filename << std::endl;
+            SUDOKU_LOG_ERROR("neuro_symbolic", "failed to open model for saving path=" << temporary);
             return;
         }
         
         // Save network metadata
-        int hiddenSize = neuralNet->getHiddenLayer().size();
-        int outputSize = neuralNet->getOutputLayer().size();
+        const SudokuNeuralNetwork& net = network();
+        int hiddenSize = net.getHiddenLayer().size();
+        int outputSize = net.getOutputLayer().size();
         file.write(reinterpret_cast<const char*>(&hiddenSize), sizeof(hiddenSize));
         file.write(reinterpret_cast<const char*>(&outputSize), sizeof(outputSize));
         
         // Save hidden layer weights and biases
-        for (const auto& neuron : neuralNet->getHiddenLayer()) {
+        for (const auto& neuron : net.getHiddenLayer()) {
             int weightCount = neuron.weights.size();
             file.write(reinterpret_cast<const char*>(&weightCount), sizeof(weightCount));
             file.write(reinterpret_cast<const char*>(neuron.weights.data()), 
@@ -925,7 +1035,7 @@ void NeuroSymbolicSolver::saveNetworkState(const std::string& filename) {
         }
         
         // Save output layer weights and biases
-        for (const auto& neuron : neuralNet->getOutputLayer()) {
+        for (const auto& neuron : net.getOutputLayer()) {
             int weightCount = neuron.weights.size();
             file.write(reinterpret_cast<const char*>(&weightCount), sizeof(weightCount));
             file.write(reinterpret_cast<const char*>(neuron.weights.data()), 
@@ -938,17 +1048,31 @@ void NeuroSymbolicSolver::saveNetworkState(const std::string& filename) {
         file.write(reinterpret_cast<const char*>(&totalPredictions), sizeof(totalPredictions));
         
         file.close();
-        std::cout << "💾 Neural network saved to: " << filename << std::endl;
+        int fd = ::open(temporary.c_str(), O_RDONLY | O_CLOEXEC);
+        bool durable = fd >= 0 && ::fsync(fd) == 0;
+        if (fd >= 0) {
+            ::close(fd);
+        }
+        if (file.fail() || !durable || ::rename(temporary.c_str(), filename.c_str()) != 0) {
+            SUDOKU_LOG_ERROR("neuro_symbolic", "failed to save model path=" << filename);
+            ::unlink(temporary.c_str());
+            return;
+        }
+        SUDOKU_LOG_DEBUG("neuro_symbolic", "model saved path=" << filename);
     } catch (const std::exception& e) {
-        std::cerr << "❌ Error saving network: " << e.what() << std::endl;
+        SUDOKU_LOG_ERROR("neuro_symbolic", "error saving model path=" << filename << " error=" << e.what());
     }
 }
 
 bool NeuroSymbolicSolver::loadNetworkState(const std::string& filename) {
+    if (!neuralNet) {
+        neuralNet = std::make_unique<SudokuNeuralNetwork>(initialBoardSize);
+    }
+    
     try {
         std::ifstream file(filename, std::ios::binary);
         if (!file.is_open()) {
-            std::cout << "📂 No saved network found at: " << filename << std::endl;
+            SUDOKU_LOG_DEBUG("neuro_symbolic", "no saved model path=" << filename);
             return false;
         }
         
@@ -960,9 +1084,10 @@ bool NeuroSymbolicSolver::loadNetworkState(const std::string& filename) {
         // Verify network architecture matches
         if (hiddenSize != static_cast<int>(neuralNet->getHiddenLayer().size()) || 
             outputSize != static_cast<int>(neuralNet->getOutputLayer().size())) {
-            std::cerr << "❌ Network architecture mismatch. Expected hidden: " 
-                     << neuralNet->getHiddenLayer().size() << ", output: " << neuralNet->getOutputLayer().size()
-                     << ". Found hidden: " << hiddenSize << ", output: " << outputSize << std::endl;
+            SUDOKU_LOG_ERROR("neuro_symbolic", "model architecture mismatch path=" << filename
+                             << " expected_hidden=" << neuralNet->getHiddenLayer().size()
+                             << " expected_output=" << neuralNet->getOutputLayer().size()
+                             << " found_hidden=" << hiddenSize << " found_output=" << outputSize);
             file.close();
             return false;
         }
@@ -973,7 +1098,7 @@ bool NeuroSymbolicSolver::loadNetworkState(const std::string& filename) {
             file.read(reinterpret_cast<char*>(&weightCount), sizeof(weightCount));
             
             if (weightCount != static_cast<int>(neuron.weights.size())) {
-                std::cerr << "❌ Weight count mismatch in hidden layer" << std::endl;
+                SUDOKU_LOG_ERROR("neuro_symbolic", "weight count mismatch layer=hidden path=" << filename);
                 file.close();
                 return false;
             }
@@ -989,7 +1114,7 @@ bool NeuroSymbolicSolver::loadNetworkState(const std::string& filename) {
             file.read(reinterpret_cast<char*>(&weightCount), sizeof(weightCount));
             
             if (weightCount != static_cast<int>(neuron.weights.size())) {
-                std::cerr << "❌ Weight count mismatch in output layer" << std::endl;
+                SUDOKU_LOG_ERROR("neuro_symbolic", "weight count mismatch layer=output path=" << filename);
                 file.close();
                 return false;
             }
@@ -1004,11 +1129,11 @@ bool NeuroSymbolicSolver::loadNetworkState(const std::string& filename) {
         file.read(reinterpret_cast<char*>(&totalPredictions), sizeof(totalPredictions));
         
         file.close();
-        std::cout << "📖 Neural network loaded from: " << filename 
-                 << " (Accuracy: " << correctPredictions << "/" << totalPredictions << ")" << std::endl;
+        SUDOKU_LOG_DEBUG("neuro_symbolic", "model loaded path=" << filename
+                         << " correct=" << correctPredictions << " total=" << totalPredictions);
         return true;
     } catch (const std::exception& e) {
-        std::cerr << "❌ Error loading network: " << e.what() << std::endl;
+        SUDOKU_LOG_ERROR("neuro_symbolic", "error loading model path=" << filename << " error=" << e.what());
         return false;
     }
 }
@@ -15,6 +15,7 @@ reasoning principles, creating a more interpretable and effective AI system.
 #define SUDOKU_NEURO_SYMBOLIC_SOLVER_H
 
 #include "solver_interface.h"
+#include "../model/puzzle_source.h"
 #include <vector>
 #include <map>
 #include <memory>
@@ -30,7 +31,8 @@ public:
                                 const std::vector<double>& symbolicHints = {});
     
     // Pure neural prediction without symbolic hints (for true testing)
-    double predictMoveConfidencePure(const Board& board, int row, int col, int value);
+    // Read-only: safe to call from several threads while no training runs
+    double predictMoveConfidencePure(const Board& board, int row, int col, int value) const;
     
     // Learn from successful moves (simplified training)
     void updateWeights(const Board& board, int row, int col, int value, bool wasCorrect,
@@ -41,6 +43,7 @@ public:
     
     // Adapt to new board size (reinitializes network)
     void adaptToBoardSize(int newSize);
+    int getBoardSize() const { return boardSize; }
 
 private:
     int boardSize;
@@ -59,10 +62,12 @@ private:
     
     // Extract features from board state around a cell (size-adaptive)
     std::vector<double> extractFeatures(const Board& board, int row, int col, int value,
-                                       const std::vector<double>& symbolicHints = {});
+                                       const std::vector<double>& symbolicHints = {}) const;
     
-    // Forward propagation
+    // Forward propagation (stores hidden activations for training)
     double forward(const std::vector<double>& features);
+    // Forward propagation into caller-owned activations (no shared state)
+    double forward(const std::vector<double>& features, std::vector<double>& hiddenOutputs) const;
     
     // Initialize network weights for current board size
     void initializeNetwork();
@@ -107,8 +112,10 @@ class NeuroSymbolicSolver : public SudokuSolver {
 public:
     explicit NeuroSymbolicSolver(int boardSize = 9);
     
-    // Core solving methods
-    bool solve(Board& board) override;
+    // Core solving methods; not reentrant (the network is loaded lazily and
+    // resized to the board), so each thread needs its own instance
+    using SudokuSolver::solve;
+    bool solve(Board& board, SolveContext& context) override;
     bool canSolve(const Board& board) const override;
     
     // Step-by-step solving with symbolic-informed neural network
@@ -125,8 +132,11 @@ public:
         return "Neural network enhanced with symbolic reasoning hints as input features"; 
     }
     
-    // Training interface
-    void trainOnSolution(const Board& originalBoard, const Board& solvedBoard);
+    // Training interface (autoSave persists the model after every call)
+    void trainOnSolution(const Board& originalBoard, const Board& solvedBoard, bool autoSave = true);
+    
+    // Per-cell accuracy of the pure neural network on a held-out set
+    double evaluateAccuracy(const std::vector<std::pair<Board, Board>>& validationSet);
     
     // Training mode control
     void setTrainingMode(bool training) { isTrainingMode = training; }
@@ -145,6 +155,7 @@ public:
         std::string detailedReport;
     };
     
+    // Retrains this network from scratch for every fold and never saves it
     CrossValidationResult performCrossValidation(const std::vector<std::pair<Board, Board>>& puzzleSolutionPairs,
                                                 int kFolds = 5, bool verbose = false);
     
@@ -158,14 +169,23 @@ public:
         int falsePositives;
         int trueNegatives;
         int falseNegatives;
+        int puzzlesEvaluated;
+        int tasksUsed;      // Evaluation tasks the test set was split over
+        int threadsUsed;    // Of those, how many can run at once on the shared pool
     };
     
-    PerformanceMetrics calculatePerformanceMetrics(const std::vector<std::pair<Board, Board>>& testSet);
+    // `tasks` workers share the test set; 0 = one per thread of the shared pool
+    PerformanceMetrics calculatePerformanceMetrics(const std::vector<std::pair<Board, Board>>& testSet,
+                                                   int tasks = 0);
+    // Streaming evaluation: pairs are pulled one at a time, memory stays constant
+    PerformanceMetrics calculatePerformanceMetrics(PuzzleSource& testSource, int tasks = 0);
     
     // Training utilities
     void resetNetwork();
     void saveNetworkState(const std::string& filename);
     bool loadNetworkState(const std::string& filename);
+    void saveModel(int boardSize = 9);
+    static std::string modelPathFor(int boardSize);
     
     // Adapt neural network to different board size
     void adaptToBoardSize(int newSize);
@@ -173,6 +193,10 @@ public:
 private:
     std::unique_ptr<SudokuNeuralNetwork> neuralNet;
     std::unique_ptr<SymbolicReasoner> symbolicReasoner;
+    int initialBoardSize;
+    
+    // Network accessor; builds it and loads the saved model on first use
+    SudokuNeuralNetwork& network();
     
     // Learning from mistakes
     void learnFromError(const Board& board, const SolverMove& move, bool wasCorrect);
@@ -7,9 +7,21 @@ Solver Factory Implementation
 #include "constraint_solver.h"
 #include "neuro_symbolic_solver.h"
 
-// Static member initialization
-std::map<std::string, SolverType> SolverFactory::nameToTypeMap;
-std::map<SolverType, std::string> SolverFactory::typeToNameMap;
+namespace {
+// Constant lookup table: lives in read-only data, nothing runs at startup
+struct SolverNameEntry {
+    const char* name;
+    SolverType type;
+};
+
+constexpr SolverNameEntry kSolverNames[] = {
+    {"backtrack", SolverType::BACKTRACK},
+    {"constraint", SolverType::CONSTRAINT},
+    {"heuristic", SolverType::HEURISTIC},
+    {"ai_neural", SolverType::AI_NEURAL},
+    {"neuro_symbolic", SolverType::NEURO_SYMBOLIC}
+};
+}
 
 std::unique_ptr<SudokuSolver> SolverFactory::createSolver(SolverType type) {
     switch (type) {
@@ -36,11 +48,9 @@ std::unique_ptr<SudokuSolver> SolverFactory::createSolver(SolverType type) {
 }
 
 std::unique_ptr<SudokuSolver> SolverFactory::createSolver(const std::string& name) {
-    initializeMaps();
-    
-    auto it = nameToTypeMap.find(name);
-    if (it != nameToTypeMap.end()) {
-        return createSolver(it->second);
+    SolverType type;
+    if (parseSolverType(name, type)) {
+        return createSolver(type);
     }
     
     return nullptr;
@@ -56,14 +66,9 @@ std::vector<SolverType> SolverFactory::getAvailableSolvers() {
 }
 
 std::vector<std::string> SolverFactory::getAvailableSolverNames() {
-    initializeMaps();
-    
     std::vector<std::string> names;
     for (auto type : getAvailableSolvers()) {
-        auto it = typeToNameMap.find(type);
-        if (it != typeToNameMap.end()) {
-            names.push_back(it->second);
-        }
+        names.push_back(getSolverTypeName(type));
     }
     
     return names;
@@ -103,18 +108,21 @@ SolverDifficulty SolverFactory::getSolverDifficulty(SolverType type) {
     }
 }
 
-void SolverFactory::initializeMaps() {
-    if (nameToTypeMap.empty()) {
-        nameToTypeMap["backtrack"] = SolverType::BACKTRACK;
-        nameToTypeMap["constraint"] = SolverType::CONSTRAINT;
-        nameToTypeMap["heuristic"] = SolverType::HEURISTIC;
-        nameToTypeMap["ai_neural"] = SolverType::AI_NEURAL;
-        nameToTypeMap["neuro_symbolic"] = SolverType::NEURO_SYMBOLIC;
-        
-        typeToNameMap[SolverType::BACKTRACK] = "backtrack";
-        typeToNameMap[SolverType::CONSTRAINT] = "constraint";
-        typeToNameMap[SolverType::HEURISTIC] = "heuristic";
-        typeToNameMap[SolverType::AI_NEURAL] = "ai_neural";
-        typeToNameMap[SolverType::NEURO_SYMBOLIC] = "neuro_symbolic";
+bool SolverFactory::parseSolverType(const std::string& name, SolverType& type) {
+    for (const auto& entry : kSolverNames) {
+        if (name == entry.name) {
+            type = entry.type;
+            return true;
+        }
+    }
+    return false;
+}
+
+std::string SolverFactory::getSolverTypeName(SolverType type) {
+    for (const auto& entry : kSolverNames) {
+        if (entry.type == type) {
+            return entry.name;
+        }
     }
+    return "unknown";
 }
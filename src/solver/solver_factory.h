@@ -9,8 +9,8 @@ Implements Factory Pattern for solver instantiation
 #include "solver_interface.h"
 #include "backtrack_solver.h"
 #include <memory>
-#include <map>
 #include <string>
+#include <vector>
 
 enum class SolverType {
     BACKTRACK,
@@ -35,12 +35,10 @@ public:
     // Get solver information without creating instance
     static std::string getSolverDescription(SolverType type);
     static SolverDifficulty getSolverDifficulty(SolverType type);
-
-private:
-    static std::map<std::string, SolverType> nameToTypeMap;
-    static std::map<SolverType, std::string> typeToNameMap;
     
-    static void initializeMaps();
+    // Name <-> type lookup backed by a constant table (no static initialisation)
+    static bool parseSolverType(const std::string& name, SolverType& type);
+    static std::string getSolverTypeName(SolverType type);
 };
 
 #endif // SUDOKU_SOLVER_FACTORY_H
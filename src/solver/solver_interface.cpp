@@ -4,6 +4,24 @@ Implementation of base SudokuSolver helper methods
 
 #include "solver_interface.h"
 
+SudokuSolver::SolveTimer::SolveTimer(SolveContext& context) : context(context) {
+    context.movesCount = 0;
+    context.solveTimeMs = 0.0;
+    context.counters = PerfSample();
+    if (context.collectCounters) {
+        PerfCounters::forThread().start();
+    }
+    start = std::chrono::high_resolution_clock::now();
+}
+
+SudokuSolver::SolveTimer::~SolveTimer() {
+    auto end = std::chrono::high_resolution_clock::now();
+    context.solveTimeMs = std::chrono::duration<double, std::milli>(end - start).count();
+    if (context.collectCounters) {
+        context.counters = PerfCounters::forThread().stop();
+    }
+}
+
 bool SudokuSolver::isValidMove(const Board& board, int row, int col, int value) const {
     if (value == 0) return true; // Empty cell is always valid
     
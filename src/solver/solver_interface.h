@@ -7,6 +7,9 @@ Implements Strategy Pattern for different solving algorithms
 #define SUDOKU_SOLVER_INTERFACE_H
 
 #include "../model/board.h"
+#include "../util/perf_counters.h"
+#include <chrono>
+#include <functional>
 #include <string>
 #include <vector>
 
@@ -28,13 +31,39 @@ struct SolverMove {
         : row(r), col(c), value(v), reasoning(reason), confidence(conf) {}
 };
 
+// Per-call state of one solve() - statistics and options for that call only.
+// Each thread (or request) owns its context; the solver object holds none of it.
+struct SolveContext {
+    int movesCount = 0;
+    double solveTimeMs = 0.0;
+    bool collectCounters = false;   // Sample hardware counters around the solve
+    PerfSample counters;
+    
+    // Live progress: onProgress(board, step) every progressInterval steps
+    // (placements) while the solve runs; 0 turns it off
+    int progressInterval = 0;
+    std::function<void(const Board&, int)> onProgress;
+    
+    void reportProgress(const Board& board, int step) const {
+        if (progressInterval > 0 && step % progressInterval == 0) {
+            onProgress(board, step);
+        }
+    }
+};
+
 // Abstract base class for all Sudoku solvers
 class SudokuSolver {
 public:
     virtual ~SudokuSolver() = default;
     
-    // Core solving methods
-    virtual bool solve(Board& board) = 0;
+    // Core solving method: every per-call value lives in `context`, so a
+    // solver whose isReentrant() is true can serve any number of threads at once
+    virtual bool solve(Board& board, SolveContext& context) = 0;
+    virtual bool isReentrant() const { return false; }
+    
+    // Convenience for single-threaded callers: solves into the solver's own
+    // context, read back through getMovesCount() etc.
+    bool solve(Board& board) { return solve(board, lastContext); }
     virtual bool canSolve(const Board& board) const = 0;
     
     // Step-by-step solving for visualization
@@ -46,16 +75,30 @@ public:
     virtual SolverDifficulty getDifficulty() const = 0;
     virtual std::string getDescription() const = 0;
     
-    // Performance metrics
-    virtual int getMovesCount() const { return movesCount; }
-    virtual double getSolveTimeMs() const { return solveTimeMs; }
+    // Performance metrics of the last solve(board)
+    virtual int getMovesCount() const { return lastContext.movesCount; }
+    virtual double getSolveTimeMs() const { return lastContext.solveTimeMs; }
+    
+    // Hardware counters for the last solve(board); only collected when enabled
+    void setCollectCounters(bool enable) { lastContext.collectCounters = enable; }
+    const PerfSample& getSolveCounters() const { return lastContext.counters; }
     
     // Reset solver state
-    virtual void reset() { movesCount = 0; solveTimeMs = 0.0; }
+    virtual void reset() { lastContext = SolveContext{0, 0.0, lastContext.collectCounters, PerfSample(), 0, nullptr}; }
 
 protected:
-    int movesCount = 0;
-    double solveTimeMs = 0.0;
+    SolveContext lastContext;
+    
+    // Starts a solve: clears the context's statistics, then measures the call
+    // into solveTimeMs (and counters when enabled)
+    class SolveTimer {
+    public:
+        explicit SolveTimer(SolveContext& context);
+        ~SolveTimer();
+    private:
+        SolveContext& context;
+        std::chrono::high_resolution_clock::time_point start;
+    };
     
     // Helper methods for derived classes
     bool isValidMove(const Board& board, int row, int col, int value) const;
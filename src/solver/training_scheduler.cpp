@@ -0,0 +1,147 @@
+/*
+Training Scheduler Implementation
+*/
+
+#include "training_scheduler.h"
+#include <algorithm>
+#include <chrono>
+
+namespace {
+const SudokuGenerator::Difficulty kCurriculum[] = {
+    SudokuGenerator::EASY,
+    SudokuGenerator::MEDIUM,
+    SudokuGenerator::HARD,
+    SudokuGenerator::EXPERT
+};
+const int kStageCount = 4;
+}
+
+TrainingScheduler::TrainingScheduler(NeuroSymbolicSolver& solver, SudokuGenerator& generator,
+                                     const Config& config)
+    : solver(solver), generator(generator), config(config), rng(std::random_device{}()) {
+    if (this->config.validationInterval <= 0) {
+        this->config.validationInterval = std::max(1, this->config.totalPuzzles / 10);
+    }
+}
+
+SudokuGenerator::Difficulty TrainingScheduler::stageDifficulty(int index, int total) {
+    if (total <= 0) {
+        return SudokuGenerator::EASY;
+    }
+    int stage = static_cast<int>(static_cast<long long>(index) * kStageCount / total);
+    return kCurriculum[std::min(std::max(stage, 0), kStageCount - 1)];
+}
+
+int TrainingScheduler::difficultyIndex(SudokuGenerator::Difficulty difficulty) {
+    for (int i = 0; i < kStageCount; ++i) {
+        if (kCurriculum[i] == difficulty) return i;
+    }
+    return 0;
+}
+
+std::string TrainingScheduler::difficultyName(SudokuGenerator::Difficulty difficulty) {
+    switch (difficulty) {
+        case SudokuGenerator::EASY: return "easy";
+        case SudokuGenerator::MEDIUM: return "medium";
+        case SudokuGenerator::HARD: return "hard";
+        case SudokuGenerator::EXPERT: return "expert";
+        default: return "unknown";
+    }
+}
+
+SudokuGenerator::Difficulty TrainingScheduler::pickDifficulty(int index) {
+    SudokuGenerator::Difficulty stage = stageDifficulty(index, config.totalPuzzles);
+    int stageIndex = difficultyIndex(stage);
+
+    // Occasionally replay an earlier stage so easy patterns are not forgotten
+    std::uniform_real_distribution<double> coin(0.0, 1.0);
+    if (stageIndex > 0 && coin(rng) < config.replayRate) {
+        std::uniform_int_distribution<int> earlier(0, stageIndex - 1);
+        return kCurriculum[earlier(rng)];
+    }
+    return stage;
+}
+
+bool TrainingScheduler::generatePair(SudokuGenerator::Difficulty difficulty, std::pair<Board, Board>& pair) {
+    Board completeBoard(config.gridSize);
+    if (!generator.generateCompleteGrid(completeBoard)) {
+        return false;
+    }
+
+    // Puzzle and solution come from the same grid (correct pairing)
+    Board puzzle = completeBoard;
+    if (!generator.createPuzzleFromCompleteGrid(puzzle, difficulty)) {
+        return false;
+    }
+
+    pair = std::make_pair(puzzle, completeBoard);
+    return true;
+}
+
+std::vector<std::pair<Board, Board>> TrainingScheduler::buildValidationSet() {
+    // Spread the held-out set evenly over all difficulties
+    std::vector<std::pair<Board, Board>> validationSet;
+    validationSet.reserve(config.validationPuzzles);
+
+    for (int i = 0; i < config.validationPuzzles; ++i) {
+        std::pair<Board, Board> pair;
+        if (generatePair(SudokuGenerator::difficultyForIndex(i), pair)) {
+            validationSet.push_back(std::move(pair));
+        }
+    }
+    return validationSet;
+}
+
+TrainingScheduler::Report TrainingScheduler::run() {
+    using Clock = std::chrono::high_resolution_clock;
+    Report report;
+
+    std::vector<std::pair<Board, Board>> validationSet = buildValidationSet();
+
+    auto validate = [&](SudokuGenerator::Difficulty difficulty) {
+        auto start = Clock::now();
+        double accuracy = solver.evaluateAccuracy(validationSet);
+        report.validationTimeMs += std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+
+        report.checkpoints.push_back({report.puzzlesTrained, report.trainingTimeMs, accuracy, difficulty});
+        if (!report.targetReached && accuracy >= config.targetAccuracy) {
+            report.targetReached = true;
+            report.puzzlesToTarget = report.puzzlesTrained;
+            report.timeToTargetMs = report.trainingTimeMs;
+        }
+        return accuracy;
+    };
+
+    report.initialAccuracy = validate(SudokuGenerator::EASY);
+
+    solver.setTrainingMode(true);
+    for (int i = 0; i < config.totalPuzzles; ++i) {
+        SudokuGenerator::Difficulty difficulty = pickDifficulty(i);
+
+        // Generation counts towards time-to-accuracy: it is part of producing the model
+        auto start = Clock::now();
+        std::pair<Board, Board> pair;
+        if (generatePair(difficulty, pair)) {
+            solver.trainOnSolution(pair.first, pair.second, false);
+            report.puzzlesTrained++;
+            report.puzzlesPerDifficulty[difficultyIndex(difficulty)]++;
+        } else {
+            report.failedPuzzles++;
+        }
+        report.trainingTimeMs += std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+
+        bool lastPuzzle = (i + 1 == config.totalPuzzles);
+        if ((i + 1) % config.validationInterval == 0 || lastPuzzle) {
+            validate(difficulty);
+        }
+    }
+    solver.setTrainingMode(false);
+
+    report.finalAccuracy = report.checkpoints.back().accuracy;
+
+    if (report.puzzlesTrained > 0) {
+        solver.saveModel(config.gridSize * config.gridSize);
+    }
+
+    return report;
+}
@@ -0,0 +1,71 @@
+/*
+Training Scheduler - Curriculum training for the neuro-symbolic solver
+Feeds puzzles from easy to hard, checks validation accuracy at fixed intervals
+and reports how long it took to reach a target accuracy.
+*/
+
+#ifndef SUDOKU_TRAINING_SCHEDULER_H
+#define SUDOKU_TRAINING_SCHEDULER_H
+
+#include "neuro_symbolic_solver.h"
+#include "../model/sudoku_generator.h"
+#include <random>
+#include <string>
+#include <utility>
+#include <vector>
+
+class TrainingScheduler {
+public:
+    struct Config {
+        int totalPuzzles = 100;
+        int validationInterval = 0;     // 0 = every 10% of the run
+        int validationPuzzles = 8;      // Held-out puzzles, generated once
+        double targetAccuracy = 0.5;
+        double replayRate = 0.25;       // Chance of revisiting an earlier stage
+        int gridSize = 3;               // 9x9 boards
+    };
+
+    // Validation accuracy measured at one point of the run
+    struct Checkpoint {
+        int puzzlesTrained;
+        double trainingTimeMs;          // Excludes time spent validating
+        double accuracy;
+        SudokuGenerator::Difficulty difficulty;
+    };
+
+    struct Report {
+        int puzzlesTrained = 0;
+        int failedPuzzles = 0;
+        double trainingTimeMs = 0.0;
+        double validationTimeMs = 0.0;
+        double initialAccuracy = 0.0;
+        double finalAccuracy = 0.0;
+        bool targetReached = false;
+        int puzzlesToTarget = -1;
+        double timeToTargetMs = -1.0;
+        std::vector<int> puzzlesPerDifficulty = std::vector<int>(4, 0);
+        std::vector<Checkpoint> checkpoints;
+    };
+
+    TrainingScheduler(NeuroSymbolicSolver& solver, SudokuGenerator& generator, const Config& config);
+
+    // Run the whole curriculum; the model is saved once at the end
+    Report run();
+
+    // Curriculum stage for puzzle `index` of `total` (EASY first, EXPERT last)
+    static SudokuGenerator::Difficulty stageDifficulty(int index, int total);
+    static int difficultyIndex(SudokuGenerator::Difficulty difficulty);
+    static std::string difficultyName(SudokuGenerator::Difficulty difficulty);
+
+private:
+    NeuroSymbolicSolver& solver;
+    SudokuGenerator& generator;
+    Config config;
+    std::mt19937 rng;
+
+    SudokuGenerator::Difficulty pickDifficulty(int index);
+    bool generatePair(SudokuGenerator::Difficulty difficulty, std::pair<Board, Board>& pair);
+    std::vector<std::pair<Board, Board>> buildValidationSet();
+};
+
+#endif // SUDOKU_TRAINING_SCHEDULER_H
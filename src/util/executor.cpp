@@ -0,0 +1,316 @@
+/*
+Executor implementation
+*/
+
+#include "executor.h"
+#include "logger.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <iterator>
+#include <pthread.h>
+#include <sched.h>
+#include <string>
+
+namespace {
+
+thread_local const Executor* currentExecutor = nullptr;
+thread_local int currentIndex = -1;
+thread_local int currentNodeId = -1;
+
+std::mutex sharedMutex;
+Executor* sharedExecutor = nullptr;
+Executor::Options sharedOptions;
+bool sharedConfigured = false;
+
+void runGuarded(const std::function<void()>& task) {
+    try {
+        task();
+    } catch (const std::exception& e) {
+        SUDOKU_LOG_ERROR("executor", "task threw: " << e.what());
+    } catch (...) {
+        SUDOKU_LOG_ERROR("executor", "task threw a non-standard exception");
+    }
+}
+
+}
+
+// ========== Executor ==========
+
+Executor& Executor::shared() {
+    std::lock_guard<std::mutex> lock(sharedMutex);
+    if (!sharedExecutor) {
+        Options options = sharedOptions;
+        if (!sharedConfigured) {
+            const char* threads = std::getenv("SUDOKU_THREADS");
+            const char* pin = std::getenv("SUDOKU_PIN_THREADS");
+            const char* numa = std::getenv("SUDOKU_NUMA");
+            if (threads) options.threads = std::atoi(threads);
+            options.pinThreads = pin && std::string(pin) == "1";
+            options.numaAware = !(numa && std::string(numa) == "0");
+        }
+        // Lives until exit like the logger; idle workers just sleep
+        sharedExecutor = new Executor(options);
+    }
+    return *sharedExecutor;
+}
+
+bool Executor::configureShared(const Options& options) {
+    std::lock_guard<std::mutex> lock(sharedMutex);
+    if (sharedExecutor) {
+        return false;
+    }
+    sharedOptions = options;
+    sharedConfigured = true;
+    return true;
+}
+
+Executor::Executor(const Options& options) : queued(0), stopping(false) {
+    int threads = options.threads;
+    if (threads <= 0) {
+        // The thread that submits work helps while it waits, so leave it a core
+        threads = std::max(1, static_cast<int>(std::thread::hardware_concurrency()) - 1);
+    }
+
+    const NumaTopology& topology = options.topology ? *options.topology : NumaTopology::system();
+    const std::vector<NumaNode>& nodes = topology.getNodes();
+    int nodeCount = options.numaAware ? topology.nodeCount() : 1;
+    std::vector<int> allCpus;
+    for (const NumaNode& node : nodes) {
+        allCpus.insert(allCpus.end(), node.cpus.begin(), node.cpus.end());
+    }
+
+    // Round-robin over nodes so every socket's cores and memory get used
+    std::vector<int> workerNodes(threads);
+    std::vector<std::vector<int>> workerCpus(threads);
+    for (int i = 0; i < threads; ++i) {
+        queues.emplace_back(new WorkerQueue());
+        if (nodeCount > 1) {
+            const NumaNode& node = nodes[i % nodeCount];
+            workerNodes[i] = node.id;
+            if (options.pinThreads) {
+                workerCpus[i] = {node.cpus[(i / nodeCount) % node.cpus.size()]};
+            } else {
+                workerCpus[i] = node.cpus;
+            }
+        } else {
+            workerNodes[i] = nodes.front().id;
+            if (options.pinThreads && !allCpus.empty()) {
+                workerCpus[i] = {allCpus[i % allCpus.size()]};
+            }
+        }
+    }
+
+    stealOrder.resize(threads);
+    for (int i = 0; i < threads; ++i) {
+        for (int pass = 0; pass < 2; ++pass) {
+            for (int offset = 1; offset < threads; ++offset) {
+                int victim = (i + offset) % threads;
+                if ((workerNodes[victim] == workerNodes[i]) == (pass == 0)) {
+                    stealOrder[i].push_back(victim);
+                }
+            }
+        }
+    }
+
+    for (int i = 0; i < threads; ++i) {
+        workers.emplace_back(&Executor::workerLoop, this, i, workerNodes[i], workerCpus[i]);
+    }
+    SUDOKU_LOG_DEBUG("executor", "started threads=" << threads << " nodes=" << nodeCount
+                     << " pinned=" << (options.pinThreads ? 1 : 0) << " topology=\"" << topology.describe() << "\"");
+}
+
+Executor::~Executor() {
+    {
+        std::lock_guard<std::mutex> lock(sleepMutex);
+        stopping = true;
+    }
+    wake.notify_all();
+    for (auto& worker : workers) {
+        worker.join();
+    }
+}
+
+int Executor::currentWorker() {
+    return currentIndex;
+}
+
+int Executor::currentNode() {
+    return currentNodeId;
+}
+
+void Executor::submit(std::function<void()> task, TaskPriority priority, const void* owner) {
+    int level = static_cast<int>(priority);
+    WorkerQueue& queue = currentExecutor == this ? *queues[currentIndex] : injection;
+    {
+        std::lock_guard<std::mutex> lock(queue.mutex);
+        queue.tasks[level].push_back(Task{std::move(task), owner});
+    }
+    queued.fetch_add(1);
+    {
+        // Pairs with the predicate check in workerLoop so a wakeup is never lost
+        std::lock_guard<std::mutex> lock(sleepMutex);
+    }
+    wake.notify_one();
+}
+
+bool Executor::tryRunOne(const void* owner) {
+    Task task;
+    if (!findTask(currentExecutor == this ? currentIndex : -1, task, owner)) {
+        return false;
+    }
+    runGuarded(task.run);
+    return true;
+}
+
+// Own deque (newest first), then the injection queue, then steal the oldest
+// task from another worker (same node first) - one priority level at a time.
+// With an owner, the first of that owner's tasks in the same order.
+bool Executor::findTask(int self, Task& task, const void* owner) {
+    // Takes from the back or front of `tasks`; the caller holds its queue's lock
+    auto take = [&](std::deque<Task>& tasks, bool newest) {
+        if (tasks.empty()) {
+            return false;
+        }
+        auto it = newest ? std::prev(tasks.end()) : tasks.begin();
+        if (owner) {
+            auto matches = [owner](const Task& candidate) { return candidate.owner == owner; };
+            if (newest) {
+                auto found = std::find_if(tasks.rbegin(), tasks.rend(), matches);
+                if (found == tasks.rend()) return false;
+                it = std::prev(found.base());
+            } else {
+                it = std::find_if(tasks.begin(), tasks.end(), matches);
+                if (it == tasks.end()) return false;
+            }
+        }
+        task = std::move(*it);
+        tasks.erase(it);
+        queued.fetch_sub(1);
+        return true;
+    };
+
+    int count = static_cast<int>(queues.size());
+    for (int level = 0; level < kPriorityCount; ++level) {
+        if (self >= 0) {
+            WorkerQueue& own = *queues[self];
+            std::lock_guard<std::mutex> lock(own.mutex);
+            if (take(own.tasks[level], true)) {
+                return true;
+            }
+        }
+        {
+            std::lock_guard<std::mutex> lock(injection.mutex);
+            if (take(injection.tasks[level], false)) {
+                return true;
+            }
+        }
+        for (int i = 0; i < (self >= 0 ? count - 1 : count); ++i) {
+            int victim = self >= 0 ? stealOrder[self][i] : i;
+            WorkerQueue& other = *queues[victim];
+            std::lock_guard<std::mutex> lock(other.mutex);
+            if (take(other.tasks[level], false)) {
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
+void Executor::workerLoop(int index, int node, std::vector<int> cpus) {
+    currentExecutor = this;
+    currentIndex = index;
+    currentNodeId = node;
+
+    if (!cpus.empty()) {
+        cpu_set_t set;
+        CPU_ZERO(&set);
+        for (int cpu : cpus) {
+            CPU_SET(cpu, &set);
+        }
+        if (pthread_setaffinity_np(pthread_self(), sizeof(set), &set) != 0) {
+            SUDOKU_LOG_WARN("executor", "cannot pin worker=" << index << " node=" << node);
+        }
+    }
+
+    Task task;
+    while (true) {
+        if (findTask(index, task)) {
+            runGuarded(task.run);
+            task.run = nullptr;
+            continue;
+        }
+        std::unique_lock<std::mutex> lock(sleepMutex);
+        wake.wait(lock, [&]() { return queued.load() > 0 || stopping; });
+        if (stopping && queued.load() == 0) {
+            return;
+        }
+    }
+}
+
+// ========== TaskGroup ==========
+
+TaskGroup::TaskGroup(TaskPriority priority, Executor& executor)
+    : executor(executor), priority(priority), pending(0) {}
+
+TaskGroup::~TaskGroup() {
+    waitForTasks();
+}
+
+void TaskGroup::run(std::function<void()> task) {
+    pending.fetch_add(1);
+    executor.submit([this, task]() {
+        try {
+            task();
+        } catch (...) {
+            std::lock_guard<std::mutex> lock(mutex);
+            if (!failure) failure = std::current_exception();
+        }
+        // Decrement under the lock: the group may be destroyed as soon as wait() sees zero
+        std::lock_guard<std::mutex> lock(mutex);
+        if (pending.fetch_sub(1) == 1) {
+            done.notify_all();
+        }
+    }, priority, this);
+}
+
+void TaskGroup::wait() {
+    waitForTasks();
+    std::lock_guard<std::mutex> lock(mutex);
+    if (failure) {
+        std::exception_ptr error = failure;
+        failure = nullptr;
+        std::rethrow_exception(error);
+    }
+}
+
+void TaskGroup::waitForTasks() {
+    while (pending.load() > 0) {
+        // Only our own tasks: running someone else's (maybe a long background
+        // task while we are interactive) would hold up our own completion
+        if (executor.tryRunOne(this)) {
+            continue;
+        }
+        std::unique_lock<std::mutex> lock(mutex);
+        done.wait_for(lock, std::chrono::milliseconds(1), [&]() { return pending.load() == 0; });
+    }
+    // Let the last task release the lock before the group can go away
+    std::lock_guard<std::mutex> lock(mutex);
+}
+
+// ========== parallelFor ==========
+
+void parallelFor(size_t begin, size_t end, const std::function<void(size_t)>& body,
+                 size_t grain, TaskPriority priority) {
+    grain = std::max<size_t>(1, grain);
+    TaskGroup group(priority);
+    for (size_t first = begin; first < end; first += grain) {
+        size_t last = std::min(end, first + grain);
+        group.run([&body, first, last]() {
+            for (size_t i = first; i < last; ++i) {
+                body(i);
+            }
+        });
+    }
+    group.wait();
+}
@@ -0,0 +1,145 @@
+/*
+Executor - process-wide work-stealing thread pool
+Every parallel path (batch solving, dataset collection, model evaluation)
+runs on the one shared pool instead of starting its own threads, so running
+several of them at once never oversubscribes the machine.
+
+Each worker owns one deque per priority: it pushes and pops its own tasks
+at the back and steals from the front of other workers' deques when it runs
+dry. Tasks submitted from outside the pool go to a shared injection queue.
+Higher priorities are always drained first, so interactive work overtakes
+background jobs such as training or evaluation.
+
+On multi-node machines workers are spread evenly over the NUMA nodes, kept
+on their node's CPUs, and steal from same-node workers before crossing
+nodes. State a task creates lazily on its worker (see currentWorker()) is
+therefore allocated on that worker's node.
+
+Size, pinning and NUMA placement come from Executor::configureShared()
+(before first use) or SUDOKU_THREADS, SUDOKU_PIN_THREADS=1, SUDOKU_NUMA=0.
+
+    TaskGroup group;
+    for (...) group.run([&]() { ... });
+    group.wait();                       // helps run the group's own tasks while waiting
+
+    parallelFor(0, n, [&](size_t i) { ... });
+*/
+
+#ifndef SUDOKU_UTIL_EXECUTOR_H
+#define SUDOKU_UTIL_EXECUTOR_H
+
+#include "numa_topology.h"
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+enum class TaskPriority {
+    HIGH = 0,         // Interactive requests
+    NORMAL = 1,       // Bulk work someone is waiting for (batch solving)
+    BACKGROUND = 2    // Training, evaluation, dataset building
+};
+
+class Executor {
+public:
+    struct Options {
+        int threads = 0;        // 0 = one per hardware thread, less the submitting thread
+        bool pinThreads = false; // Pin each worker to a single CPU
+        bool numaAware = true;  // Place workers per NUMA node (no effect on one node)
+        const NumaTopology* topology = nullptr;  // Defaults to NumaTopology::system()
+    };
+
+    static Executor& shared();
+
+    // Sets the shared pool's options; false if it is already running
+    static bool configureShared(const Options& options);
+
+    explicit Executor(const Options& options);
+    ~Executor();
+
+    Executor(const Executor&) = delete;
+    Executor& operator=(const Executor&) = delete;
+
+    // `owner` tags the task so tryRunOne(owner) can pick it out (TaskGroup)
+    void submit(std::function<void()> task, TaskPriority priority = TaskPriority::NORMAL,
+                const void* owner = nullptr);
+
+    // Runs one queued task on the calling thread; false if none was found.
+    // With an owner, only that owner's tasks qualify, so a waiting caller
+    // never picks up unrelated (possibly lower-priority, long) work.
+    bool tryRunOne(const void* owner = nullptr);
+
+    int getThreadCount() const { return static_cast<int>(workers.size()); }
+
+    // Threads that may run tasks at once: the workers plus one helping caller
+    int getConcurrency() const { return getThreadCount() + 1; }
+
+    // Index of the calling worker in its executor, or -1 outside any pool
+    static int currentWorker();
+
+    // NUMA node id of the calling worker, or -1 outside any pool
+    static int currentNode();
+
+private:
+    static const int kPriorityCount = 3;
+    struct Task {
+        std::function<void()> run;
+        const void* owner = nullptr;
+    };
+
+    struct alignas(64) WorkerQueue {
+        std::mutex mutex;
+        std::deque<Task> tasks[kPriorityCount];
+    };
+
+    std::vector<std::unique_ptr<WorkerQueue>> queues;
+    std::vector<std::vector<int>> stealOrder;   // Per worker: same-node victims first
+    WorkerQueue injection;
+    std::vector<std::thread> workers;
+    std::atomic<long> queued;
+    std::atomic<bool> stopping;
+    std::mutex sleepMutex;
+    std::condition_variable wake;
+
+    void workerLoop(int index, int node, std::vector<int> cpus);
+    bool findTask(int self, Task& task, const void* owner = nullptr);
+};
+
+// Set of tasks that can be waited for as a unit. The first exception thrown
+// by a task is rethrown from wait().
+class TaskGroup {
+public:
+    explicit TaskGroup(TaskPriority priority = TaskPriority::NORMAL, Executor& executor = Executor::shared());
+    ~TaskGroup();
+
+    TaskGroup(const TaskGroup&) = delete;
+    TaskGroup& operator=(const TaskGroup&) = delete;
+
+    void run(std::function<void()> task);
+
+    // Blocks until every task has finished, running the group's own queued
+    // tasks meanwhile (never other work, which may be of lower priority)
+    void wait();
+
+private:
+    Executor& executor;
+    TaskPriority priority;
+    std::atomic<long> pending;
+    std::mutex mutex;
+    std::condition_variable done;
+    std::exception_ptr failure;
+
+    void waitForTasks();
+};
+
+// Calls body(i) for every i in [begin, end), `grain` indices per task
+void parallelFor(size_t begin, size_t end, const std::function<void(size_t)>& body,
+                 size_t grain = 1, TaskPriority priority = TaskPriority::NORMAL);
+
+#endif // SUDOKU_UTIL_EXECUTOR_H
@@ -0,0 +1,210 @@
+/*
+Logger Implementation
+The ring buffer is a bounded multi-producer queue with per-slot sequence
+numbers: producers claim a position with a CAS and publish by bumping the
+slot's sequence, and the single writer thread consumes slots in order.
+*/
+
+#include "logger.h"
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <functional>
+
+namespace {
+
+LogLevel parseLevel(const char* text, LogLevel fallback) {
+    if (text == nullptr) return fallback;
+    std::string value(text);
+    if (value == "trace") return LogLevel::TRACE;
+    if (value == "debug") return LogLevel::DEBUG;
+    if (value == "info") return LogLevel::INFO;
+    if (value == "warn") return LogLevel::WARN;
+    if (value == "error") return LogLevel::ERROR;
+    if (value == "off") return LogLevel::OFF;
+    return fallback;
+}
+
+// Quote a logfmt value, escaping quotes, backslashes and newlines
+void appendQuoted(std::string& out, const std::string& value) {
+    out += '"';
+    for (char c : value) {
+        switch (c) {
+            case '"': out += "\\\""; break;
+            case '\\': out += "\\\\"; break;
+            case '\n': out += "\\n"; break;
+            case '\r': break;
+            default: out += c;
+        }
+    }
+    out += '"';
+}
+
+}
+
+Logger& Logger::instance() {
+    // Deliberately leaked so records logged from static destructors still have a home
+    static Logger* logger = new Logger();
+    return *logger;
+}
+
+Logger::Logger()
+    : slots(new Slot[kCapacity]), enqueuePos(0), dequeuePos(0), written(0), dropped(0),
+      runtimeLevel(static_cast<int>(parseLevel(std::getenv("SUDOKU_LOG_LEVEL"), LogLevel::INFO))),
+      sink(stderr), stopping(false) {
+    for (uint64_t i = 0; i < kCapacity; ++i) {
+        slots[i].sequence.store(i, std::memory_order_relaxed);
+    }
+
+    const char* path = std::getenv("SUDOKU_LOG_FILE");
+    if (path != nullptr && *path != '\0') {
+        FILE* file = std::fopen(path, "a");
+        if (file != nullptr) {
+            sink = file;
+        }
+    }
+}
+
+const char* Logger::levelName(LogLevel level) {
+    switch (level) {
+        case LogLevel::TRACE: return "trace";
+        case LogLevel::DEBUG: return "debug";
+        case LogLevel::INFO: return "info";
+        case LogLevel::WARN: return "warn";
+        case LogLevel::ERROR: return "error";
+        default: return "off";
+    }
+}
+
+void Logger::log(LogLevel level, const char* component, std::string message) {
+    if (stopping.load(std::memory_order_relaxed)) {
+        dropped.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+
+    // The writer thread only starts once something is actually logged
+    std::call_once(writerStarted, [this]() { startWriter(); });
+
+    uint64_t pos = enqueuePos.load(std::memory_order_relaxed);
+    Slot* slot;
+    while (true) {
+        slot = &slots[pos & (kCapacity - 1)];
+        uint64_t sequence = slot->sequence.load(std::memory_order_acquire);
+        int64_t diff = static_cast<int64_t>(sequence) - static_cast<int64_t>(pos);
+        if (diff == 0) {
+            if (enqueuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                break;
+            }
+        } else if (diff < 0) {
+            // Buffer full: drop instead of stalling a solver thread
+            dropped.fetch_add(1, std::memory_order_relaxed);
+            return;
+        } else {
+            pos = enqueuePos.load(std::memory_order_relaxed);
+        }
+    }
+
+    auto now = std::chrono::system_clock::now().time_since_epoch();
+    slot->record.timestampUs = std::chrono::duration_cast<std::chrono::microseconds>(now).count();
+    slot->record.level = level;
+    slot->record.component = component;
+    slot->record.threadId = std::hash<std::thread::id>{}(std::this_thread::get_id());
+    slot->record.message = std::move(message);
+    slot->sequence.store(pos + 1, std::memory_order_release);
+
+    if (level >= LogLevel::WARN) {
+        wake.notify_one();
+    }
+}
+
+void Logger::startWriter() {
+    writer = std::thread(&Logger::writerLoop, this);
+    std::atexit(&Logger::shutdown);
+}
+
+bool Logger::drainOnce() {
+    bool any = false;
+    while (true) {
+        Slot& slot = slots[dequeuePos & (kCapacity - 1)];
+        uint64_t sequence = slot.sequence.load(std::memory_order_acquire);
+        if (sequence != dequeuePos + 1) {
+            break;
+        }
+        writeRecord(slot.record);
+        slot.record.message.clear();
+        slot.sequence.store(dequeuePos + kCapacity, std::memory_order_release);
+        dequeuePos++;
+        written.fetch_add(1, std::memory_order_release);
+        any = true;
+    }
+    if (any) {
+        std::fflush(sink);
+    }
+    return any;
+}
+
+void Logger::writerLoop() {
+    while (!stopping.load(std::memory_order_acquire)) {
+        if (!drainOnce()) {
+            // Producers never take the mutex; the timeout bounds any missed wake-up
+            std::unique_lock<std::mutex> lock(wakeMutex);
+            wake.wait_for(lock, std::chrono::milliseconds(5));
+        }
+    }
+    drainOnce();
+}
+
+void Logger::writeRecord(const Record& record) {
+    std::time_t seconds = static_cast<std::time_t>(record.timestampUs / 1000000);
+    std::tm utc;
+    gmtime_r(&seconds, &utc);
+
+    char timestamp[40];
+    size_t length = std::strftime(timestamp, sizeof(timestamp), "%Y-%m-%dT%H:%M:%S", &utc);
+    std::snprintf(timestamp + length, sizeof(timestamp) - length, ".%06lldZ",
+                  static_cast<long long>(record.timestampUs % 1000000));
+
+    std::string line;
+    line.reserve(96 + record.message.size());
+    line += "ts=";
+    line += timestamp;
+    line += " level=";
+    line += levelName(record.level);
+    line += " component=";
+    line += record.component;
+    line += " tid=";
+    line += std::to_string(record.threadId % 100000);
+    line += " msg=";
+    appendQuoted(line, record.message);
+    line += '\n';
+
+    std::fwrite(line.data(), 1, line.size(), sink);
+}
+
+void Logger::flush() {
+    uint64_t target = enqueuePos.load(std::memory_order_acquire);
+    if (target == 0 || !writer.joinable()) {
+        return;
+    }
+    while (written.load(std::memory_order_acquire) + dropped.load(std::memory_order_relaxed) < target &&
+           !stopping.load(std::memory_order_acquire)) {
+        wake.notify_one();
+        std::this_thread::sleep_for(std::chrono::microseconds(200));
+    }
+}
+
+void Logger::shutdown() {
+    Logger& logger = instance();
+    logger.stopping.store(true, std::memory_order_release);
+    logger.wake.notify_one();
+    if (logger.writer.joinable()) {
+        logger.writer.join();
+    }
+
+    if (logger.dropped.load() > 0) {
+        std::fprintf(logger.sink, "ts=- level=warn component=logger msg=\"dropped %llu records\"\n",
+                     static_cast<unsigned long long>(logger.dropped.load()));
+    }
+    std::fflush(logger.sink);
+}
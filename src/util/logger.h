@@ -0,0 +1,121 @@
+/*
+Logger - leveled, structured diagnostics that never touch stdout
+Records go into a fixed-size lock-free ring buffer and are written by a
+background thread, so logging never blocks the caller (records are dropped
+and counted when the buffer is full). Output is one logfmt line per record
+on stderr, or in the file named by SUDOKU_LOG_FILE.
+
+Levels below SUDOKU_LOG_MIN_LEVEL are removed at compile time; the runtime
+level comes from SUDOKU_LOG_LEVEL (trace, debug, info, warn, error, off).
+
+    SUDOKU_LOG_INFO("neuro_symbolic", "model loaded path=" << path);
+*/
+
+#ifndef SUDOKU_UTIL_LOGGER_H
+#define SUDOKU_UTIL_LOGGER_H
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <cstdio>
+#include <memory>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <thread>
+
+enum class LogLevel {
+    TRACE = 0,
+    DEBUG = 1,
+    INFO = 2,
+    WARN = 3,
+    ERROR = 4,
+    OFF = 5
+};
+
+// Compile-time floor: release builds drop trace/debug statements entirely
+#ifndef SUDOKU_LOG_MIN_LEVEL
+#ifdef NDEBUG
+#define SUDOKU_LOG_MIN_LEVEL 2
+#else
+#define SUDOKU_LOG_MIN_LEVEL 0
+#endif
+#endif
+
+class Logger {
+public:
+    static Logger& instance();
+
+    bool isEnabled(LogLevel level) const {
+        return static_cast<int>(level) >= runtimeLevel.load(std::memory_order_relaxed);
+    }
+    void setLevel(LogLevel level) { runtimeLevel.store(static_cast<int>(level)); }
+
+    // Enqueue a record; never blocks, drops the record if the buffer is full
+    void log(LogLevel level, const char* component, std::string message);
+
+    // Wait until everything logged so far has been written
+    void flush();
+
+    uint64_t getDroppedCount() const { return dropped.load(); }
+
+    static const char* levelName(LogLevel level);
+
+private:
+    Logger();
+    ~Logger() = default;  // Never runs: the logger lives until exit, shut down via atexit
+
+    struct Record {
+        int64_t timestampUs;
+        LogLevel level;
+        const char* component;
+        uint64_t threadId;
+        std::string message;
+    };
+
+    struct Slot {
+        std::atomic<uint64_t> sequence;
+        Record record;
+    };
+
+    static constexpr uint64_t kCapacity = 4096;   // Must be a power of two
+
+    std::unique_ptr<Slot[]> slots;
+    std::atomic<uint64_t> enqueuePos;
+    uint64_t dequeuePos;                          // Writer thread only
+    std::atomic<uint64_t> written;
+    std::atomic<uint64_t> dropped;
+    std::atomic<int> runtimeLevel;
+
+    FILE* sink;
+    std::once_flag writerStarted;
+    std::thread writer;
+    std::atomic<bool> stopping;
+    std::mutex wakeMutex;
+    std::condition_variable wake;
+
+    void startWriter();
+    void writerLoop();
+    bool drainOnce();
+    void writeRecord(const Record& record);
+    static void shutdown();
+};
+
+#define SUDOKU_LOG(level, component, expr)                                          \
+    do {                                                                            \
+        if constexpr (static_cast<int>(level) >= SUDOKU_LOG_MIN_LEVEL) {            \
+            if (Logger::instance().isEnabled(level)) {                              \
+                std::ostringstream sudokuLogStream;                                 \
+                sudokuLogStream << expr;                                            \
+                Logger::instance().log(level, component, sudokuLogStream.str());    \
+            }                                                                       \
+        }                                                                           \
+    } while (0)
+
+#define SUDOKU_LOG_TRACE(component, expr) SUDOKU_LOG(LogLevel::TRACE, component, expr)
+#define SUDOKU_LOG_DEBUG(component, expr) SUDOKU_LOG(LogLevel::DEBUG, component, expr)
+#define SUDOKU_LOG_INFO(component, expr)  SUDOKU_LOG(LogLevel::INFO, component, expr)
+#define SUDOKU_LOG_WARN(component, expr)  SUDOKU_LOG(LogLevel::WARN, component, expr)
+#define SUDOKU_LOG_ERROR(component, expr) SUDOKU_LOG(LogLevel::ERROR, component, expr)
+
+#endif // SUDOKU_UTIL_LOGGER_H
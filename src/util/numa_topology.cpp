@@ -0,0 +1,114 @@
+/*
+NumaTopology implementation
+*/
+
+#include "numa_topology.h"
+#include <algorithm>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <sched.h>
+#include <sstream>
+#include <thread>
+
+namespace {
+
+std::vector<int> allowedCpus() {
+    std::vector<int> cpus;
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    if (sched_getaffinity(0, sizeof(set), &set) == 0) {
+        for (int cpu = 0; cpu < CPU_SETSIZE; ++cpu) {
+            if (CPU_ISSET(cpu, &set)) cpus.push_back(cpu);
+        }
+    }
+    if (cpus.empty()) {
+        int count = static_cast<int>(std::max(1u, std::thread::hardware_concurrency()));
+        for (int cpu = 0; cpu < count; ++cpu) cpus.push_back(cpu);
+    }
+    return cpus;
+}
+
+// "0-3,8" style, as in cpulist files
+std::string formatCpuList(const std::vector<int>& cpus) {
+    std::ostringstream out;
+    for (size_t i = 0; i < cpus.size();) {
+        size_t j = i;
+        while (j + 1 < cpus.size() && cpus[j + 1] == cpus[j] + 1) j++;
+        if (i > 0) out << ",";
+        out << cpus[i];
+        if (j > i) out << "-" << cpus[j];
+        i = j + 1;
+    }
+    return out.str();
+}
+
+}
+
+std::vector<int> parseCpuList(const std::string& list) {
+    std::vector<int> cpus;
+    std::istringstream in(list);
+    std::string range;
+    while (std::getline(in, range, ',')) {
+        if (range.empty() || range == "\n") continue;
+        char* end = nullptr;
+        long first = std::strtol(range.c_str(), &end, 10);
+        long last = first;
+        if (end && *end == '-') {
+            last = std::strtol(end + 1, nullptr, 10);
+        }
+        for (long cpu = first; cpu <= last && cpu >= 0 && cpu < CPU_SETSIZE; ++cpu) {
+            cpus.push_back(static_cast<int>(cpu));
+        }
+    }
+    std::sort(cpus.begin(), cpus.end());
+    cpus.erase(std::unique(cpus.begin(), cpus.end()), cpus.end());
+    return cpus;
+}
+
+const NumaTopology& NumaTopology::system() {
+    static const NumaTopology topology = detect();
+    return topology;
+}
+
+NumaTopology NumaTopology::detect(const std::string& nodeRoot) {
+    std::vector<int> allowed = allowedCpus();
+    NumaTopology topology;
+
+    std::error_code error;
+    for (const auto& entry : std::filesystem::directory_iterator(nodeRoot, error)) {
+        std::string name = entry.path().filename().string();
+        if (name.size() <= 4 || name.compare(0, 4, "node") != 0 ||
+            name.find_first_not_of("0123456789", 4) != std::string::npos) {
+            continue;
+        }
+        std::ifstream file(entry.path() / "cpulist");
+        std::string list;
+        if (!std::getline(file, list)) continue;
+
+        NumaNode node{std::atoi(name.c_str() + 4), {}};
+        for (int cpu : parseCpuList(list)) {
+            if (std::binary_search(allowed.begin(), allowed.end(), cpu)) node.cpus.push_back(cpu);
+        }
+        // Memory-only nodes, or nodes outside our cpuset, cannot host workers
+        if (!node.cpus.empty()) {
+            topology.nodes.push_back(std::move(node));
+        }
+    }
+
+    if (topology.nodes.empty()) {
+        topology.nodes.push_back({0, allowed});
+    }
+    std::sort(topology.nodes.begin(), topology.nodes.end(),
+              [](const NumaNode& a, const NumaNode& b) { return a.id < b.id; });
+    return topology;
+}
+
+std::string NumaTopology::describe() const {
+    std::ostringstream out;
+    for (size_t i = 0; i < nodes.size(); ++i) {
+        if (i > 0) out << " ";
+        out << "node" << nodes[i].id << "=" << formatCpuList(nodes[i].cpus);
+    }
+    return out.str();
+}
@@ -0,0 +1,46 @@
+/*
+NumaTopology - which CPUs belong to which NUMA node
+Read from sysfs (/sys/devices/system/node/node<N>/cpulist) and restricted to
+the CPUs this process may run on. Machines or containers without that
+information are treated as a single node holding every allowed CPU, so
+callers never need a special case.
+
+The executor uses this to keep workers on one node and to steal work from
+same-node workers first. Memory needs no explicit binding: Linux places a
+page on the node of the thread that first touches it, so state a worker
+allocates and initialises itself (solvers, boards, counters) is node-local.
+*/
+
+#ifndef SUDOKU_UTIL_NUMA_TOPOLOGY_H
+#define SUDOKU_UTIL_NUMA_TOPOLOGY_H
+
+#include <string>
+#include <vector>
+
+struct NumaNode {
+    int id;
+    std::vector<int> cpus;
+};
+
+class NumaTopology {
+public:
+    // Topology of this machine, detected once
+    static const NumaTopology& system();
+
+    // Reads a sysfs-style node directory; any problem yields a single node
+    static NumaTopology detect(const std::string& nodeRoot = "/sys/devices/system/node");
+
+    const std::vector<NumaNode>& getNodes() const { return nodes; }
+    int nodeCount() const { return static_cast<int>(nodes.size()); }
+
+    // "node0=0-3,8-11 node1=4-7,12-15"
+    std::string describe() const;
+
+private:
+    std::vector<NumaNode> nodes;
+};
+
+// Parses a kernel CPU list such as "0-3,8,10-11"
+std::vector<int> parseCpuList(const std::string& list);
+
+#endif // SUDOKU_UTIL_NUMA_TOPOLOGY_H
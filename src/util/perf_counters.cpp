@@ -0,0 +1,212 @@
+/*
+PerfCounters Implementation
+*/
+
+#include "perf_counters.h"
+#include <cstring>
+#include <ctime>
+#include <fstream>
+#include <sstream>
+
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace {
+
+#ifdef __linux__
+struct CounterSpec {
+    uint32_t type;
+    uint64_t config;
+};
+
+const CounterSpec kCounterSpecs[PerfCounters::COUNTER_COUNT] = {
+    {PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES},
+    {PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS},
+    {PERF_TYPE_HW_CACHE, PERF_COUNT_HW_CACHE_L1D |
+                         (PERF_COUNT_HW_CACHE_OP_READ << 8) |
+                         (PERF_COUNT_HW_CACHE_RESULT_MISS << 16)},
+    {PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES},
+    {PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES}
+};
+
+int openCounter(const CounterSpec& spec) {
+    perf_event_attr attr;
+    std::memset(&attr, 0, sizeof(attr));
+    attr.size = sizeof(attr);
+    attr.type = spec.type;
+    attr.config = spec.config;
+    attr.disabled = 1;
+    attr.exclude_kernel = 1;   // Allowed at perf_event_paranoid <= 2
+    attr.exclude_hv = 1;
+    attr.read_format = PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+
+    return static_cast<int>(syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0));
+}
+
+// Scale for multiplexing when the kernel could not keep the counter on the PMU
+int64_t readCounter(int fd) {
+    uint64_t values[3] = {0, 0, 0};
+    if (read(fd, values, sizeof(values)) != static_cast<ssize_t>(sizeof(values))) {
+        return -1;
+    }
+    if (values[2] == 0) {
+        return values[1] == 0 ? 0 : -1;
+    }
+    if (values[2] < values[1]) {
+        return static_cast<int64_t>(static_cast<double>(values[0]) * values[1] / values[2]);
+    }
+    return static_cast<int64_t>(values[0]);
+}
+#endif
+
+double perKilo(int64_t events, int64_t instructions) {
+    if (events < 0 || instructions <= 0) return -1.0;
+    return 1000.0 * events / instructions;
+}
+
+void addCounter(int64_t& total, int64_t value) {
+    total = (total < 0 || value < 0) ? -1 : total + value;
+}
+
+void appendCounter(std::ostringstream& json, const char* name, int64_t value, bool first = false) {
+    if (!first) json << ",";
+    json << "\"" << name << "\":";
+    if (value < 0) json << "null";
+    else json << value;
+}
+
+}
+
+// ============================================================================
+// PerfSample
+// ============================================================================
+
+bool PerfSample::hasAny() const {
+    return cycles >= 0 || instructions >= 0 || l1dMisses >= 0 || llcMisses >= 0 || branchMisses >= 0;
+}
+
+double PerfSample::instructionsPerCycle() const {
+    if (instructions < 0 || cycles <= 0) return -1.0;
+    return static_cast<double>(instructions) / cycles;
+}
+
+double PerfSample::l1dMissesPerKiloInstruction() const {
+    return perKilo(l1dMisses, instructions);
+}
+
+double PerfSample::llcMissesPerKiloInstruction() const {
+    return perKilo(llcMisses, instructions);
+}
+
+double PerfSample::branchMissesPerKiloInstruction() const {
+    return perKilo(branchMisses, instructions);
+}
+
+PerfSample& PerfSample::operator+=(const PerfSample& other) {
+    addCounter(cycles, other.cycles);
+    addCounter(instructions, other.instructions);
+    addCounter(l1dMisses, other.l1dMisses);
+    addCounter(llcMisses, other.llcMisses);
+    addCounter(branchMisses, other.branchMisses);
+    return *this;
+}
+
+std::string PerfSample::toJson() const {
+    std::ostringstream json;
+    json << "{";
+    appendCounter(json, "cycles", cycles, true);
+    appendCounter(json, "instructions", instructions);
+    appendCounter(json, "l1d_misses", l1dMisses);
+    appendCounter(json, "llc_misses", llcMisses);
+    appendCounter(json, "branch_misses", branchMisses);
+    json << "}";
+    return json.str();
+}
+
+// ============================================================================
+// PerfCounters
+// ============================================================================
+
+PerfCounters::PerfCounters() {
+    for (int i = 0; i < COUNTER_COUNT; ++i) {
+#ifdef __linux__
+        fds[i] = openCounter(kCounterSpecs[i]);
+#else
+        fds[i] = -1;
+#endif
+    }
+}
+
+PerfCounters::~PerfCounters() {
+#ifdef __linux__
+    for (int fd : fds) {
+        if (fd >= 0) close(fd);
+    }
+#endif
+}
+
+bool PerfCounters::isAvailable() const {
+    for (int fd : fds) {
+        if (fd >= 0) return true;
+    }
+    return false;
+}
+
+void PerfCounters::start() {
+#ifdef __linux__
+    for (int fd : fds) {
+        if (fd < 0) continue;
+        ioctl(fd, PERF_EVENT_IOC_RESET, 0);
+        ioctl(fd, PERF_EVENT_IOC_ENABLE, 0);
+    }
+#endif
+}
+
+PerfSample PerfCounters::stop() {
+    PerfSample sample;
+#ifdef __linux__
+    for (int fd : fds) {
+        if (fd >= 0) ioctl(fd, PERF_EVENT_IOC_DISABLE, 0);
+    }
+    int64_t* targets[COUNTER_COUNT] = {
+        &sample.cycles, &sample.instructions, &sample.l1dMisses, &sample.llcMisses, &sample.branchMisses
+    };
+    for (int i = 0; i < COUNTER_COUNT; ++i) {
+        if (fds[i] >= 0) *targets[i] = readCounter(fds[i]);
+    }
+#endif
+    return sample;
+}
+
+PerfCounters& PerfCounters::forThread() {
+    thread_local PerfCounters counters;
+    return counters;
+}
+
+std::string PerfCounters::unavailableReason() {
+#ifdef __linux__
+    std::ifstream paranoid("/proc/sys/kernel/perf_event_paranoid");
+    int level = 0;
+    if (paranoid >> level) {
+        if (level > 2) {
+            return "perf_event_paranoid=" + std::to_string(level) + " (needs <= 2)";
+        }
+        return "no hardware PMU exposed (perf_event_paranoid=" + std::to_string(level) + ")";
+    }
+    return "perf_event_open not supported by this kernel";
+#else
+    return "perf_event_open is Linux-only";
+#endif
+}
+
+double threadCpuTimeMs() {
+    timespec now;
+    if (clock_gettime(CLOCK_THREAD_CPUTIME_ID, &now) != 0) {
+        return 0.0;
+    }
+    return static_cast<double>(now.tv_sec) * 1000.0 + static_cast<double>(now.tv_nsec) / 1e6;
+}
@@ -0,0 +1,67 @@
+/*
+PerfCounters - hardware performance counters via Linux perf_event_open
+Counts cycles, instructions, L1 data cache misses, last-level cache misses
+and branch misses for the calling thread (user space only). Each counter is
+opened on its own, so a counter the CPU or hypervisor does not expose is
+simply reported as unavailable (-1) instead of disabling the rest. When
+perf_event_open is not permitted at all every value is -1.
+*/
+
+#ifndef SUDOKU_UTIL_PERF_COUNTERS_H
+#define SUDOKU_UTIL_PERF_COUNTERS_H
+
+#include <cstdint>
+#include <string>
+
+struct PerfSample {
+    int64_t cycles = -1;
+    int64_t instructions = -1;
+    int64_t l1dMisses = -1;
+    int64_t llcMisses = -1;
+    int64_t branchMisses = -1;
+
+    bool hasAny() const;
+
+    // Derived ratios; negative when the inputs are unavailable
+    double instructionsPerCycle() const;
+    double l1dMissesPerKiloInstruction() const;
+    double llcMissesPerKiloInstruction() const;
+    double branchMissesPerKiloInstruction() const;
+
+    // Accumulate another sample (unavailable stays unavailable)
+    PerfSample& operator+=(const PerfSample& other);
+
+    // {"cycles":...,"instructions":...} with null for unavailable counters
+    std::string toJson() const;
+};
+
+class PerfCounters {
+public:
+    enum Counter { CYCLES, INSTRUCTIONS, L1D_MISSES, LLC_MISSES, BRANCH_MISSES, COUNTER_COUNT };
+
+    PerfCounters();
+    ~PerfCounters();
+
+    PerfCounters(const PerfCounters&) = delete;
+    PerfCounters& operator=(const PerfCounters&) = delete;
+
+    bool isAvailable() const;
+
+    void start();
+    PerfSample stop();
+
+    // Lazily opened counters for the calling thread, reused across solves
+    static PerfCounters& forThread();
+
+    // Why counters are missing, e.g. "perf_event_paranoid=3"
+    static std::string unavailableReason();
+
+private:
+    int fds[COUNTER_COUNT];
+};
+
+// CPU time the calling thread has consumed so far (CLOCK_THREAD_CPUTIME_ID), in ms.
+// Unlike the hardware counters this is always available.
+double threadCpuTimeMs();
+
+#endif // SUDOKU_UTIL_PERF_COUNTERS_H
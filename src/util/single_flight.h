@@ -0,0 +1,89 @@
+/*
+SingleFlight - collapse concurrent identical calls into one
+The first caller for a key runs the computation; callers that arrive with
+the same key while it is still running wait for that result instead of
+computing their own. Once the call finishes the key is forgotten, so this
+is coalescing, not caching: a later request computes afresh.
+
+Exceptions thrown by the computation reach every waiting caller. Values are
+handed to all callers by copy, so share large results through a
+shared_ptr<const T>.
+*/
+
+#ifndef SUDOKU_UTIL_SINGLE_FLIGHT_H
+#define SUDOKU_UTIL_SINGLE_FLIGHT_H
+
+#include <atomic>
+#include <cstdint>
+#include <exception>
+#include <future>
+#include <mutex>
+#include <optional>
+#include <unordered_map>
+
+template <typename Key, typename Value, typename Hash = std::hash<Key>>
+class SingleFlight {
+public:
+    // Runs compute() or joins the running call for key; *joined tells which
+    template <typename Compute>
+    Value run(const Key& key, Compute&& compute, bool* joined = nullptr) {
+        std::promise<Value> promise;
+        std::shared_future<Value> running;
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            auto it = calls.find(key);
+            if (it != calls.end()) {
+                running = it->second;
+            } else {
+                calls.emplace(key, promise.get_future().share());
+            }
+        }
+
+        if (running.valid()) {
+            sharedCalls.fetch_add(1, std::memory_order_relaxed);
+            if (joined) *joined = true;
+            return running.get();
+        }
+        if (joined) *joined = false;
+
+        try {
+            Value value = compute();
+            finish(key);
+            promise.set_value(value);
+            return value;
+        } catch (...) {
+            finish(key);
+            promise.set_exception(std::current_exception());
+            throw;
+        }
+    }
+
+    // The running call for key, joined, or nothing when none is running.
+    // Lets a caller do its own setup (e.g. admission) only when it is going
+    // to compute, then lead through run(); a call started in between is
+    // joined there instead.
+    std::optional<std::shared_future<Value>> tryJoin(const Key& key) {
+        std::lock_guard<std::mutex> lock(mutex);
+        auto it = calls.find(key);
+        if (it == calls.end()) {
+            return std::nullopt;
+        }
+        sharedCalls.fetch_add(1, std::memory_order_relaxed);
+        return it->second;
+    }
+
+    // Calls that reused another caller's result
+    uint64_t getSharedCount() const { return sharedCalls.load(std::memory_order_relaxed); }
+
+private:
+    void finish(const Key& key) {
+        std::lock_guard<std::mutex> lock(mutex);
+        calls.erase(key);
+    }
+
+    std::mutex mutex;
+    std::unordered_map<Key, std::shared_future<Value>, Hash> calls;
+    std::atomic<uint64_t> sharedCalls{0};
+};
+
+#endif // SUDOKU_UTIL_SINGLE_FLIGHT_H
@@ -0,0 +1,77 @@
+/*
+SpscQueue - bounded lock-free single-producer/single-consumer ring
+One thread pushes, one thread pops; neither ever takes a lock. Head and tail
+live on separate cache lines so producer and consumer do not false-share.
+Capacity is rounded up to a power of two.
+*/
+
+#ifndef SUDOKU_UTIL_SPSC_QUEUE_H
+#define SUDOKU_UTIL_SPSC_QUEUE_H
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <thread>
+#include <vector>
+
+template <typename T>
+class SpscQueue {
+public:
+    explicit SpscQueue(size_t minCapacity) : head(0), tail(0) {
+        size_t capacity = 1;
+        while (capacity < minCapacity) capacity <<= 1;
+        slots.resize(capacity);
+        mask = capacity - 1;
+    }
+
+    // Producer only; false when full
+    bool tryPush(const T& value) {
+        size_t t = tail.load(std::memory_order_relaxed);
+        if (t - head.load(std::memory_order_acquire) > mask) {
+            return false;
+        }
+        slots[t & mask] = value;
+        tail.store(t + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Consumer only; false when empty
+    bool tryPop(T& value) {
+        size_t h = head.load(std::memory_order_relaxed);
+        if (h == tail.load(std::memory_order_acquire)) {
+            return false;
+        }
+        value = slots[h & mask];
+        head.store(h + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Blocking variants: spin briefly, then back off to short sleeps
+    void push(const T& value) {
+        for (int spins = 0; !tryPush(value); ++spins) {
+            backoff(spins);
+        }
+    }
+
+    void pop(T& value) {
+        for (int spins = 0; !tryPop(value); ++spins) {
+            backoff(spins);
+        }
+    }
+
+private:
+    std::vector<T> slots;
+    size_t mask;
+    alignas(64) std::atomic<size_t> head;
+    alignas(64) std::atomic<size_t> tail;
+
+    static void backoff(int spins) {
+        if (spins < 64) {
+            std::this_thread::yield();
+        } else {
+            std::this_thread::sleep_for(std::chrono::microseconds(50));
+        }
+    }
+};
+
+#endif // SUDOKU_UTIL_SPSC_QUEUE_H
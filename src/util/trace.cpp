@@ -0,0 +1,177 @@
+/*
+Request Tracing Implementation
+*/
+
+#include "trace.h"
+#include "logger.h"
+#include <cctype>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <random>
+#include <sstream>
+#include <unistd.h>
+
+namespace {
+
+thread_local TraceSession* activeSession = nullptr;
+thread_local std::vector<TraceEvent>* activeEvents = nullptr;
+
+double sampleRateFromEnv() {
+    const char* text = std::getenv("SUDOKU_TRACE_SAMPLE");
+    if (text == nullptr) return 0.0;
+    double rate = std::atof(text);
+    return rate < 0.0 ? 0.0 : (rate > 1.0 ? 1.0 : rate);
+}
+
+void appendEscaped(std::ostringstream& out, const std::string& value) {
+    for (char c : value) {
+        if (c == '"' || c == '\\') out << '\\';
+        if (static_cast<unsigned char>(c) >= 0x20) out << c;
+    }
+}
+
+}
+
+int64_t TraceSession::nowUs() {
+    auto now = std::chrono::steady_clock::now().time_since_epoch();
+    return std::chrono::duration_cast<std::chrono::microseconds>(now).count();
+}
+
+bool TraceSession::shouldTrace(bool forced) {
+    if (forced) return true;
+
+    const char* flag = std::getenv("SUDOKU_TRACE");
+    if (flag != nullptr && std::string(flag) == "1") return true;
+
+    static const double sampleRate = sampleRateFromEnv();
+    if (sampleRate <= 0.0) return false;
+
+    thread_local std::mt19937 rng(std::random_device{}());
+    return std::uniform_real_distribution<double>(0.0, 1.0)(rng) < sampleRate;
+}
+
+TraceSession* TraceSession::current() {
+    return activeSession;
+}
+
+TraceSession::TraceSession(const std::string& requestName, bool enabled)
+    : requestName(requestName), enabled(enabled), finished(false), startUs(nowUs()), endUs(0),
+      previousSession(activeSession), previousEvents(activeEvents) {
+    if (enabled) {
+        activeSession = this;
+        activeEvents = attachThread();
+    }
+}
+
+TraceSession::~TraceSession() {
+    if (enabled && !finished) {
+        finish();
+    }
+    if (enabled) {
+        activeSession = previousSession;
+        activeEvents = previousEvents;
+    }
+}
+
+std::vector<TraceEvent>* TraceSession::attachThread() {
+    std::lock_guard<std::mutex> lock(buffersMutex);
+    buffers.push_back(std::make_unique<std::vector<TraceEvent>>());
+    buffers.back()->reserve(64);
+    return buffers.back().get();
+}
+
+std::string TraceSession::toJson() const {
+    std::lock_guard<std::mutex> lock(buffersMutex);
+    int pid = static_cast<int>(getpid());
+    int64_t end = endUs != 0 ? endUs : nowUs();
+
+    std::ostringstream json;
+    json << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+    json << "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":" << pid
+         << ",\"tid\":0,\"args\":{\"name\":\"sudoku\"}}";
+
+    // Buffer index doubles as the thread id: 0 is the request thread, the rest are workers
+    for (size_t tid = 0; tid < buffers.size(); ++tid) {
+        json << ",{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":" << pid << ",\"tid\":" << tid
+             << ",\"args\":{\"name\":\"" << (tid == 0 ? "request" : "worker " + std::to_string(tid)) << "\"}}";
+    }
+
+    json << ",{\"name\":\"";
+    appendEscaped(json, requestName);
+    json << "\",\"cat\":\"request\",\"ph\":\"X\",\"ts\":0,\"dur\":" << (end - startUs)
+         << ",\"pid\":" << pid << ",\"tid\":0}";
+
+    for (size_t tid = 0; tid < buffers.size(); ++tid) {
+        for (const TraceEvent& event : *buffers[tid]) {
+            json << ",{\"name\":\"" << event.name << "\",\"cat\":\"" << event.category
+                 << "\",\"ph\":\"X\",\"ts\":" << (event.startUs - startUs)
+                 << ",\"dur\":" << event.durationUs
+                 << ",\"pid\":" << pid << ",\"tid\":" << tid << "}";
+        }
+    }
+
+    json << "]}";
+    return json.str();
+}
+
+std::string TraceSession::finish() {
+    if (!enabled || finished) {
+        return "";
+    }
+    finished = true;
+    endUs = nowUs();
+
+    const char* dirEnv = std::getenv("SUDOKU_TRACE_DIR");
+    std::filesystem::path dir = (dirEnv != nullptr && *dirEnv != '\0') ? dirEnv : "traces";
+
+    std::string safeName;
+    for (char c : requestName) {
+        safeName += (std::isalnum(static_cast<unsigned char>(c)) || c == '_') ? c : '-';
+    }
+    auto wallUs = std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count();
+    std::filesystem::path path = dir / (safeName + "-" + std::to_string(wallUs) + "-" +
+                                        std::to_string(getpid()) + ".json");
+
+    std::error_code error;
+    std::filesystem::create_directories(dir, error);
+    std::ofstream file(path);
+    if (!file.is_open()) {
+        SUDOKU_LOG_WARN("trace", "cannot write trace path=" << path.string());
+        return "";
+    }
+    file << toJson();
+    file.close();
+
+    SUDOKU_LOG_INFO("trace", "trace written request=" << requestName << " path=" << path.string()
+                    << " duration_us=" << (endUs - startUs));
+    return path.string();
+}
+
+TraceThreadScope::TraceThreadScope(TraceSession* session)
+    : previousSession(activeSession), previousEvents(activeEvents) {
+    // The request thread may run a share of the work itself; keep its buffer
+    if (session != nullptr && session->isEnabled() && session != activeSession) {
+        activeSession = session;
+        activeEvents = session->attachThread();
+    }
+}
+
+TraceThreadScope::~TraceThreadScope() {
+    activeSession = previousSession;
+    activeEvents = previousEvents;
+}
+
+TraceSpan::TraceSpan(const char* name, const char* category)
+    : events(activeEvents), name(name), category(category), startUs(0) {
+    if (events != nullptr) {
+        startUs = TraceSession::nowUs();
+    }
+}
+
+TraceSpan::~TraceSpan() {
+    if (events != nullptr) {
+        events->push_back({name, category, startUs, TraceSession::nowUs() - startUs});
+    }
+}
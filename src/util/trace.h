@@ -0,0 +1,108 @@
+/*
+Request tracing - scoped spans dumped as Chrome trace-event JSON
+A TraceSession covers one request. While it is active, TraceSpan objects on
+the owning thread (and on worker threads attached with TraceThreadScope)
+append complete events to their own per-thread buffer, so recording never
+takes a lock. finish() writes the events in the trace-event format that
+chrome://tracing and Perfetto load directly.
+
+When no session is active a span costs one thread-local load. Sessions are
+enabled per request (sudoku_api --trace, or SUDOKU_TRACE=1) or sampled at
+the rate given by SUDOKU_TRACE_SAMPLE (e.g. 0.01); files go to
+SUDOKU_TRACE_DIR (default "traces").
+*/
+
+#ifndef SUDOKU_UTIL_TRACE_H
+#define SUDOKU_UTIL_TRACE_H
+
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+struct TraceEvent {
+    const char* name;        // String literal; spans never own their names
+    const char* category;
+    int64_t startUs;
+    int64_t durationUs;
+};
+
+class TraceSession {
+public:
+    TraceSession(const std::string& requestName, bool enabled);
+    ~TraceSession();
+
+    TraceSession(const TraceSession&) = delete;
+    TraceSession& operator=(const TraceSession&) = delete;
+
+    bool isEnabled() const { return enabled; }
+
+    // Serialize all recorded events as a Chrome trace-event document
+    std::string toJson() const;
+
+    // Stop recording and write the trace file; returns its path (empty if disabled)
+    std::string finish();
+
+    // Decide whether a request is traced: forced, SUDOKU_TRACE, or sampled
+    static bool shouldTrace(bool forced);
+
+    // Session active on the calling thread, or nullptr
+    static TraceSession* current();
+
+    static int64_t nowUs();
+
+private:
+    friend class TraceThreadScope;
+
+    std::string requestName;
+    bool enabled;
+    bool finished;
+    int64_t startUs;
+    int64_t endUs;
+
+    mutable std::mutex buffersMutex;                             // Guards attach only
+    std::vector<std::unique_ptr<std::vector<TraceEvent>>> buffers;
+
+    TraceSession* previousSession;
+    std::vector<TraceEvent>* previousEvents;
+
+    std::vector<TraceEvent>* attachThread();
+};
+
+// Attaches the calling (worker) thread to a session for the scope's lifetime
+class TraceThreadScope {
+public:
+    explicit TraceThreadScope(TraceSession* session);
+    ~TraceThreadScope();
+
+    TraceThreadScope(const TraceThreadScope&) = delete;
+    TraceThreadScope& operator=(const TraceThreadScope&) = delete;
+
+private:
+    TraceSession* previousSession;
+    std::vector<TraceEvent>* previousEvents;
+};
+
+// Records one complete event from construction to destruction
+class TraceSpan {
+public:
+    explicit TraceSpan(const char* name, const char* category = "sudoku");
+    ~TraceSpan();
+
+    TraceSpan(const TraceSpan&) = delete;
+    TraceSpan& operator=(const TraceSpan&) = delete;
+
+private:
+    std::vector<TraceEvent>* events;
+    const char* name;
+    const char* category;
+    int64_t startUs;
+};
+
+#define SUDOKU_TRACE_CONCAT_INNER(a, b) a##b
+#define SUDOKU_TRACE_CONCAT(a, b) SUDOKU_TRACE_CONCAT_INNER(a, b)
+#define SUDOKU_TRACE_SPAN(name) TraceSpan SUDOKU_TRACE_CONCAT(sudokuTraceSpan, __LINE__)(name)
+
+#endif // SUDOKU_UTIL_TRACE_H
@@ -3,186 +3,450 @@ ConsoleView implementation for console-based UI rendering and input.
 */
 
 #include "console_view.h"
+#include <algorithm>
+#include <cerrno>
+#include <cstdlib>
 #include <iostream>
 #include <iomanip>
 #include <limits>
+#include <sstream>
+#include <sys/ioctl.h>
+#include <unistd.h>
+
+namespace {
+
+const char* const kClearScreen = "\033[2J\033[1;1H";
+
+// Unchanged glyphs this short between two changes are re-sent; a cursor move costs more
+constexpr int kMaxSkippedGlyphs = 6;
+
+int digitCount(int value) {
+    int digits = 1;
+    while (value >= 10) {
+        value /= 10;
+        ++digits;
+    }
+    return digits;
+}
+
+void appendGlyphs(std::vector<std::string>& line, const std::string& ascii) {
+    for (char c : ascii) {
+        line.emplace_back(1, c);
+    }
+}
+
+void appendRepeated(std::vector<std::string>& line, const char* glyph, int count) {
+    for (int i = 0; i < count; ++i) {
+        line.emplace_back(glyph);
+    }
+}
+
+// Right-aligned number (or "·" for empty) in `width` columns
+void appendNumber(std::vector<std::string>& line, int value, int width) {
+    std::string text = value == 0 ? "" : std::to_string(value);
+    int textWidth = value == 0 ? 1 : static_cast<int>(text.size());
+    appendRepeated(line, " ", width - textWidth);
+    if (value == 0) {
+        line.emplace_back("·");
+    } else {
+        appendGlyphs(line, text);
+    }
+}
+
+void appendCursorTo(std::string& out, int row, int col) {
+    out += "\033[";
+    out += std::to_string(row);
+    out += ';';
+    out += std::to_string(col);
+    out += 'H';
+}
+
+void terminalSize(int& rows, int& columns) {
+    winsize size{};
+    if (ioctl(STDOUT_FILENO, TIOCGWINSZ, &size) == 0 && size.ws_row > 0 && size.ws_col > 0) {
+        rows = size.ws_row;
+        columns = size.ws_col;
+    } else {
+        rows = 24;
+        columns = 80;
+    }
+}
+
+// Screen lines `text` moves the cursor down by. Counts bytes, so wide
+// characters over-count, which only costs a full redraw.
+int screenLines(const std::string& text, int columns) {
+    int lines = 0;
+    size_t lineStart = 0;
+    for (size_t i = 0; i < text.size(); ++i) {
+        if (text[i] == '\n') {
+            size_t length = i - lineStart;
+            lines += 1 + (length == 0 ? 0 : static_cast<int>((length - 1) / columns));
+            lineStart = i + 1;
+        }
+    }
+    return lines;
+}
+
+// Whole text in one write(2), so the terminal never shows half an update
+void writeOut(const std::string& text) {
+    std::cout.flush();
+    size_t written = 0;
+    while (written < text.size()) {
+        ssize_t n = ::write(STDOUT_FILENO, text.data() + written, text.size() - written);
+        if (n < 0 && errno == EINTR) continue;
+        if (n <= 0) return;
+        written += static_cast<size_t>(n);
+    }
+}
+
+}
 
 ConsoleView::ConsoleView() {
-    // Constructor implementation can be empty since default constructor is sufficient
+    const char* term = std::getenv("TERM");
+    diffRendering = isatty(STDOUT_FILENO) && term != nullptr && std::string(term) != "dumb";
 }
 
 void ConsoleView::showWelcome() {
     clearScreen();
-    std::cout << "╔══════════════════════════════════════╗\n";
-    std::cout << "║        Interactive Sudoku Game       ║\n";
-    std::cout << "║              🎯 Welcome! 🎯          ║\n";
-    std::cout << "╚══════════════════════════════════════╝\n\n";
+    emit("╔══════════════════════════════════════╗\n"
+         "║        Interactive Sudoku Game       ║\n"
+         "║              🎯 Welcome! 🎯          ║\n"
+         "╚══════════════════════════════════════╝\n\n");
 }
 
 void ConsoleView::showHelp() {
-    std::cout << "\n╔═══════════ SUDOKU HELP ══════════════╗\n";
-    std::cout << "║ Goal: Fill the 9×9 grid so that each ║\n";
-    std::cout << "║ row, column, and 3×3 subgrid contains║\n";
-    std::cout << "║ all digits from 1 to 9.              ║\n";
-    std::cout << "║                                       ║\n";
-    std::cout << "║ Commands:                             ║\n";
-    std::cout << "║  m, move     - Make a move            ║\n";
-    std::cout << "║  g, generate - Generate new puzzle    ║\n";
-    std::cout << "║  h, help     - Show this help         ║\n";
-    std::cout << "║  c, clear    - Clear the board        ║\n";
-    std::cout << "║  l, load     - Load sample puzzle     ║\n";
-    std::cout << "║  q, quit     - Exit the game          ║\n";
-    std::cout << "║                                       ║\n";
-    std::cout << "║ AI Commands:                          ║\n";
-    std::cout << "║  solve, s    - Let AI solve puzzle    ║\n";
-    std::cout << "║  ai, hint    - Get next AI move       ║\n";
-    std::cout << "║  hints       - Show possible AI moves ║\n";
-    std::cout << "║  enable_ai   - Enable AI assistance   ║\n";
-    std::cout << "║  disable_ai  - Disable AI assistance  ║\n";
-    std::cout << "║                                       ║\n";
-    std::cout << "║ Input format for moves:               ║\n";
-    std::cout << "║  Row: 1-9, Col: 1-9, Value: 1-9      ║\n";
-    std::cout << "║  (Use 0 to clear a cell)              ║\n";
-    std::cout << "╚═══════════════════════════════════════╝\n";
+    emit("\n╔═══════════ SUDOKU HELP ══════════════╗\n"
+         "║ Goal: Fill the 9×9 grid so that each ║\n"
+         "║ row, column, and 3×3 subgrid contains║\n"
+         "║ all digits from 1 to 9.              ║\n"
+         "║                                       ║\n"
+         "║ Commands:                             ║\n"
+         "║  m, move     - Make a move            ║\n"
+         "║  g, generate - Generate new puzzle    ║\n"
+         "║  h, help     - Show this help         ║\n"
+         "║  c, clear    - Clear the board        ║\n"
+         "║  l, load     - Load sample puzzle     ║\n"
+         "║  q, quit     - Exit the game          ║\n"
+         "║                                       ║\n"
+         "║ AI Commands:                          ║\n"
+         "║  solve, s    - Let AI solve puzzle    ║\n"
+         "║  ai, hint    - Get next AI move       ║\n"
+         "║  hints       - Show possible AI moves ║\n"
+         "║  enable_ai   - Enable AI assistance   ║\n"
+         "║  disable_ai  - Disable AI assistance  ║\n"
+         "║                                       ║\n"
+         "║ Input format for moves:               ║\n"
+         "║  Row: 1-9, Col: 1-9, Value: 1-9      ║\n"
+         "║  (Use 0 to clear a cell)              ║\n"
+         "╚═══════════════════════════════════════╝\n");
 }
 
 void ConsoleView::showGameStatus(const Board& board, int moveCount) {
-    std::cout << "\n📊 Status: ";
+    std::string status = "\n📊 Status: ";
     if (board.isComplete()) {
         if (board.isValid()) {
-            std::cout << "🎉 SOLVED! 🎉";
+            status += "🎉 SOLVED! 🎉";
         } else {
-            std::cout << "❌ Complete but INVALID";
+            status += "❌ Complete but INVALID";
         }
     } else {
         if (board.isValid()) {
-            std::cout << "✅ In progress";
+            status += "✅ In progress";
         } else {
-            std::cout << "❌ INVALID state";
+            status += "❌ INVALID state";
         }
     }
-    std::cout << " | 🎯 Moves: " << moveCount << std::endl;
+    status += " | 🎯 Moves: " + std::to_string(moveCount) + "\n";
+    emit(status);
 }
 
 void ConsoleView::showBoard(const Board& board) {
+    std::string text;
     for (int row = 0; row < board.getBoardSize(); ++row) {
         for (int col = 0; col < board.getBoardSize(); ++col) {
             int value = board.getCell(row, col).getValue();
-            std::cout << (value == 0 ? "·" : std::to_string(value)) << " ";
+            text += (value == 0 ? "·" : std::to_string(value)) + " ";
         }
-        std::cout << std::endl;
+        text += "\n";
     }
+    emit(text);
 }
 
 void ConsoleView::showBoardWithCoordinates(const Board& board) {
-    std::cout << "\n    1 2 3   4 5 6   7 8 9\n";
-    std::cout << "  ┌───────┬───────┬───────┐\n";
-    
-    for (int row = 0; row < board.getBoardSize(); ++row) {
-        std::cout << row + 1 << " │ ";
-        
-        for (int col = 0; col < board.getBoardSize(); ++col) {
-            int value = board.getCell(row, col).getValue();
-            if (value == 0) {
-                std::cout << "·";
-            } else {
-                std::cout << value;
-            }
-            
-            if (col == 2 || col == 5) {
-                std::cout << " │ ";
-            } else if (col == 8) {
-                std::cout << " │";
-            } else {
-                std::cout << " ";
-            }
+    Frame next;
+    renderBoard(board, next);
+
+    std::string out;
+    bool atTop = pendingClear;
+    if (pendingClear && frameReusable(next)) {
+        appendFrameDiff(next, out);
+        appendCursorTo(out, next.lines() + 1, 1);
+        out += "\033[J";   // Erase what was printed below the board last time
+    } else {
+        if (pendingClear) {
+            out = kClearScreen;
         }
-        std::cout << "\n";
-        
-        if (row == 2 || row == 5) {
-            std::cout << "  ├───────┼───────┼───────┤\n";
+        // Full board, without the padding at line ends
+        for (int line = 0; line < next.lines(); ++line) {
+            size_t contentEnd = out.size();
+            for (int col = 0; col < next.width; ++col) {
+                const std::string& glyph = next.glyphs[line * next.width + col];
+                out += glyph;
+                if (glyph != " ") {
+                    contentEnd = out.size();
+                }
+            }
+            out.erase(contentEnd);
+            out += '\n';
         }
     }
-    std::cout << "  └───────┴───────┴───────┘\n";
+    pendingClear = false;
+
+    if (atTop) {
+        frame = std::move(next);
+        frameOnScreen = true;
+        linesBelowFrame = 0;
+        writeOut(out);
+    } else {
+        // Drawn somewhere below other text; not a frame later updates can use
+        emit(out);
+    }
+}
+
+void ConsoleView::showSolveProgress(const Board& board, int /*step*/) {
+    if (!diffRendering || !frameOnScreen || pendingClear) {
+        return;
+    }
+    Frame next;
+    renderBoard(board, next);
+    if (!frameReusable(next)) {
+        return;
+    }
+    // Update the board in place and put the cursor back where the text was
+    std::string out = "\0337";
+    appendFrameDiff(next, out);
+    out += "\0338";
+    frame = std::move(next);
+    writeOut(out);
 }
 
 void ConsoleView::showMessage(const std::string& message) {
-    std::cout << "💬 " << message << std::endl;
+    emit("💬 " + message + "\n");
 }
 
 void ConsoleView::showError(const std::string& error) {
-    std::cout << "❌ Error: " << error << std::endl;
+    emit("❌ Error: " + error + "\n");
 }
 
 void ConsoleView::showSuccess(const std::string& message) {
-    std::cout << "✅ " << message << std::endl;
+    emit("✅ " + message + "\n");
 }
 
 void ConsoleView::showWinMessage(int moveCount) {
     clearScreen();
-    std::cout << "╔══════════════════════════════════════╗\n";
-    std::cout << "║            🎉 CONGRATULATIONS! 🎉    ║\n";
-    std::cout << "║                                      ║\n";
-    std::cout << "║         You solved the puzzle!       ║\n";
-    std::cout << "║                                      ║\n";
-    std::cout << "║         Total moves: " << std::setw(3) << moveCount << "           ║\n";
-    std::cout << "║                                      ║\n";
-    std::cout << "║          🌟 Well done! 🌟           ║\n";
-    std::cout << "╚══════════════════════════════════════╝\n\n";
+    std::ostringstream banner;
+    banner << "╔══════════════════════════════════════╗\n";
+    banner << "║            🎉 CONGRATULATIONS! 🎉    ║\n";
+    banner << "║                                      ║\n";
+    banner << "║         You solved the puzzle!       ║\n";
+    banner << "║                                      ║\n";
+    banner << "║         Total moves: " << std::setw(3) << moveCount << "           ║\n";
+    banner << "║                                      ║\n";
+    banner << "║          🌟 Well done! 🌟           ║\n";
+    banner << "╚══════════════════════════════════════╝\n\n";
+    emit(banner.str());
 }
 
 std::string ConsoleView::getCommand() {
-    std::cout << "\n🎮 Commands: [m]ove, [g]enerate, [h]elp, [c]lear, [l]oad, [q]uit\n";
-    std::cout << "Enter command: ";
-    
+    emit("\n🎮 Commands: [m]ove, [g]enerate, [h]elp, [c]lear, [l]oad, [q]uit\n"
+         "Enter command: ");
+
     std::string command;
     if (!(std::cin >> command)) {
         std::cin.clear();
         std::cin.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
         return "";
     }
+    countInputLine();
     return command;
 }
 
 bool ConsoleView::getMove(int& row, int& col, int& value) {
-    std::cout << "\n🎯 Enter your move:\n";
-    
-    std::cout << "Row (1-9): ";
+    emit("\n🎯 Enter your move:\n");
+
+    emit("Row (1-9): ");
     if (!(std::cin >> row)) {
         std::cin.clear();
         std::cin.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
         showError("Invalid input!");
         return false;
     }
-    
-    std::cout << "Column (1-9): ";
+    countInputLine();
+
+    emit("Column (1-9): ");
     if (!(std::cin >> col)) {
         std::cin.clear();
         std::cin.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
         showError("Invalid input!");
         return false;
     }
-    
-    std::cout << "Value (1-9, or 0 to clear): ";
+    countInputLine();
+
+    emit("Value (1-9, or 0 to clear): ");
     if (!(std::cin >> value)) {
         std::cin.clear();
         std::cin.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
         showError("Invalid input!");
         return false;
     }
-    
+    countInputLine();
+
     return true;
 }
 
 void ConsoleView::clearScreen() {
+    if (diffRendering) {
+        // Done by whatever is drawn next, which may keep the board
+        pendingClear = true;
+        return;
+    }
     // Clear screen (works on most terminals)
-    std::cout << "\033[2J\033[1;1H";
+    emit(kClearScreen);
 }
 
 void ConsoleView::waitForEnter() {
-    std::cout << "\n⏸️  Press Enter to continue...";
+    emit("\n⏸️  Press Enter to continue...");
     std::cin.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
     std::cin.get();
+    countInputLine();
+}
+
+// ========== Frame rendering ==========
+
+void ConsoleView::renderBoard(const Board& board, Frame& into) const {
+    int size = board.getBoardSize();
+    int gridSize = board.getGridSize();
+    int cellWidth = digitCount(size);
+    int labelWidth = digitCount(size);
+    int blockWidth = gridSize * (cellWidth + 1) + 1;   // "─" run between corners
+
+    std::vector<std::vector<std::string>> lines;
+    auto border = [&](const char* left, const char* middle, const char* right) {
+        std::vector<std::string> line;
+        appendRepeated(line, " ", labelWidth + 1);
+        line.emplace_back(left);
+        for (int block = 0; block < gridSize; ++block) {
+            if (block > 0) line.emplace_back(middle);
+            appendRepeated(line, "─", blockWidth);
+        }
+        line.emplace_back(right);
+        lines.push_back(std::move(line));
+    };
+
+    lines.emplace_back();   // Blank line above the column numbers
+    std::vector<std::string> header;
+    appendRepeated(header, " ", labelWidth + 3);
+    for (int col = 0; col < size; ++col) {
+        if (col > 0) appendRepeated(header, " ", col % gridSize == 0 ? 3 : 1);
+        appendNumber(header, col + 1, cellWidth);
+    }
+    lines.push_back(std::move(header));
+    border("┌", "┬", "┐");
+
+    for (int row = 0; row < size; ++row) {
+        std::vector<std::string> line;
+        std::string label = std::to_string(row + 1);
+        appendRepeated(line, " ", labelWidth - static_cast<int>(label.size()));
+        appendGlyphs(line, label);
+        line.emplace_back(" ");
+        line.emplace_back("│");
+        for (int col = 0; col < size; ++col) {
+            if (col > 0 && col % gridSize == 0) {
+                line.emplace_back(" ");
+                line.emplace_back("│");
+            }
+            line.emplace_back(" ");
+            appendNumber(line, board.getCell(row, col).getValue(), cellWidth);
+        }
+        line.emplace_back(" ");
+        line.emplace_back("│");
+        lines.push_back(std::move(line));
+
+        if ((row + 1) % gridSize == 0 && row + 1 < size) {
+            border("├", "┼", "┤");
+        }
+    }
+    border("└", "┴", "┘");
+
+    into.width = 0;
+    for (const auto& line : lines) {
+        into.width = std::max(into.width, static_cast<int>(line.size()));
+    }
+    into.glyphs.clear();
+    into.glyphs.reserve(lines.size() * into.width);
+    for (auto& line : lines) {
+        line.resize(into.width, " ");
+        for (auto& glyph : line) {
+            into.glyphs.push_back(std::move(glyph));
+        }
+    }
+}
+
+bool ConsoleView::frameReusable(const Frame& next) const {
+    if (!diffRendering || !frameOnScreen || next.width != frame.width || next.lines() != frame.lines()) {
+        return false;
+    }
+    // Once the text below has scrolled the screen, the board is no longer at the top
+    int rows = 0;
+    int columns = 0;
+    terminalSize(rows, columns);
+    return next.width <= columns && frame.lines() + linesBelowFrame < rows;
+}
+
+void ConsoleView::appendFrameDiff(const Frame& next, std::string& out) const {
+    for (int line = 0; line < next.lines(); ++line) {
+        const std::string* before = &frame.glyphs[line * next.width];
+        const std::string* after = &next.glyphs[line * next.width];
+        int col = 0;
+        while (col < next.width) {
+            if (before[col] == after[col]) {
+                ++col;
+                continue;
+            }
+            // Run of changes, bridging short stretches of unchanged glyphs
+            int end = col + 1;
+            for (int scan = end, unchanged = 0; scan < next.width && unchanged <= kMaxSkippedGlyphs; ++scan) {
+                if (before[scan] != after[scan]) {
+                    end = scan + 1;
+                    unchanged = 0;
+                } else {
+                    ++unchanged;
+                }
+            }
+            appendCursorTo(out, line + 1, col + 1);
+            for (int i = col; i < end; ++i) {
+                out += after[i];
+            }
+            col = end;
+        }
+    }
+}
+
+void ConsoleView::emit(const std::string& text) {
+    if (pendingClear) {
+        // Something other than the board goes on top
+        pendingClear = false;
+        frameOnScreen = false;
+        writeOut(kClearScreen + text);
+    } else {
+        writeOut(text);
+    }
+    if (frameOnScreen) {
+        int rows = 0;
+        int columns = 0;
+        terminalSize(rows, columns);
+        linesBelowFrame += screenLines(text, columns);
+    }
 }
 
 void ConsoleView::printSeparator() {
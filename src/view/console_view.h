@@ -1,6 +1,15 @@
 /*
 Console UI implementation for the Sudoku game.
 Provides text-based interaction through standard input/output.
+
+On an ANSI terminal the board is double-buffered: it is rendered into a
+frame (one glyph per screen column) and compared with the frame already on
+screen, and only the changed runs are sent with cursor addressing, in a
+single write. clearScreen() is deferred so that a board redraw right after
+it can reuse the board still at the top of the screen (text below it is
+erased instead). When the old frame cannot be trusted (first draw, other
+output on top, the screen scrolled) the board is drawn in full. Piped
+output gets the plain full board every time.
 */
 
 #ifndef SUDOKU_VIEW_CONSOLE_VIEW_H
@@ -10,6 +19,7 @@ Provides text-based interaction through standard input/output.
 #include "../model/board.h"
 #include <iostream>
 #include <string>
+#include <vector>
 
 class ConsoleView : public SudokuView {
 public:
@@ -20,6 +30,7 @@ public:
     void showBoard(const Board& board) override;
     void showBoardWithCoordinates(const Board& board) override;
     void showGameStatus(const Board& board, int moveCount) override;
+    void showSolveProgress(const Board& board, int step) override;
     
     std::string getCommand() override;
     bool getMove(int& row, int& col, int& value) override;
@@ -34,6 +45,25 @@ public:
     void waitForEnter() override;
 
 private:
+    // Board as drawn: lines * width glyphs, each one terminal column wide
+    struct Frame {
+        int width = 0;
+        std::vector<std::string> glyphs;
+        int lines() const { return width == 0 ? 0 : static_cast<int>(glyphs.size()) / width; }
+    };
+    
+    Frame frame;                  // Board last drawn at the top of the screen
+    bool frameOnScreen = false;   // ...and nothing has been drawn over it since
+    bool pendingClear = false;    // clearScreen() waiting for the next output
+    bool diffRendering;           // stdout is an ANSI terminal
+    int linesBelowFrame = 0;      // Screen lines used since, to detect scrolling
+    
+    void renderBoard(const Board& board, Frame& into) const;
+    bool frameReusable(const Frame& next) const;
+    void appendFrameDiff(const Frame& next, std::string& out) const;
+    void emit(const std::string& text);   // All non-board output; one write
+    void countInputLine() { ++linesBelowFrame; }
+    
     void printBoardBorder();
     void printSeparator();
     void printColoredCell(int value);
@@ -0,0 +1,59 @@
+/*
+Null view for driving GameController without a user
+Output is discarded (only errors are counted) and moves come from a queue
+filled by the caller, so a recorded command sequence can be replayed through
+GameController::handleCommand for benchmarks and CI.
+*/
+
+#ifndef SUDOKU_VIEW_NULL_VIEW_H
+#define SUDOKU_VIEW_NULL_VIEW_H
+
+#include "sudoku_view.h"
+#include <queue>
+#include <string>
+
+class NullView : public SudokuView {
+public:
+    void showWelcome() override {}
+    void showBoard(const Board&) override {}
+    void showBoardWithCoordinates(const Board&) override {}
+    void showGameStatus(const Board&, int) override {}
+
+    // No command source of its own: the caller passes commands to handleCommand
+    std::string getCommand() override { return ""; }
+
+    bool getMove(int& row, int& col, int& value) override {
+        if (moves.empty()) {
+            return false;
+        }
+        row = moves.front().row;
+        col = moves.front().col;
+        value = moves.front().value;
+        moves.pop();
+        return true;
+    }
+
+    void showMessage(const std::string&) override {}
+    void showError(const std::string&) override { ++errors; }
+    void showSuccess(const std::string&) override {}
+    void showWinMessage(int) override {}
+
+    void showHelp() override {}
+    void clearScreen() override {}
+    void waitForEnter() override {}
+
+    // Answer for the next getMove() (1-based, as typed at the console)
+    void queueMove(int row, int col, int value) { moves.push({row, col, value}); }
+
+    long getErrorCount() const { return errors; }
+
+private:
+    struct Move {
+        int row, col, value;
+    };
+
+    std::queue<Move> moves;
+    long errors = 0;
+};
+
+#endif // SUDOKU_VIEW_NULL_VIEW_H
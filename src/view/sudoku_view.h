@@ -21,6 +21,10 @@ public:
     virtual void showBoardWithCoordinates(const Board& board) = 0;
     virtual void showGameStatus(const Board& board, int moveCount) = 0;
     
+    // Working board of a running solve, a few times per second; views that
+    // cannot update the board in place ignore it
+    virtual void showSolveProgress(const Board& /*board*/, int /*step*/) {}
+    
     // User interaction
     virtual std::string getCommand() = 0;
     virtual bool getMove(int& row, int& col, int& value) = 0;
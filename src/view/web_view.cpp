@@ -1,6 +1,8 @@
 #include "web_view.h"
+#include "../model/board_json.h"
 #include <iostream>
 #include <sstream>
+#include <nlohmann/json.hpp>
 
 WebView::WebView() : lastMessage("") {
     // Initialize web view - this could include setting up communication channels
@@ -15,10 +17,8 @@ void WebView::showWelcome() {
 }
 
 void WebView::showBoard(const Board& board) {
-    nlohmann::json boardJson = serializeBoardToJson(board);
-    
     // Send board update to web client
-    std::cout << "BOARD_UPDATE:" << boardJson.dump() << std::endl;
+    std::cout << "BOARD_UPDATE:" << serializeBoardToJson(board) << std::endl;
 }
 
 void WebView::showBoardWithCoordinates(const Board& board) {
@@ -27,13 +27,10 @@ void WebView::showBoardWithCoordinates(const Board& board) {
 }
 
 void WebView::showGameStatus(const Board& board, int moveCount) {
-    nlohmann::json statusJson;
-    statusJson["type"] = "status";
-    statusJson["board"] = serializeBoardToJson(board);
-    statusJson["moveCount"] = moveCount;
-    statusJson["isComplete"] = board.isComplete() && board.isValid();
+    std::string statusJson = getGameStateJson(board, moveCount);
+    statusJson.insert(statusJson.size() - 1, ",\"type\":\"status\"");
     
-    std::cout << "STATUS:" << statusJson.dump() << std::endl;
+    std::cout << "STATUS:" << statusJson << std::endl;
 }
 
 std::string WebView::getCommand() {
@@ -133,25 +130,20 @@ void WebView::queueMove(int row, int col, int value) {
     moveQueue.push({row, col, value});
 }
 
-nlohmann::json WebView::serializeBoardToJson(const Board& board) {
-    nlohmann::json boardJson = nlohmann::json::array();
-    
-    for (int i = 0; i < 9; i++) {
-        nlohmann::json row = nlohmann::json::array();
-        for (int j = 0; j < 9; j++) {
-            row.push_back(board.getCell(i, j).getValue());
-        }
-        boardJson.push_back(row);
-    }
-    
+std::string WebView::serializeBoardToJson(const Board& board) {
+    std::string boardJson;
+    appendBoardJson(boardJson, board, BoardJsonLayout::VALUES);
     return boardJson;
 }
 
 std::string WebView::getGameStateJson(const Board& board, int moveCount) {
-    nlohmann::json gameState;
-    gameState["board"] = serializeBoardToJson(board);
-    gameState["moveCount"] = moveCount;
-    gameState["isComplete"] = board.isComplete() && board.isValid();
-    
-    return gameState.dump();
+    // Same keys and order as the nlohmann::json object this used to dump
+    std::string gameState = "{\"board\":";
+    BoardScan scan = appendBoardJson(gameState, board, BoardJsonLayout::VALUES);
+    gameState += ",\"isComplete\":";
+    gameState += scan.isSolved() ? "true" : "false";
+    gameState += ",\"moveCount\":";
+    gameState += std::to_string(moveCount);
+    gameState += "}";
+    return gameState;
 }
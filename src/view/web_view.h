@@ -10,7 +10,6 @@ Communicates with web frontend through JSON API
 #include "../model/board.h"
 #include <queue>
 #include <string>
-#include <nlohmann/json.hpp>
 
 class WebView : public SudokuView {
 private:
@@ -44,7 +43,7 @@ public:
     std::string getLastMessage() const;
     void queueCommand(const std::string& command);
     void queueMove(int row, int col, int value);
-    nlohmann::json serializeBoardToJson(const Board& board);
+    std::string serializeBoardToJson(const Board& board);   // [[5,3,0,...],...] at any board size
     std::string getGameStateJson(const Board& board, int moveCount);
 
 private:
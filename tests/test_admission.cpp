@@ -0,0 +1,330 @@
+/*
+AdmissionController tests: a full class queue and a too-long expected wait
+are refused up front, a request still queued at its class deadline is
+refused then, and requests queued within a class start in arrival order.
+Per client: a client in CPU debt is refused solves and jobs (with the time
+to pay the debt off as retry hint) but not interactive commands, a cheap
+client's request overtakes an expensive client's in the queue, and the slot
+share caps a client only while others are queued.
+Controllers run with fixed options; requests that have to queue run on
+their own threads and are released one at a time. CPU is charged by
+spinning the admitted thread.
+*/
+
+#include "../src/api/admission_controller.h"
+#include "../src/util/perf_counters.h"
+#include "test_check.h"
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+// CHECK_EQ prints its operands
+std::ostream& operator<<(std::ostream& out, CostClass costClass) {
+    return out << AdmissionController::className(costClass);
+}
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+double elapsedMs(Clock::time_point since) {
+    return std::chrono::duration<double, std::milli>(Clock::now() - since).count();
+}
+
+// Controller with one SOLVE slot, nothing else changed
+AdmissionController::Options oneSlot(size_t queueCapacity, double maxQueueWaitMs) {
+    AdmissionController::Options options;
+    options.limits[static_cast<int>(CostClass::SOLVE)] = {1, queueCapacity, maxQueueWaitMs};
+    return options;
+}
+
+// Spins until the calling thread has used `ms` of CPU
+void burnCpu(double ms) {
+    double start = threadCpuTimeMs();
+    volatile uint64_t sink = 0;
+    while (threadCpuTimeMs() - start < ms) {
+        for (int i = 0; i < 10000; ++i) sink = sink + i;
+    }
+}
+
+// Admits and releases on the calling thread, charging `cpuMs`
+void runRequest(AdmissionController& admission, CostClass costClass, const std::string& client, double cpuMs) {
+    AdmissionController::Ticket ticket = admission.admit(costClass, client);
+    CHECK(ticket);
+    burnCpu(cpuMs);
+}
+
+void waitForQueued(const AdmissionController& admission, CostClass costClass, size_t queued) {
+    while (admission.getStats(costClass).queued < queued) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+}
+
+// Names of requests in the order they were admitted
+struct AdmissionLog {
+    std::mutex mutex;
+    std::vector<std::string> order;
+    void add(const std::string& name) {
+        std::lock_guard<std::mutex> lock(mutex);
+        order.push_back(name);
+    }
+    void waitForSize(size_t size) {
+        while (true) {
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                if (order.size() >= size) return;
+            }
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+    }
+};
+
+// A request on its own thread: admits (queueing if need be), logs, then
+// holds its slot until release() - tickets must be released on the admitted thread
+class Request {
+public:
+    Request(AdmissionController& admission, CostClass costClass, const std::string& client,
+            const std::string& name, AdmissionLog& log)
+        : released(done.get_future().share()) {
+        std::shared_future<void> hold = released;
+        thread = std::thread([&admission, costClass, client, name, &log, hold, this]() {
+            AdmissionController::Ticket ticket = admission.admit(costClass, client);
+            admitted = static_cast<bool>(ticket);
+            log.add(admitted ? name : "rejected " + name);
+            if (ticket) {
+                hold.wait();
+            }
+        });
+    }
+
+    ~Request() {
+        release();
+    }
+
+    void release() {
+        if (thread.joinable()) {
+            done.set_value();
+            thread.join();
+        }
+    }
+
+    bool wasAdmitted() {
+        release();
+        return admitted;
+    }
+
+private:
+    std::promise<void> done;
+    std::shared_future<void> released;
+    std::thread thread;
+    bool admitted = false;
+};
+
+void testQueueFullIsRejectedAtOnce() {
+    AdmissionController admission(oneSlot(1, 10000.0));
+    AdmissionLog log;
+    AdmissionController::Ticket running = admission.admit(CostClass::SOLVE, "a");
+    CHECK(running);
+    Request queued(admission, CostClass::SOLVE, "b", "b", log);
+    waitForQueued(admission, CostClass::SOLVE, 1);
+
+    Clock::time_point start = Clock::now();
+    AdmissionController::Ticket refused = admission.admit(CostClass::SOLVE, "c");
+    CHECK(!refused);
+    CHECK(elapsedMs(start) < 1000.0);   // Not left to time out
+    CHECK_EQ(refused.getClass(), CostClass::SOLVE);
+    // Nothing measured yet: the hint is the class deadline
+    CHECK_EQ(refused.getRetryAfterMs(), 10000.0);
+
+    // Other classes have queues of their own
+    CHECK(admission.admit(CostClass::INTERACTIVE, "c"));
+
+    running.release();
+    CHECK(queued.wasAdmitted());
+    AdmissionStats stats = admission.getStats(CostClass::SOLVE);
+    CHECK_EQ(stats.admitted, 2u);
+    CHECK_EQ(stats.rejected, 1u);
+    CHECK_EQ(stats.queued, 0u);
+}
+
+void testExpectedWaitIsRejectedAtOnce() {
+    AdmissionController admission(oneSlot(16, 50.0));
+    {
+        // One measured run of about 100 ms
+        AdmissionController::Ticket ticket = admission.admit(CostClass::SOLVE, "a");
+        std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    }
+    double serviceMs = admission.getStats(CostClass::SOLVE).serviceMs;
+    CHECK(serviceMs >= 100.0);
+
+    AdmissionController::Ticket running = admission.admit(CostClass::SOLVE, "a");
+    CHECK(running);
+    // One run ahead of it on one slot: about 100 ms expected, over the 50 ms deadline
+    Clock::time_point start = Clock::now();
+    AdmissionController::Ticket refused = admission.admit(CostClass::SOLVE, "b");
+    CHECK(!refused);
+    CHECK(elapsedMs(start) < 50.0);
+    CHECK_EQ(refused.getRetryAfterMs(), serviceMs);
+    CHECK_EQ(admission.getStats(CostClass::SOLVE).queued, 0u);
+}
+
+void testDeadlineWhileQueued() {
+    // Nothing measured, so the expected wait cannot refuse it up front
+    AdmissionController admission(oneSlot(16, 100.0));
+    AdmissionController::Ticket running = admission.admit(CostClass::SOLVE, "a");
+
+    Clock::time_point start = Clock::now();
+    AdmissionController::Ticket refused = admission.admit(CostClass::SOLVE, "b");
+    double waited = elapsedMs(start);
+    CHECK(!refused);
+    CHECK(waited >= 100.0);
+    CHECK(waited < 5000.0);
+    CHECK_EQ(refused.getRetryAfterMs(), 100.0);
+
+    AdmissionStats stats = admission.getStats(CostClass::SOLVE);
+    CHECK_EQ(stats.rejected, 1u);
+    CHECK_EQ(stats.queued, 0u);   // It left the queue
+    running.release();
+    CHECK(admission.admit(CostClass::SOLVE, "b"));
+}
+
+void testFifoWithinClass(const std::vector<std::string>& clients) {
+    AdmissionController admission(oneSlot(16, 10000.0));
+    AdmissionLog log;
+    AdmissionController::Ticket running = admission.admit(CostClass::SOLVE, "holder");
+
+    std::vector<std::unique_ptr<Request>> requests;
+    for (size_t i = 0; i < clients.size(); ++i) {
+        requests.emplace_back(new Request(admission, CostClass::SOLVE, clients[i], std::to_string(i), log));
+        waitForQueued(admission, CostClass::SOLVE, i + 1);
+    }
+    running.release();
+    // Each holds the only slot until released, so the next starts only then
+    for (size_t i = 0; i < requests.size(); ++i) {
+        log.waitForSize(i + 1);
+        requests[i]->release();
+    }
+
+    std::vector<std::string> expected;
+    for (size_t i = 0; i < clients.size(); ++i) expected.push_back(std::to_string(i));
+    CHECK(log.order == expected);
+}
+
+void testFifoOneClient() {
+    testFifoWithinClass({"a", "a", "a", "a"});
+}
+
+void testFifoSeveralClients() {
+    testFifoWithinClass({"a", "b", "c", "d"});
+}
+
+void testClientInDebt() {
+    AdmissionController::Options options;
+    options.clientCpuBurstMs = 5.0;
+    options.clientCpuRate = 0.001;   // 1 ms of CPU per second
+    AdmissionController admission(options);
+
+    runRequest(admission, CostClass::SOLVE, "hog", 30.0);
+    double tokensMs = 0.0;
+    for (const ClientStats& stats : admission.getClientStats()) {
+        if (stats.id == "hog") tokensMs = stats.tokensMs;
+    }
+    CHECK(tokensMs < -20.0);
+
+    AdmissionController::Ticket solve = admission.admit(CostClass::SOLVE, "hog");
+    CHECK(!solve);
+    // Time to earn the debt back at the client rate
+    CHECK(std::abs(solve.getRetryAfterMs() - (-tokensMs / options.clientCpuRate)) < 50.0);
+    CHECK(!admission.admit(CostClass::JOB, "hog"));
+    CHECK(admission.admit(CostClass::INTERACTIVE, "hog"));
+    CHECK(admission.admit(CostClass::SOLVE, "other"));
+
+    for (const ClientStats& stats : admission.getClientStats()) {
+        if (stats.id == "hog") {
+            CHECK_EQ(stats.throttled, 2u);
+            CHECK_EQ(stats.requests, 2u);   // The solve and the interactive command
+        }
+    }
+    CHECK_EQ(admission.getStats(CostClass::SOLVE).rejected, 1u);
+}
+
+void testCheapClientOvertakes() {
+    AdmissionController admission(oneSlot(16, 10000.0));
+    AdmissionLog log;
+    // Each client's usual cost per solve: next to nothing, and 60 ms
+    runRequest(admission, CostClass::SOLVE, "light", 0.0);
+    runRequest(admission, CostClass::SOLVE, "heavy", 60.0);
+
+    AdmissionController::Ticket running = admission.admit(CostClass::SOLVE, "holder");
+    Request heavy(admission, CostClass::SOLVE, "heavy", "heavy", log);
+    waitForQueued(admission, CostClass::SOLVE, 1);
+    Request light(admission, CostClass::SOLVE, "light", "light", log);
+    waitForQueued(admission, CostClass::SOLVE, 2);
+
+    running.release();
+    log.waitForSize(1);
+    light.release();
+    log.waitForSize(2);
+    heavy.release();
+    CHECK(log.order == std::vector<std::string>({"light", "heavy"}));
+}
+
+void testSlotShareOnlyWhileOthersQueue() {
+    AdmissionController::Options options;
+    options.limits[static_cast<int>(CostClass::SOLVE)] = {2, 16, 10000.0};
+    options.clientSlotShare = 0.5;   // One of the two slots
+    AdmissionController admission(options);
+    AdmissionLog log;
+    runRequest(admission, CostClass::SOLVE, "b", 60.0);
+    runRequest(admission, CostClass::SOLVE, "a", 0.0);
+
+    // Alone, a client takes every slot
+    AdmissionController::Ticket first = admission.admit(CostClass::SOLVE, "a");
+    AdmissionController::Ticket second = admission.admit(CostClass::SOLVE, "a");
+    CHECK(first);
+    CHECK(second);
+    CHECK_EQ(admission.getStats(CostClass::SOLVE).running, 2);
+
+    // a's third request is cheaper than b's and so first in the queue...
+    Request other(admission, CostClass::SOLVE, "b", "b", log);
+    waitForQueued(admission, CostClass::SOLVE, 1);
+    Request third(admission, CostClass::SOLVE, "a", "a", log);
+    waitForQueued(admission, CostClass::SOLVE, 2);
+
+    // ...but a already holds its share while b waits, so the freed slot goes to b
+    first.release();
+    log.waitForSize(1);
+    CHECK_EQ(admission.getStats(CostClass::SOLVE).queued, 1u);
+    second.release();
+    log.waitForSize(2);
+    CHECK(log.order == std::vector<std::string>({"b", "a"}));
+}
+
+void testClassify() {
+    CHECK_EQ(AdmissionController::classify("get_board"), CostClass::INTERACTIVE);
+    CHECK_EQ(AdmissionController::classify("get_ai_move"), CostClass::INTERACTIVE);
+    CHECK_EQ(AdmissionController::classify("solve_puzzle"), CostClass::SOLVE);
+    CHECK_EQ(AdmissionController::classify("train_batch"), CostClass::JOB);
+    CHECK_EQ(AdmissionController::classify("no_such_command"), CostClass::INTERACTIVE);
+}
+
+}
+
+int main() {
+    RUN_TEST(testQueueFullIsRejectedAtOnce);
+    RUN_TEST(testExpectedWaitIsRejectedAtOnce);
+    RUN_TEST(testDeadlineWhileQueued);
+    RUN_TEST(testFifoOneClient);
+    RUN_TEST(testFifoSeveralClients);
+    RUN_TEST(testClientInDebt);
+    RUN_TEST(testCheapClientOvertakes);
+    RUN_TEST(testSlotShareOnlyWhileOthersQueue);
+    RUN_TEST(testClassify);
+    return testSummary();
+}
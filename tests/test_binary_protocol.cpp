@@ -0,0 +1,206 @@
+/*
+Binary protocol tests: request decoding at its boundaries (short frames,
+lengths that disagree with the client id and board size, unknown commands,
+the largest fields a header can announce), the response layout, and board
+packing.
+*/
+
+#include "../src/api/binary_protocol.h"
+#include "test_check.h"
+#include <string>
+
+namespace {
+
+std::string request(uint8_t command, uint8_t solver, const std::string& client, int boardSize,
+                    const std::string& cells) {
+    std::string payload;
+    payload.push_back(static_cast<char>(command));
+    payload.push_back(static_cast<char>(solver));
+    payload.push_back(static_cast<char>(client.size()));
+    payload.push_back(static_cast<char>(boardSize));
+    return payload + client + cells;
+}
+
+bool decode(const std::string& payload, BinaryRequest& result, std::string& error) {
+    return decodeBinaryRequest(payload.data(), payload.size(), result, error);
+}
+
+uint32_t u32At(const std::string& data, size_t at) {
+    return decodeFrameLength(data.data() + at);
+}
+
+void testDecodesSolveRequest() {
+    std::string cells(81, '\0');
+    cells[0] = static_cast<char>(5 | 0x80);
+    cells[80] = 9;
+    BinaryRequest result;
+    std::string error;
+    CHECK(decode(request(1, 2, "alice", 9, cells), result, error));
+    CHECK(result.command == BinaryCommand::SOLVE);
+    CHECK_EQ(result.solver, 2);
+    CHECK_EQ(result.client, std::string("alice"));
+    CHECK_EQ(result.boardSize, 9);
+    CHECK(result.cells == cells);
+}
+
+void testDecodesRequestWithoutBoard() {
+    BinaryRequest result;
+    std::string error;
+    CHECK(decode(request(2, 0, "", 0, ""), result, error));
+    CHECK(result.command == BinaryCommand::GET_BOARD);
+    CHECK(result.client.empty());
+    CHECK_EQ(result.boardSize, 0);
+    CHECK(result.cells.empty());
+}
+
+void testRejectsShortFrames() {
+    BinaryRequest result;
+    std::string error;
+    for (size_t length = 0; length < 4; ++length) {
+        std::string payload = request(2, 0, "", 0, "").substr(0, length);
+        CHECK(!decode(payload, result, error));
+        CHECK(error.find("shorter") != std::string::npos);
+    }
+    // A null pointer is fine when there is nothing to read
+    CHECK(!decodeBinaryRequest(nullptr, 0, result, error));
+}
+
+void testRejectsLengthMismatch() {
+    BinaryRequest result;
+    std::string error;
+    std::string full = request(1, 0, "bob", 9, std::string(81, '\0'));
+    CHECK(!decode(full.substr(0, full.size() - 1), result, error));   // One cell short
+    CHECK(error.find("length") != std::string::npos);
+    CHECK(!decode(full + '\0', result, error));                       // One byte over
+    CHECK(!decode(request(1, 0, "bob", 9, std::string(16, '\0')), result, error));   // 4x4 cells for 9x9
+    CHECK(!decode(request(2, 0, "", 0, "x"), result, error));         // Trailing byte, no board
+
+    // The client length is counted too: a header claiming 10 bytes of id with 3 present
+    std::string payload = request(2, 0, "abc", 0, "");
+    payload[2] = 10;
+    CHECK(!decode(payload, result, error));
+}
+
+void testLargestHeaderFields() {
+    // 255-byte client id and a 255x255 board: both within one u8, and the
+    // frame still has to match exactly
+    BinaryRequest result;
+    std::string error;
+    std::string client(255, 'c');
+    std::string cells(255 * 255, '\0');
+    CHECK(decode(request(1, 0, client, 255, cells), result, error));
+    CHECK_EQ(result.client.size(), 255u);
+    CHECK_EQ(result.cells.size(), cells.size());
+    CHECK(!decode(request(1, 0, client, 255, cells.substr(1)), result, error));
+}
+
+void testRejectsUnknownCommand() {
+    BinaryRequest result;
+    std::string error;
+    for (int command : {0, 3, 0x7F, 0xFF}) {
+        CHECK(!decode(request(static_cast<uint8_t>(command), 0, "", 0, ""), result, error));
+        CHECK(error.find("unknown command") != std::string::npos);
+    }
+}
+
+void testFrameLength() {
+    const char bytes[] = {0x78, 0x56, 0x34, 0x12};
+    CHECK_EQ(decodeFrameLength(bytes), 0x12345678u);
+    const char maximum[] = {'\xFF', '\xFF', '\xFF', '\xFF'};
+    CHECK_EQ(decodeFrameLength(maximum), 0xFFFFFFFFu);
+}
+
+void testResponseLayout() {
+    Board board;   // 9x9
+    board.getCell(0, 0).setValue(7);
+    board.getCell(0, 0).setLocked(true);
+    BinaryResponse response;
+    response.status = BinaryStatus::SOLVED;
+    response.solver = 3;
+    response.moves = 42;
+    response.timeUs = 1234;
+    response.retryAfterMs = 0;
+    response.board = &board;
+    response.message = "ok";
+
+    std::string out = "prefix";
+    encodeBinaryResponse(response, out);
+    CHECK(out.compare(0, 6, "prefix") == 0);   // Appends
+    std::string frame = out.substr(6);
+    CHECK_EQ(u32At(frame, 0), static_cast<uint32_t>(frame.size() - 4));
+    CHECK_EQ(frame.size(), 4 + kBinaryResponseHeader + 81 + 2 + 2);
+    CHECK_EQ(static_cast<int>(frame[4]), static_cast<int>(BinaryStatus::SOLVED));
+    CHECK_EQ(static_cast<int>(frame[5]), 3);
+    CHECK_EQ(static_cast<int>(frame[6]), 9);
+    CHECK_EQ(static_cast<int>(frame[7]), 0);
+    CHECK_EQ(u32At(frame, 8), 42u);
+    CHECK_EQ(u32At(frame, 12), 1234u);
+    CHECK_EQ(u32At(frame, 16), 0u);
+    CHECK_EQ(static_cast<unsigned char>(frame[20]), 7 | 0x80);
+    CHECK_EQ(static_cast<int>(frame[101]), 2);   // Message length
+    CHECK_EQ(static_cast<int>(frame[102]), 0);
+    CHECK_EQ(frame.substr(103), std::string("ok"));
+}
+
+void testBusyResponseWithoutBoard() {
+    BinaryResponse response;
+    response.status = BinaryStatus::BUSY;
+    response.retryAfterMs = 250;
+    response.message = std::string(70000, 'm');   // Longer than a u16 can describe
+    std::string out;
+    encodeBinaryResponse(response, out);
+    CHECK_EQ(static_cast<int>(out[6]), 0);         // No board
+    CHECK_EQ(u32At(out, 16), 250u);
+    CHECK_EQ(out.size(), 4 + kBinaryResponseHeader + 2 + 0xFFFF);
+    CHECK_EQ(u32At(out, 0), static_cast<uint32_t>(out.size() - 4));
+}
+
+void testPackRoundTrip() {
+    Board board;
+    board.getCell(2, 3).setValue(4);
+    board.getCell(8, 8).setValue(9);
+    board.getCell(8, 8).setLocked(true);
+    std::string cells;
+    packBoard(board, cells);
+    CHECK_EQ(cells.size(), 81u);
+
+    Board unpacked(2);   // Resized to 9x9 by unpackBoard
+    std::string error;
+    CHECK(unpackBoard(9, cells, unpacked, error));
+    CHECK_EQ(unpacked.getBoardSize(), 9);
+    CHECK_EQ(unpacked.getCell(2, 3).getValue(), 4);
+    CHECK(!unpacked.getCell(2, 3).isLocked());
+    CHECK_EQ(unpacked.getCell(8, 8).getValue(), 9);
+    CHECK(unpacked.getCell(8, 8).isLocked());
+}
+
+void testUnpackRejectsBadBoards() {
+    Board board;
+    std::string error;
+    CHECK(!unpackBoard(0, "", board, error));
+    CHECK(!unpackBoard(8, std::string(64, '\0'), board, error));       // Not a square
+    CHECK(!unpackBoard(144, std::string(144 * 144, '\0'), board, error));   // Over 7 bits
+    std::string cells(16, '\0');
+    cells[5] = 5;   // Out of range on a 4x4 board
+    CHECK(!unpackBoard(4, cells, board, error));
+    CHECK(error.find("out of range") != std::string::npos);
+    cells[5] = static_cast<char>(4 | 0x80);
+    CHECK(unpackBoard(4, cells, board, error));
+}
+
+}
+
+int main() {
+    RUN_TEST(testDecodesSolveRequest);
+    RUN_TEST(testDecodesRequestWithoutBoard);
+    RUN_TEST(testRejectsShortFrames);
+    RUN_TEST(testRejectsLengthMismatch);
+    RUN_TEST(testLargestHeaderFields);
+    RUN_TEST(testRejectsUnknownCommand);
+    RUN_TEST(testFrameLength);
+    RUN_TEST(testResponseLayout);
+    RUN_TEST(testBusyResponseWithoutBoard);
+    RUN_TEST(testPackRoundTrip);
+    RUN_TEST(testUnpackRejectsBadBoards);
+    return testSummary();
+}
@@ -0,0 +1,162 @@
+/*
+BoardHistory tests: deltas carry each changed cell once with its latest
+value, and every case where a delta would be wrong answers false instead
+(the client then gets the full board): a revision from before the first
+board, one newer than the history, one whose changes were partly evicted
+from the window, and any revision from before a board-size change.
+*/
+
+#include "../src/api/board_history.h"
+#include "test_check.h"
+#include <vector>
+
+namespace {
+
+using Change = BoardHistory::Change;
+
+bool hasChange(const std::vector<Change>& changes, int row, int col, int value, bool locked = false) {
+    for (const Change& change : changes) {
+        if (change.row == row && change.col == col) {
+            return change.value == value && change.locked == locked;
+        }
+    }
+    return false;
+}
+
+void testDeltaHoldsLatestValues() {
+    BoardHistory history;
+    Board board;
+    uint64_t start = history.record(board);
+    CHECK_EQ(history.getRevision(), start);
+
+    board.getCell(0, 1).setValue(3);
+    uint64_t first = history.record(board);
+    CHECK_EQ(first, start + 1);
+    board.getCell(0, 1).setValue(5);
+    board.getCell(8, 8).setValue(9);
+    board.getCell(8, 8).setLocked(true);
+    uint64_t second = history.record(board);
+    CHECK_EQ(second, first + 1);
+    CHECK_EQ(history.record(board), second);   // Nothing changed: no new revision
+
+    std::vector<Change> changes;
+    CHECK(history.changesSince(start, changes));
+    CHECK_EQ(changes.size(), 2u);   // (0,1) once, with its latest value
+    CHECK(hasChange(changes, 0, 1, 5));
+    CHECK(hasChange(changes, 8, 8, 9, true));
+
+    changes.clear();
+    CHECK(history.changesSince(first, changes));
+    CHECK_EQ(changes.size(), 2u);
+
+    changes.clear();
+    CHECK(history.changesSince(second, changes));   // Up to date
+    CHECK(changes.empty());
+
+    // A cell cleared again is reported as 0, not skipped
+    board.getCell(0, 1).setValue(0);
+    history.record(board);
+    changes.clear();
+    CHECK(history.changesSince(second, changes));
+    CHECK_EQ(changes.size(), 1u);
+    CHECK(hasChange(changes, 0, 1, 0));
+}
+
+void testUnknownRevisionsFallBack() {
+    BoardHistory history;
+    Board board;
+    uint64_t start = history.record(board);
+    std::vector<Change> changes;
+
+    CHECK(!history.changesSince(start - 1, changes));   // Before the first board
+    CHECK(!history.changesSince(start + 1, changes));   // Never issued
+    CHECK(!history.changesSince(1, changes));           // An earlier process's revision
+    CHECK(changes.empty());
+
+    board.getCell(4, 4).setValue(1);
+    uint64_t latest = history.record(board);
+    CHECK(!history.changesSince(latest + 1, changes));
+    CHECK(history.changesSince(latest, changes));
+}
+
+void testWindowEvictsPartOfRevision() {
+    BoardHistory history(3);
+    Board board;
+    uint64_t base = history.record(board);
+
+    board.getCell(0, 0).setValue(1);
+    board.getCell(0, 1).setValue(2);
+    uint64_t first = history.record(board);   // Two entries
+
+    board.getCell(1, 0).setValue(3);
+    board.getCell(1, 1).setValue(4);
+    uint64_t second = history.record(board);  // Four entries: first's (0,0) falls out
+
+    std::vector<Change> changes;
+    // From `base` the (0,0) change would be missing: a full board instead
+    CHECK(!history.changesSince(base, changes));
+    // From `first` everything needed is still there
+    CHECK(history.changesSince(first, changes));
+    CHECK_EQ(changes.size(), 2u);
+    CHECK(hasChange(changes, 1, 0, 3));
+    CHECK(hasChange(changes, 1, 1, 4));
+    changes.clear();
+    CHECK(history.changesSince(second, changes));
+    CHECK(changes.empty());
+
+    // One more change drops the rest of `first`: `first` itself is still fine
+    board.getCell(2, 2).setValue(5);
+    history.record(board);
+    CHECK(history.changesSince(first, changes));
+    CHECK_EQ(changes.size(), 3u);
+
+    // The next drops half of `second`, so `first` is now too far behind
+    board.getCell(3, 3).setValue(6);
+    history.record(board);
+    changes.clear();
+    CHECK(!history.changesSince(first, changes));
+    CHECK(history.changesSince(second, changes));
+    CHECK_EQ(changes.size(), 2u);
+}
+
+void testBoardSizeChangeResets() {
+    BoardHistory history;
+    Board nine;
+    uint64_t start = history.record(nine);
+    nine.getCell(0, 0).setValue(7);
+    uint64_t before = history.record(nine);
+
+    Board four(2);
+    CHECK_EQ(four.getBoardSize(), 4);
+    uint64_t resized = history.record(four);
+    CHECK(resized > before);
+
+    std::vector<Change> changes;
+    CHECK(!history.changesSince(start, changes));
+    CHECK(!history.changesSince(before, changes));   // Its cells are meaningless on 4x4
+    CHECK(history.changesSince(resized, changes));
+    CHECK(changes.empty());
+
+    four.getCell(1, 3).setValue(2);
+    history.record(four);
+    CHECK(history.changesSince(resized, changes));
+    CHECK_EQ(changes.size(), 1u);
+    CHECK(hasChange(changes, 1, 3, 2));   // Positions use the new size
+
+    // Back to 9x9 resets again, even to an identical board
+    uint64_t back = history.record(nine);
+    changes.clear();
+    CHECK(!history.changesSince(resized, changes));
+    CHECK(history.changesSince(back, changes));
+    CHECK(changes.empty());
+}
+
+}
+
+int main() {
+    RUN_TEST(testDeltaHoldsLatestValues);
+    RUN_TEST(testUnknownRevisionsFallBack);
+    RUN_TEST(testWindowEvictsPartOfRevision);
+    RUN_TEST(testBoardSizeChangeResets);
+    return testSummary();
+}
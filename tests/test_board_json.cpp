@@ -0,0 +1,158 @@
+/*
+Board JSON writer tests: both layouts are byte-identical to nlohmann's
+dump() of the same structure (the values layout is what WebView used to
+build with nlohmann) on 4x4, 9x9 and 16x16 boards, and the BoardScan
+returned alongside agrees with Board::isComplete() and isValid() on solved
+boards, boards with gaps, and boards with conflicts.
+*/
+
+#include "../src/model/board_json.h"
+#include "../src/model/sudoku_generator.h"
+#include "test_check.h"
+#include <nlohmann/json.hpp>
+#include <random>
+#include <string>
+
+namespace {
+
+const int kBoxSizes[] = {2, 3, 4};   // 4x4, 9x9, 16x16
+
+std::string nlohmannValues(const Board& board) {
+    nlohmann::json rows = nlohmann::json::array();
+    for (int row = 0; row < board.getBoardSize(); ++row) {
+        nlohmann::json values = nlohmann::json::array();
+        for (int col = 0; col < board.getBoardSize(); ++col) {
+            values.push_back(board.getCell(row, col).getValue());
+        }
+        rows.push_back(values);
+    }
+    return rows.dump();
+}
+
+std::string nlohmannCells(const Board& board) {
+    // ordered_json keeps "value" before "locked", as the API always wrote them
+    nlohmann::ordered_json rows = nlohmann::ordered_json::array();
+    for (int row = 0; row < board.getBoardSize(); ++row) {
+        nlohmann::ordered_json cells = nlohmann::ordered_json::array();
+        for (int col = 0; col < board.getBoardSize(); ++col) {
+            nlohmann::ordered_json cell;
+            cell["value"] = board.getCell(row, col).getValue();
+            cell["locked"] = board.getCell(row, col).isLocked();
+            cells.push_back(cell);
+        }
+        rows.push_back(cells);
+    }
+    nlohmann::ordered_json document;
+    document["cells"] = rows;
+    return document.dump();
+}
+
+// Any values (conflicts likely), some cells empty, some locked
+void randomize(Board& board, std::mt19937& random) {
+    int size = board.getBoardSize();
+    std::uniform_int_distribution<int> value(0, size);
+    for (int row = 0; row < size; ++row) {
+        for (int col = 0; col < size; ++col) {
+            board.getCell(row, col).setValue(value(random));
+            board.getCell(row, col).setLocked(random() % 3 == 0);
+        }
+    }
+}
+
+void checkScan(const Board& board) {
+    std::string json;
+    BoardScan scan = appendBoardJson(json, board, BoardJsonLayout::VALUES);
+    CHECK_EQ(scan.cells, board.getBoardSize() * board.getBoardSize());
+    CHECK_EQ(scan.isComplete(), board.isComplete());
+    CHECK_EQ(scan.conflict, !board.isValid());
+    CHECK_EQ(scan.isSolved(), board.isComplete() && board.isValid());
+}
+
+void testMatchesNlohmannDump() {
+    std::mt19937 random(98);
+    for (int boxSize : kBoxSizes) {
+        for (int round = 0; round < 200; ++round) {
+            Board board(boxSize);
+            if (round > 0) randomize(board, random);   // Round 0: the empty board
+
+            std::string values;
+            appendBoardJson(values, board, BoardJsonLayout::VALUES);
+            std::string cells;
+            appendBoardJson(cells, board, BoardJsonLayout::CELLS);
+            if (values != nlohmannValues(board) || cells != nlohmannCells(board)) {
+                CHECK(!"board JSON differs from the nlohmann dump");
+                std::cerr << "    size " << board.getBoardSize() << " round " << round << "\n";
+                break;
+            }
+        }
+    }
+}
+
+void testAppends() {
+    Board board(2);
+    board.getCell(0, 0).setValue(4);
+    std::string out = "prefix:";
+    appendBoardJson(out, board, BoardJsonLayout::VALUES);
+    CHECK_EQ(out, std::string("prefix:[[4,0,0,0],[0,0,0,0],[0,0,0,0],[0,0,0,0]]"));
+}
+
+void testScanOnSolvedAndGappedBoards() {
+    std::mt19937 random(980);
+    for (int boxSize : kBoxSizes) {
+        SudokuGenerator generator(static_cast<unsigned int>(boxSize));
+        for (int round = 0; round < 10; ++round) {
+            Board board(boxSize);
+            CHECK(generator.generateCompleteGrid(board));
+            checkScan(board);   // Solved
+
+            int size = board.getBoardSize();
+            std::uniform_int_distribution<int> position(0, size - 1);
+            int row = position(random), col = position(random);
+            int value = board.getCell(row, col).getValue();
+            board.getCell(row, col).setValue(0);
+            checkScan(board);   // One gap, no conflict
+
+            // A repeated value: complete, but a row, column and box repeat it
+            board.getCell(row, col).setValue(value % size + 1);
+            checkScan(board);
+            CHECK(!board.isValid());
+            board.getCell(row, col).setValue(value);
+
+            // Conflict among gaps: incomplete and invalid
+            int other = (col + 1) % size;
+            board.getCell(row, other).setValue(0);
+            board.getCell(row, col).setValue(board.getCell(row, (col + 2) % size).getValue());
+            checkScan(board);
+        }
+    }
+}
+
+void testScanOnRandomBoards() {
+    std::mt19937 random(9800);
+    for (int boxSize : kBoxSizes) {
+        for (int round = 0; round < 300; ++round) {
+            Board board(boxSize);
+            randomize(board, random);
+            // Thin most boards out so that both valid and invalid ones occur
+            int size = board.getBoardSize();
+            int keep = static_cast<int>(random() % (size + 1));
+            for (int row = 0; row < size; ++row) {
+                for (int col = 0; col < size; ++col) {
+                    if (static_cast<int>(random() % size) >= keep) board.getCell(row, col).setValue(0);
+                }
+            }
+            checkScan(board);
+        }
+        checkScan(Board(boxSize));   // Empty: valid, not complete
+    }
+}
+
+}
+
+int main() {
+    RUN_TEST(testMatchesNlohmannDump);
+    RUN_TEST(testAppends);
+    RUN_TEST(testScanOnSolvedAndGappedBoards);
+    RUN_TEST(testScanOnRandomBoards);
+    return testSummary();
+}
@@ -0,0 +1,62 @@
+/*
+Minimal checks for the test executables
+Each test is a function; CHECK records a failure with file and line and
+keeps going, so one run reports every broken expectation. main() returns
+testSummary(), which is non-zero when anything failed.
+
+    void testRoundTrip() {
+        CHECK(decode(encode(x)) == x);
+        CHECK_EQ(count, 3);
+    }
+    int main() { RUN_TEST(testRoundTrip); return testSummary(); }
+*/
+
+#ifndef SUDOKU_TESTS_TEST_CHECK_H
+#define SUDOKU_TESTS_TEST_CHECK_H
+
+#include <iostream>
+#include <string>
+
+namespace testing_detail {
+inline int checks = 0;
+inline int failures = 0;
+inline int tests = 0;
+}
+
+#define CHECK(condition)                                                                \
+    do {                                                                                \
+        ++testing_detail::checks;                                                       \
+        if (!(condition)) {                                                             \
+            ++testing_detail::failures;                                                 \
+            std::cerr << "  ❌ " << __FILE__ << ":" << __LINE__ << ": " #condition "\n"; \
+        }                                                                               \
+    } while (0)
+
+#define CHECK_EQ(actual, expected)                                                      \
+    do {                                                                                \
+        ++testing_detail::checks;                                                       \
+        auto actualValue = (actual);                                                    \
+        auto expectedValue = (expected);                                                \
+        if (!(actualValue == expectedValue)) {                                          \
+            ++testing_detail::failures;                                                 \
+            std::cerr << "  ❌ " << __FILE__ << ":" << __LINE__ << ": " #actual " == "  \
+                      << actualValue << ", expected " << expectedValue << "\n";         \
+        }                                                                               \
+    } while (0)
+
+#define RUN_TEST(test)                                                                  \
+    do {                                                                                \
+        ++testing_detail::tests;                                                        \
+        int failuresBefore = testing_detail::failures;                                  \
+        test();                                                                         \
+        std::cout << (testing_detail::failures == failuresBefore ? "✅ " : "❌ ")       \
+                  << #test << "\n";                                                     \
+    } while (0)
+
+inline int testSummary() {
+    std::cout << "🧪 " << testing_detail::tests << " tests, " << testing_detail::checks << " checks, "
+              << testing_detail::failures << " failed\n";
+    return testing_detail::failures == 0 ? 0 : 1;
+}
+
+#endif // SUDOKU_TESTS_TEST_CHECK_H
@@ -0,0 +1,245 @@
+/*
+ConsoleView board rendering tests. Output is captured by pointing stdout at
+a pipe (plain output) or at a pseudo-terminal (diff rendering). A full 9x9
+board is byte-for-byte what the view printed before diff rendering, in both
+modes; piped output repeats the full board and the clear sequence every
+time; on a terminal a one-cell change goes out as a single cursor-addressed
+run, in place of the board or as solve progress.
+*/
+
+#include "../src/view/console_view.h"
+#include "test_check.h"
+#include <cstdlib>
+#include <fcntl.h>
+#include <functional>
+#include <memory>
+#include <poll.h>
+#include <string>
+#include <termios.h>
+#include <unistd.h>
+#include <sys/ioctl.h>
+
+namespace {
+
+const std::string kClearScreen = "\033[2J\033[1;1H";
+
+// showBoardWithCoordinates() as it was before the frame buffer
+std::string oldBoardText(const Board& board) {
+    std::string text = "\n    1 2 3   4 5 6   7 8 9\n";
+    text += "  ┌───────┬───────┬───────┐\n";
+    for (int row = 0; row < board.getBoardSize(); ++row) {
+        text += std::to_string(row + 1) + " │ ";
+        for (int col = 0; col < board.getBoardSize(); ++col) {
+            int value = board.getCell(row, col).getValue();
+            text += value == 0 ? "·" : std::to_string(value);
+            if (col == 2 || col == 5) {
+                text += " │ ";
+            } else if (col == 8) {
+                text += " │";
+            } else {
+                text += " ";
+            }
+        }
+        text += "\n";
+        if (row == 2 || row == 5) {
+            text += "  ├───────┼───────┼───────┤\n";
+        }
+    }
+    text += "  └───────┴───────┴───────┘\n";
+    return text;
+}
+
+// The board from the sample puzzle, with some cells empty
+Board sampleBoard() {
+    const char* rows[] = {
+        "530070000", "600195000", "098000060", "800060003", "400803001",
+        "700020006", "060000280", "000419005", "000080079"
+    };
+    Board board;
+    for (int row = 0; row < 9; ++row) {
+        for (int col = 0; col < 9; ++col) {
+            board.getCell(row, col).setValue(rows[row][col] - '0');
+        }
+    }
+    return board;
+}
+
+// Screen position (1-based) of a cell's digit in the 9x9 picture: a blank
+// line, the column numbers and the top border come first, then a border
+// after every third row; "r │" and " │" before every third column
+int screenRow(int row) {
+    return 4 + row + row / 3;
+}
+
+int screenColumn(int col) {
+    return 5 + 2 * col + 2 * (col / 3);
+}
+
+std::string cursorTo(int row, int col) {
+    return "\033[" + std::to_string(row) + ";" + std::to_string(col) + "H";
+}
+
+// Everything the reading end has, waiting briefly for the write to arrive
+std::string drain(int fd) {
+    std::string data;
+    char buffer[4096];
+    pollfd readable{fd, POLLIN, 0};
+    while (poll(&readable, 1, 100) > 0) {
+        ssize_t n = read(fd, buffer, sizeof(buffer));
+        if (n <= 0) break;
+        data.append(buffer, static_cast<size_t>(n));
+    }
+    return data;
+}
+
+// Points stdout at `target` for the lifetime of the object
+class StdoutRedirect {
+public:
+    explicit StdoutRedirect(int target) : saved(dup(STDOUT_FILENO)) {
+        std::cout.flush();
+        dup2(target, STDOUT_FILENO);
+    }
+    ~StdoutRedirect() {
+        std::cout.flush();
+        dup2(saved, STDOUT_FILENO);
+        close(saved);
+    }
+
+private:
+    int saved;
+};
+
+// A raw pseudo-terminal of 40x100, so the view sees an ANSI terminal
+struct Terminal {
+    int master = -1;
+    int slave = -1;
+
+    Terminal() {
+        master = posix_openpt(O_RDWR | O_NOCTTY);
+        if (master < 0 || grantpt(master) != 0 || unlockpt(master) != 0) return;
+        slave = open(ptsname(master), O_RDWR | O_NOCTTY);
+        if (slave < 0) return;
+        termios mode{};
+        tcgetattr(slave, &mode);
+        cfmakeraw(&mode);   // No "\n" -> "\r\n"
+        tcsetattr(slave, TCSANOW, &mode);
+        winsize size{};
+        size.ws_row = 40;
+        size.ws_col = 100;
+        ioctl(slave, TIOCSWINSZ, &size);
+    }
+    ~Terminal() {
+        if (slave >= 0) close(slave);
+        if (master >= 0) close(master);
+    }
+};
+
+// Runs `draw` with stdout on the terminal and returns what it wrote
+std::string onTerminal(Terminal& terminal, const std::function<void()>& draw) {
+    {
+        StdoutRedirect redirect(terminal.slave);
+        draw();
+    }
+    return drain(terminal.master);
+}
+
+void testPipedOutputIsUnchanged() {
+    int ends[2];
+    CHECK_EQ(pipe(ends), 0);
+    Board board = sampleBoard();
+    {
+        StdoutRedirect redirect(ends[1]);
+        ConsoleView view;   // Decides on diff rendering from stdout, so made here
+        view.clearScreen();
+        view.showBoardWithCoordinates(board);
+        board.getCell(0, 2).setValue(4);
+        view.clearScreen();
+        view.showBoardWithCoordinates(board);
+        view.showSolveProgress(board, 1);   // Nothing on plain output
+    }
+    close(ends[1]);
+    std::string output = drain(ends[0]);
+    close(ends[0]);
+
+    Board before = sampleBoard();
+    CHECK(output == kClearScreen + oldBoardText(before) + kClearScreen + oldBoardText(board));
+}
+
+void testFullBoardOnTerminalMatchesOldOutput() {
+    Terminal terminal;
+    CHECK(terminal.slave >= 0);
+    if (terminal.slave < 0) return;
+    setenv("TERM", "xterm", 1);
+    Board board = sampleBoard();
+
+    std::string first = onTerminal(terminal, [&]() {
+        ConsoleView view;
+        view.clearScreen();
+        view.showBoardWithCoordinates(board);
+    });
+    CHECK(first == kClearScreen + oldBoardText(board));
+
+    // An empty board too: every cell is the "·" glyph
+    Board empty;
+    std::string blank = onTerminal(terminal, [&]() {
+        ConsoleView view;
+        view.clearScreen();
+        view.showBoardWithCoordinates(empty);
+    });
+    CHECK(blank == kClearScreen + oldBoardText(empty));
+}
+
+void testOneCellChangeIsOneRun() {
+    Terminal terminal;
+    if (terminal.slave < 0) return;
+    setenv("TERM", "xterm", 1);
+    Board board = sampleBoard();
+    std::unique_ptr<ConsoleView> view;
+    onTerminal(terminal, [&]() {
+        view = std::make_unique<ConsoleView>();
+        view->clearScreen();
+        view->showBoardWithCoordinates(board);
+    });
+
+    // Redrawn after clearScreen(): the digit, then the text below is erased
+    board.getCell(4, 4).setValue(5);
+    std::string redraw = onTerminal(terminal, [&]() {
+        view->clearScreen();
+        view->showBoardWithCoordinates(board);
+    });
+    std::string belowBoard = cursorTo(16, 1) + "\033[J";   // 15 lines of board
+    CHECK(redraw == cursorTo(screenRow(4), screenColumn(4)) + "5" + belowBoard);
+
+    // Solve progress: in place, with the cursor saved and restored around it
+    board.getCell(8, 0).setValue(1);
+    std::string progress = onTerminal(terminal, [&]() { view->showSolveProgress(board, 1); });
+    CHECK(progress == "\0337" + cursorTo(screenRow(8), screenColumn(0)) + "1" + "\0338");
+
+    // Two changes a few columns apart still go as one run, through the glyphs between
+    board.getCell(0, 2).setValue(4);
+    board.getCell(0, 3).setValue(6);
+    progress = onTerminal(terminal, [&]() { view->showSolveProgress(board, 2); });
+    CHECK(progress == "\0337" + cursorTo(screenRow(0), screenColumn(2)) + "4 │ 6" + "\0338");
+
+    // Nothing changed: nothing but the cursor save and restore
+    progress = onTerminal(terminal, [&]() { view->showSolveProgress(board, 3); });
+    CHECK(progress == "\0337\0338");
+
+    // Other output on top of the board: the next board is drawn in full again
+    std::string full = onTerminal(terminal, [&]() {
+        view->clearScreen();
+        view->showMessage("hello");
+        view->clearScreen();
+        view->showBoardWithCoordinates(board);
+    });
+    CHECK(full == kClearScreen + "💬 hello\n" + kClearScreen + oldBoardText(board));
+}
+
+}
+
+int main() {
+    RUN_TEST(testPipedOutputIsUnchanged);
+    RUN_TEST(testFullBoardOnTerminalMatchesOldOutput);
+    RUN_TEST(testOneCellChangeIsOneRun);
+    return testSummary();
+}
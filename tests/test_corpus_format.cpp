@@ -0,0 +1,319 @@
+/*
+Compressed corpus (.sdkc) tests: round trips for 4x4 and 9x9 puzzles across
+several blocks with a partial last one, random access through the block
+index, and rejection of files that are not corpora, were never finished,
+are truncated or have a corrupt header, index or block.
+Every test works in its own temporary directory.
+*/
+
+#include "../src/io/corpus_format.h"
+#include "test_check.h"
+#include <algorithm>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace {
+
+class TempDir {
+public:
+    TempDir() {
+        char pattern[] = "/tmp/sudoku_corpus_test_XXXXXX";
+        path = ::mkdtemp(pattern);
+    }
+    ~TempDir() { std::filesystem::remove_all(path); }
+    std::string file(const std::string& name) const { return path + "/" + name; }
+
+private:
+    std::string path;
+};
+
+std::string readFile(const std::string& path) {
+    std::ifstream file(path, std::ios::binary);
+    std::ostringstream contents;
+    contents << file.rdbuf();
+    return contents.str();
+}
+
+void writeFile(const std::string& path, const std::string& contents) {
+    std::ofstream file(path, std::ios::binary | std::ios::trunc);
+    file << contents;
+}
+
+uint64_t getU64(const std::string& data, size_t at) {
+    uint64_t value = 0;
+    for (int i = 7; i >= 0; --i) value = (value << 8) | static_cast<unsigned char>(data[at + i]);
+    return value;
+}
+
+void putU64(std::string& data, size_t at, uint64_t value) {
+    for (int i = 0; i < 8; ++i) data[at + i] = static_cast<char>(value >> (8 * i));
+}
+
+// Puzzle-shaped cell strings: every other one point-symmetric like most
+// published puzzles, with between a quarter and a half of the cells given
+std::vector<std::string> makePuzzles(int boardSize, size_t count, unsigned seed) {
+    std::mt19937 random(seed);
+    size_t cellCount = static_cast<size_t>(boardSize) * boardSize;
+    std::vector<std::string> puzzles;
+    for (size_t n = 0; n < count; ++n) {
+        std::string cells(cellCount, '0');
+        std::uniform_int_distribution<int> digit(1, boardSize);
+        size_t givens = cellCount / 4 + random() % (cellCount / 4 + 1);
+        for (size_t g = 0; g < givens; ++g) {
+            size_t cell = random() % cellCount;
+            cells[cell] = static_cast<char>('0' + digit(random));
+            if (n % 2 == 0) {
+                cells[cellCount - 1 - cell] = static_cast<char>('0' + digit(random));
+            }
+        }
+        puzzles.push_back(cells);
+    }
+    return puzzles;
+}
+
+bool writeCorpus(const std::string& path, const std::vector<std::string>& puzzles, uint32_t blockSize) {
+    CorpusWriter writer(blockSize);
+    std::string error;
+    if (!writer.open(path, error)) return false;
+    for (const std::string& cells : puzzles) {
+        if (!writer.add(cells, error)) return false;
+    }
+    return writer.close(error);
+}
+
+// Opening must fail; returns the error for callers that check its wording
+std::string openError(const std::string& path) {
+    CorpusFile corpus;
+    std::string error;
+    CHECK(!corpus.open(path, error));
+    CHECK(!error.empty());
+    return error;
+}
+
+void checkRoundTrip(int boardSize, size_t count, uint32_t blockSize) {
+    TempDir dir;
+    std::vector<std::string> puzzles = makePuzzles(boardSize, count, 17u + boardSize);
+    CHECK(writeCorpus(dir.file("corpus.sdkc"), puzzles, blockSize));
+    CHECK(isCorpusFile(dir.file("corpus.sdkc")));
+
+    CorpusFile corpus;
+    std::string error;
+    CHECK(corpus.open(dir.file("corpus.sdkc"), error));
+    const CorpusHeader& header = corpus.getHeader();
+    CHECK_EQ(header.boardSize, boardSize);
+    CHECK_EQ(header.puzzleCount, static_cast<uint64_t>(count));
+    CHECK_EQ(header.blockSize, blockSize);
+    CHECK_EQ(header.blockCount, static_cast<uint32_t>((count + blockSize - 1) / blockSize));
+    uint64_t histogramTotal = 0;
+    for (uint64_t band : header.difficultyHistogram) histogramTotal += band;
+    CHECK_EQ(histogramTotal, static_cast<uint64_t>(count));
+
+    std::string decoded;
+    for (uint32_t block = 0; block < header.blockCount; ++block) {
+        std::string cells;
+        CHECK(corpus.readBlock(block, cells, error));
+        decoded += cells;
+    }
+    std::string expected;
+    for (const std::string& cells : puzzles) expected += cells;
+    CHECK(decoded == expected);
+
+    // The givens bitmap alone is a bit per cell against a byte per cell raw
+    CHECK(std::filesystem::file_size(dir.file("corpus.sdkc")) < expected.size() / 2);
+}
+
+void testRoundTrip9x9() {
+    checkRoundTrip(9, 2500, CorpusWriter::kDefaultBlockSize);
+}
+
+void testRoundTrip4x4() {
+    checkRoundTrip(4, 100, 16);
+}
+
+void testPartialLastBlock() {
+    TempDir dir;
+    std::vector<std::string> puzzles = makePuzzles(9, 25, 3);
+    CHECK(writeCorpus(dir.file("partial.sdkc"), puzzles, 10));
+
+    CorpusFile corpus;
+    std::string error;
+    CHECK(corpus.open(dir.file("partial.sdkc"), error));
+    CHECK_EQ(corpus.getHeader().blockCount, 3u);
+    std::string cells;
+    CHECK(corpus.readBlock(2, cells, error));
+    CHECK_EQ(cells.size(), 5 * corpus.cellsPerPuzzle());
+    CHECK(cells == puzzles[20] + puzzles[21] + puzzles[22] + puzzles[23] + puzzles[24]);
+
+    // A count that fills its blocks exactly leaves no empty block behind
+    puzzles.resize(20);
+    CHECK(writeCorpus(dir.file("exact.sdkc"), puzzles, 10));
+    CorpusFile exact;
+    CHECK(exact.open(dir.file("exact.sdkc"), error));
+    CHECK_EQ(exact.getHeader().blockCount, 2u);
+    CHECK(exact.readBlock(1, cells, error));
+    CHECK_EQ(cells.size(), 10 * exact.cellsPerPuzzle());
+}
+
+void testRandomAccess() {
+    TempDir dir;
+    std::vector<std::string> puzzles = makePuzzles(9, 500, 11);
+    CHECK(writeCorpus(dir.file("corpus.sdkc"), puzzles, 64));
+
+    CorpusFile corpus;
+    std::string error;
+    CHECK(corpus.open(dir.file("corpus.sdkc"), error));
+    std::mt19937 random(5);
+    for (int i = 0; i < 200; ++i) {
+        uint64_t index = random() % puzzles.size();
+        std::string cells;
+        CHECK(corpus.getPuzzle(index, cells, error));
+        CHECK(cells == puzzles[index]);
+    }
+    std::string cells;
+    CHECK(corpus.getPuzzle(499, cells, error));
+    CHECK(cells == puzzles[499]);
+    CHECK(!corpus.getPuzzle(500, cells, error));
+    CHECK(!corpus.readBlock(corpus.getHeader().blockCount, cells, error));
+}
+
+void testEmptyCorpus() {
+    TempDir dir;
+    CHECK(writeCorpus(dir.file("empty.sdkc"), {}, 8));
+    CorpusFile corpus;
+    std::string error;
+    CHECK(corpus.open(dir.file("empty.sdkc"), error));
+    CHECK_EQ(corpus.size(), 0u);
+    std::string cells;
+    CHECK(!corpus.getPuzzle(0, cells, error));
+}
+
+void testWriterRejectsBadPuzzles() {
+    TempDir dir;
+    CorpusWriter writer;
+    std::string error;
+    CHECK(writer.open(dir.file("corpus.sdkc"), error));
+    CHECK(!writer.add("12345", error));                      // No board size
+    CHECK(!writer.add(std::string(16, '5'), error));         // 5 on a 4x4 board
+    CHECK(writer.add(std::string(81, '0'), error));
+    CHECK(!writer.add(std::string(16, '0'), error));         // Mixed sizes
+    CHECK(writer.close(error));
+}
+
+void testRejectsNonCorpus() {
+    TempDir dir;
+    writeFile(dir.file("puzzles.txt"), std::string(81, '0') + "\n");
+    CHECK(!isCorpusFile(dir.file("puzzles.txt")));
+    openError(dir.file("puzzles.txt"));
+    openError(dir.file("missing.sdkc"));
+
+    // A writer that never closed leaves its zeroed placeholder header
+    {
+        CorpusWriter writer;
+        std::string error;
+        CHECK(writer.open(dir.file("unfinished.sdkc"), error));
+        CHECK(writer.add(std::string(81, '0'), error));
+    }
+    CHECK(!isCorpusFile(dir.file("unfinished.sdkc")));
+    openError(dir.file("unfinished.sdkc"));
+}
+
+void testRejectsCorruptHeader() {
+    TempDir dir;
+    CHECK(writeCorpus(dir.file("corpus.sdkc"), makePuzzles(9, 40, 7), 16));
+    std::string good = readFile(dir.file("corpus.sdkc"));
+
+    writeFile(dir.file("short.sdkc"), good.substr(0, 40));   // Header cut short
+    openError(dir.file("short.sdkc"));
+
+    std::string version = good;
+    version[4] = 2;
+    writeFile(dir.file("version.sdkc"), version);
+    CHECK(openError(dir.file("version.sdkc")).find("version") != std::string::npos);
+
+    std::string blocks = good;
+    blocks[12] = 7;   // Block count disagrees with puzzle count / block size
+    writeFile(dir.file("blocks.sdkc"), blocks);
+    openError(dir.file("blocks.sdkc"));
+
+    std::string size = good;
+    size[6] = 5;      // Board size
+    writeFile(dir.file("size.sdkc"), size);
+    openError(dir.file("size.sdkc"));
+}
+
+void testRejectsTruncatedFile() {
+    TempDir dir;
+    CHECK(writeCorpus(dir.file("corpus.sdkc"), makePuzzles(9, 40, 8), 16));
+    std::string good = readFile(dir.file("corpus.sdkc"));
+
+    // Losing any tail of the file loses part of the block index
+    writeFile(dir.file("truncated.sdkc"), good.substr(0, good.size() - 3));
+    CHECK(openError(dir.file("truncated.sdkc")).find("truncated") != std::string::npos);
+    writeFile(dir.file("halved.sdkc"), good.substr(0, good.size() / 2));
+    openError(dir.file("halved.sdkc"));
+}
+
+void testRejectsCorruptIndex() {
+    TempDir dir;
+    CHECK(writeCorpus(dir.file("corpus.sdkc"), makePuzzles(9, 40, 9), 16));
+    std::string good = readFile(dir.file("corpus.sdkc"));
+    size_t indexOffset = static_cast<size_t>(getU64(good, 24));
+
+    std::string backwards = good;
+    putU64(backwards, indexOffset + 8, getU64(good, indexOffset) - 1);   // Block 1 before block 0
+    writeFile(dir.file("backwards.sdkc"), backwards);
+    CHECK(openError(dir.file("backwards.sdkc")).find("index") != std::string::npos);
+
+    std::string beyond = good;
+    putU64(beyond, indexOffset + 16, indexOffset + 100);   // Block 2 past the index
+    writeFile(dir.file("beyond.sdkc"), beyond);
+    openError(dir.file("beyond.sdkc"));
+}
+
+void testRejectsCorruptBlock() {
+    TempDir dir;
+    std::vector<std::string> puzzles = makePuzzles(9, 300, 10);
+    CHECK(writeCorpus(dir.file("corpus.sdkc"), puzzles, 100));
+    std::string data = readFile(dir.file("corpus.sdkc"));
+    size_t indexOffset = static_cast<size_t>(getU64(data, 24));
+    size_t block1 = static_cast<size_t>(getU64(data, indexOffset + 8));
+    size_t block2 = static_cast<size_t>(getU64(data, indexOffset + 16));
+    std::fill(data.begin() + block1, data.begin() + block2, static_cast<char>(0xA5));
+    writeFile(dir.file("corrupt.sdkc"), data);
+
+    CorpusFile corpus;
+    std::string error;
+    CHECK(corpus.open(dir.file("corrupt.sdkc"), error));
+    std::string cells;
+    CHECK(!corpus.readBlock(1, cells, error));
+    CHECK(error.find("corrupt block 1") != std::string::npos);
+    CHECK(!corpus.getPuzzle(150, cells, error));
+
+    // Blocks are independent: the others still decode
+    CHECK(corpus.getPuzzle(42, cells, error));
+    CHECK(cells == puzzles[42]);
+    CHECK(corpus.getPuzzle(250, cells, error));
+    CHECK(cells == puzzles[250]);
+}
+
+}
+
+int main() {
+    RUN_TEST(testRoundTrip9x9);
+    RUN_TEST(testRoundTrip4x4);
+    RUN_TEST(testPartialLastBlock);
+    RUN_TEST(testRandomAccess);
+    RUN_TEST(testEmptyCorpus);
+    RUN_TEST(testWriterRejectsBadPuzzles);
+    RUN_TEST(testRejectsNonCorpus);
+    RUN_TEST(testRejectsCorruptHeader);
+    RUN_TEST(testRejectsTruncatedFile);
+    RUN_TEST(testRejectsCorruptIndex);
+    RUN_TEST(testRejectsCorruptBlock);
+    return testSummary();
+}
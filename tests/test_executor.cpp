@@ -0,0 +1,137 @@
+/*
+Executor and TaskGroup tests: a waiting group runs its own queued tasks when
+every worker is busy, never picks up other work while it waits (a priority
+inversion when that work is a long background task), and nested groups
+finish on a small pool.
+*/
+
+#include "../src/util/executor.h"
+#include "test_check.h"
+#include <atomic>
+#include <chrono>
+#include <future>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+namespace {
+
+Executor::Options poolOf(int threads) {
+    Executor::Options options;
+    options.threads = threads;
+    options.numaAware = false;
+    return options;
+}
+
+void waitUntil(const std::atomic<bool>& flag) {
+    while (!flag.load()) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+}
+
+// Occupies one worker until the returned promise is set
+std::promise<void> blockWorker(Executor& executor) {
+    std::promise<void> gate;
+    std::shared_future<void> released = gate.get_future().share();
+    std::atomic<bool> started{false};
+    executor.submit([released, &started]() {
+        started = true;
+        released.wait();
+    }, TaskPriority::HIGH);
+    waitUntil(started);
+    return gate;
+}
+
+void testWaitRunsOwnTasksWhenWorkersBusy() {
+    Executor executor(poolOf(1));
+    std::promise<void> gate = blockWorker(executor);
+
+    std::mutex mutex;
+    std::vector<std::thread::id> ranOn;
+    TaskGroup group(TaskPriority::NORMAL, executor);
+    for (int i = 0; i < 4; ++i) {
+        group.run([&]() {
+            std::lock_guard<std::mutex> lock(mutex);
+            ranOn.push_back(std::this_thread::get_id());
+        });
+    }
+    group.wait();   // The only worker is blocked, so this thread runs them all
+
+    CHECK_EQ(ranOn.size(), 4u);
+    for (std::thread::id id : ranOn) {
+        CHECK(id == std::this_thread::get_id());
+    }
+    gate.set_value();
+}
+
+void testWaitDoesNotRunOtherWork() {
+    std::atomic<bool> foreignRan{false};
+    std::thread::id foreignThread;
+    {
+        Executor executor(poolOf(2));
+        std::promise<void> gate = blockWorker(executor);
+
+        // The group's only task runs on the other worker for a while
+        TaskGroup group(TaskPriority::HIGH, executor);
+        std::atomic<bool> started{false};
+        group.run([&started]() {
+            started = true;
+            std::this_thread::sleep_for(std::chrono::milliseconds(50));
+        });
+        waitUntil(started);
+
+        // Unrelated background work queued while the group waits
+        executor.submit([&]() {
+            foreignThread = std::this_thread::get_id();
+            foreignRan = true;
+        }, TaskPriority::BACKGROUND);
+
+        group.wait();   // Free meanwhile, but must leave the background task alone
+        gate.set_value();
+    }   // The pool drains its queues before it stops
+    CHECK(foreignRan.load());
+    CHECK(foreignThread != std::this_thread::get_id());
+}
+
+void testNestedGroups() {
+    Executor executor(poolOf(2));
+    std::atomic<int> sum{0};
+    TaskGroup outer(TaskPriority::NORMAL, executor);
+    for (int i = 0; i < 8; ++i) {
+        outer.run([&executor, &sum]() {
+            // Workers waiting here help only the inner group, which still finishes
+            TaskGroup inner(TaskPriority::NORMAL, executor);
+            for (int j = 1; j <= 10; ++j) {
+                inner.run([&sum, j]() { sum += j; });
+            }
+            inner.wait();
+        });
+    }
+    outer.wait();
+    CHECK_EQ(sum.load(), 8 * 55);
+}
+
+void testExceptionIsRethrown() {
+    Executor executor(poolOf(2));
+    TaskGroup group(TaskPriority::NORMAL, executor);
+    group.run([]() { throw std::runtime_error("task failed"); });
+    group.run([]() {});
+    bool thrown = false;
+    try {
+        group.wait();
+    } catch (const std::runtime_error&) {
+        thrown = true;
+    }
+    CHECK(thrown);
+}
+
+}
+
+int main() {
+    RUN_TEST(testWaitRunsOwnTasksWhenWorkersBusy);
+    RUN_TEST(testWaitDoesNotRunOtherWork);
+    RUN_TEST(testNestedGroups);
+    RUN_TEST(testExceptionIsRethrown);
+    return testSummary();
+}
@@ -0,0 +1,309 @@
+/*
+MoveJournal tests: replay on top of a snapshot, torn-tail truncation,
+idempotent replay after a crash between snapshot rename and journal
+truncation, group commit, and compaction that fails to write its snapshot.
+Every test works in its own temporary directory.
+*/
+
+#include "../src/api/move_journal.h"
+#include "test_check.h"
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace {
+
+class TempDir {
+public:
+    TempDir() {
+        char pattern[] = "/tmp/sudoku_journal_test_XXXXXX";
+        path = ::mkdtemp(pattern);
+    }
+    ~TempDir() { std::filesystem::remove_all(path); }
+    std::string file(const std::string& name) const { return path + "/" + name; }
+
+private:
+    std::string path;
+};
+
+std::string readFile(const std::string& path) {
+    std::ifstream file(path, std::ios::binary);
+    std::ostringstream contents;
+    contents << file.rdbuf();
+    return contents.str();
+}
+
+void writeFile(const std::string& path, const std::string& contents) {
+    std::ofstream file(path, std::ios::binary | std::ios::trunc);
+    file << contents;
+}
+
+size_t fileSize(const std::string& path) {
+    std::error_code error;
+    auto size = std::filesystem::file_size(path, error);
+    return error ? 0 : static_cast<size_t>(size);
+}
+
+// Sets a cell the way the API does and journals the change
+void move(MoveJournal& journal, Board& board, int& moveCount, int row, int col, int value) {
+    board.getCell(row, col).setValue(value);
+    ++moveCount;
+    journal.appendChanges(moveCount, board.getBoardSize(), {{row, col, value, false}});
+}
+
+bool sameCells(const Board& a, const Board& b) {
+    if (a.getBoardSize() != b.getBoardSize()) return false;
+    for (int row = 0; row < a.getBoardSize(); ++row) {
+        for (int col = 0; col < a.getBoardSize(); ++col) {
+            if (a.getCell(row, col).getValue() != b.getCell(row, col).getValue() ||
+                a.getCell(row, col).isLocked() != b.getCell(row, col).isLocked()) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+void testReplayOnSnapshot() {
+    TempDir dir;
+    Board snapshot;
+    snapshot.getCell(0, 0).setValue(5);
+    snapshot.getCell(0, 0).setLocked(true);
+
+    Board expected = snapshot;
+    int moveCount = 0;
+    {
+        MoveJournal journal(dir.file("journal"), dir.file("state.json"));
+        move(journal, expected, moveCount, 0, 1, 3);
+        move(journal, expected, moveCount, 4, 4, 7);
+        move(journal, expected, moveCount, 0, 1, 0);   // Cleared again
+        journal.appendBoard(moveCount, expected);
+        move(journal, expected, moveCount, 8, 8, 9);
+    }   // The destructor commits what is buffered
+
+    Board board = snapshot;
+    int replayedMoves = 0;
+    MoveJournal reader(dir.file("journal"), dir.file("state.json"));
+    CHECK_EQ(reader.replay(board, replayedMoves), 5u);
+    CHECK(sameCells(board, expected));
+    CHECK_EQ(replayedMoves, 4);
+    CHECK(board.getCell(0, 0).isLocked());
+    CHECK_EQ(board.getCell(0, 1).getValue(), 0);
+}
+
+void testReplayWithoutJournal() {
+    TempDir dir;
+    Board board;
+    int moveCount = 7;
+    MoveJournal journal(dir.file("journal"), dir.file("state.json"));
+    CHECK_EQ(journal.replay(board, moveCount), 0u);
+    CHECK_EQ(moveCount, 7);
+}
+
+void testTornTailIsTruncated() {
+    TempDir dir;
+    Board expected;
+    int moveCount = 0;
+    {
+        MoveJournal journal(dir.file("journal"), dir.file("state.json"));
+        move(journal, expected, moveCount, 1, 1, 4);
+        move(journal, expected, moveCount, 2, 2, 6);
+        journal.flush();
+    }
+    size_t intact = fileSize(dir.file("journal"));
+    CHECK(intact > 0);
+
+    // A crash in the middle of the next write leaves part of a record
+    std::string contents = readFile(dir.file("journal"));
+    std::string torn = contents.substr(0, 13);   // Header and part of a body
+    writeFile(dir.file("journal"), contents + torn);
+
+    Board board;
+    int replayedMoves = 0;
+    {
+        MoveJournal journal(dir.file("journal"), dir.file("state.json"));
+        CHECK_EQ(journal.replay(board, replayedMoves), 2u);
+        CHECK(sameCells(board, expected));
+        CHECK_EQ(fileSize(dir.file("journal")), intact);
+
+        // Appends after recovery follow the intact records
+        move(journal, expected, moveCount, 3, 3, 8);
+        journal.flush();
+    }
+    Board again;
+    replayedMoves = 0;
+    MoveJournal reader(dir.file("journal"), dir.file("state.json"));
+    CHECK_EQ(reader.replay(again, replayedMoves), 3u);
+    CHECK(sameCells(again, expected));
+    CHECK_EQ(replayedMoves, 3);
+}
+
+void testCorruptRecordStopsReplay() {
+    TempDir dir;
+    Board board;
+    int moveCount = 0;
+    {
+        MoveJournal journal(dir.file("journal"), dir.file("state.json"));
+        move(journal, board, moveCount, 0, 0, 1);
+        move(journal, board, moveCount, 0, 1, 2);
+        journal.flush();
+    }
+    // Flip a byte in the second record's body: its checksum no longer matches
+    std::string contents = readFile(dir.file("journal"));
+    contents[contents.size() - 1] ^= 0x01;
+    writeFile(dir.file("journal"), contents);
+
+    Board replayed;
+    int replayedMoves = 0;
+    MoveJournal journal(dir.file("journal"), dir.file("state.json"));
+    CHECK_EQ(journal.replay(replayed, replayedMoves), 1u);
+    CHECK_EQ(replayed.getCell(0, 0).getValue(), 1);
+    CHECK_EQ(replayed.getCell(0, 1).getValue(), 0);
+    CHECK_EQ(replayedMoves, 1);
+}
+
+void testReplayIsIdempotentAfterSnapshot() {
+    // A crash between the snapshot rename and the journal truncation leaves
+    // a snapshot that already contains every journalled record
+    TempDir dir;
+    Board final;
+    int moveCount = 0;
+    {
+        MoveJournal journal(dir.file("journal"), dir.file("state.json"));
+        move(journal, final, moveCount, 0, 0, 9);
+        move(journal, final, moveCount, 0, 0, 0);
+        move(journal, final, moveCount, 5, 5, 2);
+        move(journal, final, moveCount, 6, 7, 1);
+        journal.flush();
+    }
+
+    Board board = final;
+    int replayedMoves = moveCount;
+    MoveJournal journal(dir.file("journal"), dir.file("state.json"));
+    CHECK_EQ(journal.replay(board, replayedMoves), 4u);
+    CHECK(sameCells(board, final));
+    CHECK_EQ(replayedMoves, moveCount);
+
+    // And replaying the same journal twice changes nothing either
+    Board twice = board;
+    MoveJournal reader(dir.file("journal"), dir.file("state.json"));
+    reader.replay(twice, replayedMoves);
+    CHECK(sameCells(twice, final));
+}
+
+void testGroupCommit() {
+    TempDir dir;
+    Board expected;
+    int moveCount = 0;
+    MoveJournal journal(dir.file("journal"), dir.file("state.json"), 50);
+    for (int i = 0; i < 200; ++i) {
+        move(journal, expected, moveCount, i % 9, (i / 9) % 9, i % 9 + 1);
+    }
+    journal.flush();
+    // 200 appends inside one commit interval share a handful of write+sync batches
+    CHECK(journal.getCommitCount() >= 1);
+    CHECK(journal.getCommitCount() <= 3);
+
+    Board board;
+    int replayedMoves = 0;
+    MoveJournal reader(dir.file("journal"), dir.file("state.json"));
+    CHECK_EQ(reader.replay(board, replayedMoves), 200u);
+    CHECK(sameCells(board, expected));
+    CHECK_EQ(replayedMoves, 200);
+}
+
+void testCompaction() {
+    TempDir dir;
+    Board board;
+    int moveCount = 0;
+    MoveJournal journal(dir.file("journal"), dir.file("state.json"), 5, 64);
+    move(journal, board, moveCount, 0, 0, 1);
+    move(journal, board, moveCount, 0, 1, 2);
+    move(journal, board, moveCount, 0, 2, 3);
+    move(journal, board, moveCount, 0, 3, 4);
+    CHECK(journal.needsCompaction());
+
+    journal.compact("snapshot-1");
+    journal.flush();
+    CHECK_EQ(readFile(dir.file("state.json")), std::string("snapshot-1"));
+    CHECK_EQ(fileSize(dir.file("journal")), 0u);
+    CHECK(!journal.needsCompaction());
+    CHECK(!std::filesystem::exists(dir.file("state.json.tmp")));
+
+    // Records after the snapshot go to the emptied journal
+    Board snapshot = board;
+    move(journal, board, moveCount, 1, 0, 5);
+    journal.flush();
+    Board replayed = snapshot;
+    int replayedMoves = 4;
+    MoveJournal reader(dir.file("journal"), dir.file("state.json"));
+    CHECK_EQ(reader.replay(replayed, replayedMoves), 1u);
+    CHECK(sameCells(replayed, board));
+}
+
+void testFailedCompactionKeepsRecords() {
+    TempDir dir;
+    Board board;
+    int moveCount = 0;
+    // The snapshot's directory does not exist, so writing it fails
+    MoveJournal journal(dir.file("journal"), dir.file("missing/state.json"), 5, 64);
+    move(journal, board, moveCount, 0, 0, 1);
+    move(journal, board, moveCount, 0, 1, 2);
+    journal.flush();
+    move(journal, board, moveCount, 0, 2, 3);
+    move(journal, board, moveCount, 0, 3, 4);
+    CHECK(journal.needsCompaction());
+
+    // As commitBoardChange does: the triggering record was just appended
+    journal.compact("snapshot");
+    CHECK(!journal.needsCompaction());   // Attempt in flight
+    journal.flush();
+    CHECK(!std::filesystem::exists(dir.file("missing/state.json")));
+    CHECK(journal.needsCompaction());    // Asks again
+
+    // Nothing was lost: the journal still rebuilds the board from the old snapshot
+    Board replayed;
+    int replayedMoves = 0;
+    MoveJournal reader(dir.file("journal"), dir.file("state.json"));
+    CHECK_EQ(reader.replay(replayed, replayedMoves), 4u);
+    CHECK(sameCells(replayed, board));
+    CHECK_EQ(replayedMoves, 4);
+}
+
+void testSnapshotCoversOnlyEarlierRecords() {
+    TempDir dir;
+    Board board;
+    int moveCount = 0;
+    MoveJournal journal(dir.file("journal"), dir.file("state.json"), 20, 1 << 20);
+    move(journal, board, moveCount, 0, 0, 1);
+    Board snapshot = board;
+    journal.compact("snapshot");
+    // Appended after the snapshot was taken, possibly in the same commit batch
+    move(journal, board, moveCount, 2, 2, 7);
+    journal.flush();
+
+    Board replayed = snapshot;
+    int replayedMoves = 1;
+    MoveJournal reader(dir.file("journal"), dir.file("state.json"));
+    CHECK_EQ(reader.replay(replayed, replayedMoves), 1u);
+    CHECK(sameCells(replayed, board));
+    CHECK_EQ(replayedMoves, 2);
+}
+
+}
+
+int main() {
+    RUN_TEST(testReplayOnSnapshot);
+    RUN_TEST(testReplayWithoutJournal);
+    RUN_TEST(testTornTailIsTruncated);
+    RUN_TEST(testCorruptRecordStopsReplay);
+    RUN_TEST(testReplayIsIdempotentAfterSnapshot);
+    RUN_TEST(testGroupCommit);
+    RUN_TEST(testCompaction);
+    RUN_TEST(testFailedCompactionKeepsRecords);
+    RUN_TEST(testSnapshotCoversOnlyEarlierRecords);
+    return testSummary();
+}
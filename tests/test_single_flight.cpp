@@ -0,0 +1,137 @@
+/*
+SingleFlight tests: callers arriving with one key while its computation
+runs share that one computation's value (the same object) or its exception,
+tryJoin joins only a running call, and a call after the first has finished
+computes again.
+*/
+
+#include "../src/util/single_flight.h"
+#include "test_check.h"
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+
+using Flight = SingleFlight<std::string, std::shared_ptr<const int>>;
+
+const int kCallers = 8;
+
+// Blocks the computation until every other caller has joined it
+void waitForJoined(const Flight& flight, uint64_t joined) {
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(10);
+    while (flight.getSharedCount() < joined && std::chrono::steady_clock::now() < deadline) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+}
+
+void testConcurrentCallersShareOneComputation() {
+    Flight flight;
+    std::atomic<int> computed{0};
+    std::atomic<int> leaders{0};
+    std::vector<std::shared_ptr<const int>> results(kCallers);
+    std::vector<std::thread> callers;
+    for (int i = 0; i < kCallers; ++i) {
+        callers.emplace_back([&, i]() {
+            bool joined = true;
+            results[i] = flight.run("board", [&]() {
+                computed++;
+                waitForJoined(flight, kCallers - 1);
+                return std::make_shared<const int>(42);
+            }, &joined);
+            if (!joined) leaders++;
+        });
+    }
+    for (std::thread& caller : callers) caller.join();
+
+    CHECK_EQ(computed.load(), 1);
+    CHECK_EQ(leaders.load(), 1);
+    CHECK_EQ(flight.getSharedCount(), static_cast<uint64_t>(kCallers - 1));
+    for (const auto& result : results) {
+        CHECK(result != nullptr);
+        CHECK(result == results[0]);   // One object, not equal copies
+    }
+    CHECK_EQ(*results[0], 42);
+}
+
+void testExceptionReachesEveryCaller() {
+    Flight flight;
+    std::atomic<int> computed{0};
+    std::atomic<int> caught{0};
+    std::vector<std::thread> callers;
+    for (int i = 0; i < kCallers; ++i) {
+        callers.emplace_back([&]() {
+            try {
+                flight.run("board", [&]() -> std::shared_ptr<const int> {
+                    computed++;
+                    waitForJoined(flight, kCallers - 1);
+                    throw std::runtime_error("solver failed");
+                });
+            } catch (const std::runtime_error& error) {
+                if (std::string(error.what()) == "solver failed") caught++;
+            }
+        });
+    }
+    for (std::thread& caller : callers) caller.join();
+    CHECK_EQ(computed.load(), 1);
+    CHECK_EQ(caught.load(), kCallers);
+
+    // The failed call is forgotten like a successful one
+    bool joined = true;
+    CHECK_EQ(*flight.run("board", []() { return std::make_shared<const int>(7); }, &joined), 7);
+    CHECK(!joined);
+}
+
+void testCallAfterFinishComputesAgain() {
+    Flight flight;
+    int computed = 0;
+    auto compute = [&]() { return std::make_shared<const int>(++computed); };
+    bool joined = true;
+    std::shared_ptr<const int> first = flight.run("board", compute, &joined);
+    CHECK(!joined);
+    std::shared_ptr<const int> second = flight.run("board", compute, &joined);
+    CHECK(!joined);
+    CHECK_EQ(*first, 1);
+    CHECK_EQ(*second, 2);
+    CHECK_EQ(flight.getSharedCount(), 0u);
+    CHECK(!flight.tryJoin("board"));
+}
+
+void testTryJoinOnlyJoinsRunningCalls() {
+    Flight flight;
+    CHECK(!flight.tryJoin("board"));
+
+    std::atomic<bool> started{false};
+    std::atomic<bool> proceed{false};
+    std::thread leader([&]() {
+        flight.run("board", [&]() {
+            started = true;
+            while (!proceed) std::this_thread::sleep_for(std::chrono::milliseconds(1));
+            return std::make_shared<const int>(9);
+        });
+    });
+    while (!started) std::this_thread::sleep_for(std::chrono::milliseconds(1));
+
+    CHECK(!flight.tryJoin("other key"));
+    auto joined = flight.tryJoin("board");
+    CHECK(joined.has_value());
+    CHECK_EQ(flight.getSharedCount(), 1u);
+    proceed = true;
+    if (joined) CHECK_EQ(*joined->get(), 9);
+    leader.join();
+    CHECK(!flight.tryJoin("board"));
+}
+
+}
+
+int main() {
+    RUN_TEST(testConcurrentCallersShareOneComputation);
+    RUN_TEST(testExceptionReachesEveryCaller);
+    RUN_TEST(testCallAfterFinishComputesAgain);
+    RUN_TEST(testTryJoinOnlyJoinsRunningCalls);
+    return testSummary();
+}
@@ -0,0 +1,76 @@
+/*
+SolverPool tests: the neuro-symbolic solver exists once per pool, a borrow
+with a wait limit comes back busy when that instance stays borrowed, and
+gets it when it is returned in time. Types without an instance limit never
+wait.
+*/
+
+#include "../src/api/solver_pool.h"
+#include "test_check.h"
+#include <chrono>
+#include <thread>
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+double elapsedMs(Clock::time_point since) {
+    return std::chrono::duration<double, std::milli>(Clock::now() - since).count();
+}
+
+void testBusyAfterWaitLimit() {
+    SolverPool pool;
+    SolverPool::Lease held = pool.borrow(SolverType::NEURO_SYMBOLIC);
+    CHECK(held);
+    CHECK(!held.isBusy());
+
+    Clock::time_point start = Clock::now();
+    SolverPool::Lease waiting = pool.borrow("neuro_symbolic", 50.0);
+    CHECK(!waiting);
+    CHECK(waiting.isBusy());
+    CHECK(elapsedMs(start) >= 50.0);
+
+    // Zero means "only if one is free right now"
+    CHECK(pool.borrow(SolverType::NEURO_SYMBOLIC, 0.0).isBusy());
+    CHECK_EQ(pool.getCreatedCount(), 1u);
+}
+
+void testReturnedWithinWaitLimit() {
+    SolverPool pool;
+    SolverPool::Lease held = pool.borrow(SolverType::NEURO_SYMBOLIC);
+    std::thread returner([&held]() {
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+        held = SolverPool::Lease();
+    });
+    SolverPool::Lease next = pool.borrow(SolverType::NEURO_SYMBOLIC, 10000.0);
+    returner.join();
+    CHECK(next);
+    CHECK(!next.isBusy());
+    CHECK_EQ(pool.getCreatedCount(), 1u);   // The same instance, handed on
+}
+
+void testUnlimitedTypesNeverWait() {
+    SolverPool pool;
+    SolverPool::Lease first = pool.borrow(SolverType::BACKTRACK, 0.0);
+    SolverPool::Lease second = pool.borrow(SolverType::BACKTRACK, 0.0);
+    CHECK(first);
+    CHECK(second);
+    CHECK(&first.solver() != &second.solver());
+}
+
+void testUnknownTypeIsNotBusy() {
+    SolverPool pool;
+    SolverPool::Lease lease = pool.borrow("no_such_solver", 0.0);
+    CHECK(!lease);
+    CHECK(!lease.isBusy());
+}
+
+}
+
+int main() {
+    RUN_TEST(testBusyAfterWaitLimit);
+    RUN_TEST(testReturnedWithinWaitLimit);
+    RUN_TEST(testUnlimitedTypesNeverWait);
+    RUN_TEST(testUnknownTypeIsNotBusy);
+    return testSummary();
+}
@@ -0,0 +1,110 @@
+/*
+Reentrant solver tests: one backtracking and one constraint solver instance,
+each shared by several threads solving different puzzles at the same time
+(as sudoku_batch shares them), give every thread the same board, result and
+move count as solving each puzzle alone.
+*/
+
+#include "../src/model/sudoku_generator.h"
+#include "../src/solver/backtrack_solver.h"
+#include "../src/solver/constraint_solver.h"
+#include "test_check.h"
+#include <atomic>
+#include <thread>
+#include <vector>
+
+namespace {
+
+const int kThreads = 4;
+const int kPuzzles = 12;
+const int kRounds = 2;
+
+struct Expected {
+    Board puzzle;
+    Board result;
+    bool solved = false;
+    int moves = 0;
+};
+
+bool sameValues(const Board& a, const Board& b) {
+    int size = a.getBoardSize();
+    if (b.getBoardSize() != size) return false;
+    for (int row = 0; row < size; ++row) {
+        for (int col = 0; col < size; ++col) {
+            if (a.getCell(row, col).getValue() != b.getCell(row, col).getValue()) return false;
+        }
+    }
+    return true;
+}
+
+// Puzzles with 30 to 52 cells removed, each solved alone by its own solver
+template <typename Solver>
+std::vector<Expected> solveAlone() {
+    SudokuGenerator generator(88);
+    std::vector<Expected> expected(kPuzzles);
+    for (int i = 0; i < kPuzzles; ++i) {
+        generator.generatePuzzle(expected[i].puzzle, 30 + 2 * i);
+        Solver solver;
+        SolveContext context;
+        expected[i].result = expected[i].puzzle;
+        expected[i].solved = solver.solve(expected[i].result, context);
+        expected[i].moves = context.movesCount;
+    }
+    return expected;
+}
+
+// Every thread works through all puzzles, starting at a different one, so
+// different puzzles are in the one solver at once
+template <typename Solver>
+int solveShared(const std::vector<Expected>& expected) {
+    Solver shared;
+    CHECK(shared.isReentrant());
+    std::atomic<int> mismatches{0};
+    std::vector<std::thread> threads;
+    for (int t = 0; t < kThreads; ++t) {
+        threads.emplace_back([&, t]() {
+            for (int round = 0; round < kRounds; ++round) {
+                for (int i = 0; i < kPuzzles; ++i) {
+                    const Expected& want = expected[(i + t * 3) % kPuzzles];
+                    Board board = want.puzzle;
+                    SolveContext context;
+                    bool solved = shared.solve(board, context);
+                    if (solved != want.solved || context.movesCount != want.moves ||
+                        !sameValues(board, want.result)) {
+                        mismatches++;
+                    }
+                }
+            }
+        });
+    }
+    for (std::thread& thread : threads) thread.join();
+    return mismatches.load();
+}
+
+void testSharedBacktrackSolver() {
+    std::vector<Expected> expected = solveAlone<BacktrackSolver>();
+    for (const Expected& want : expected) {
+        CHECK(want.solved);
+        CHECK(want.result.isComplete() && want.result.isValid());
+    }
+    CHECK_EQ(solveShared<BacktrackSolver>(expected), 0);
+}
+
+void testSharedConstraintSolver() {
+    std::vector<Expected> expected = solveAlone<ConstraintSolver>();
+    int placedSome = 0;
+    for (const Expected& want : expected) {
+        CHECK(want.result.isValid());   // Every placement is forced, so never a conflict
+        if (want.moves > 0) placedSome++;
+    }
+    CHECK(placedSome > 0);
+    CHECK_EQ(solveShared<ConstraintSolver>(expected), 0);
+}
+
+}
+
+int main() {
+    RUN_TEST(testSharedBacktrackSolver);
+    RUN_TEST(testSharedConstraintSolver);
+    return testSummary();
+}
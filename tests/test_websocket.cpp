@@ -0,0 +1,238 @@
+/*
+WebSocket tests: the upgrade handshake (RFC 6455 accept key, malformed
+requests, Origin allowlist) and client frame decoding at its boundaries:
+every truncation point, unmasked and reserved-bit frames, 16- and 64-bit
+extended lengths, payloads over the limit, and back-to-back frames.
+*/
+
+#include "../src/api/websocket.h"
+#include "test_check.h"
+#include <string>
+#include <vector>
+
+namespace {
+
+const std::vector<std::string> kOrigins = {"null", "http://localhost:5000"};
+
+std::string upgradeRequest(const std::string& extraHeaders = "") {
+    return "GET /events HTTP/1.1\r\nHost: 127.0.0.1:8765\r\nUpgrade: websocket\r\n"
+           "Connection: Upgrade\r\nSec-WebSocket-Key: dGhlIHNhbXBsZSBub25jZQ==\r\n"
+           "Sec-WebSocket-Version: 13\r\n" + extraHeaders + "\r\n";
+}
+
+// A client frame; lengthForm 0 picks the shortest encoding, else 126 or 127
+std::string clientFrame(const std::string& payload, uint8_t first = 0x81, bool masked = true,
+                        int lengthForm = 0) {
+    std::string frame;
+    frame.push_back(static_cast<char>(first));
+    uint8_t maskBit = masked ? 0x80 : 0;
+    uint64_t length = payload.size();
+    if (lengthForm == 0) {
+        lengthForm = length < 126 ? 0 : length <= 0xFFFF ? 126 : 127;
+    }
+    if (lengthForm == 0) {
+        frame.push_back(static_cast<char>(maskBit | length));
+    } else if (lengthForm == 126) {
+        frame.push_back(static_cast<char>(maskBit | 126));
+        frame.push_back(static_cast<char>(length >> 8));
+        frame.push_back(static_cast<char>(length & 0xFF));
+    } else {
+        frame.push_back(static_cast<char>(maskBit | 127));
+        for (int shift = 56; shift >= 0; shift -= 8) {
+            frame.push_back(static_cast<char>((length >> shift) & 0xFF));
+        }
+    }
+    const unsigned char mask[4] = {0x37, 0xFA, 0x21, 0x3D};
+    if (masked) {
+        frame.append(reinterpret_cast<const char*>(mask), 4);
+    }
+    for (size_t i = 0; i < payload.size(); ++i) {
+        frame.push_back(masked ? static_cast<char>(payload[i] ^ mask[i % 4]) : payload[i]);
+    }
+    return frame;
+}
+
+FrameStatus decode(const std::string& data, size_t& offset, WebSocketFrame& frame, size_t maxPayload = 1 << 20) {
+    return decodeWebSocketFrame(data, offset, frame, maxPayload);
+}
+
+void testHandshakeAcceptKey() {
+    std::string response;
+    CHECK(acceptWebSocketUpgrade(upgradeRequest(), kOrigins, response));
+    CHECK(response.compare(0, 12, "HTTP/1.1 101") == 0);
+    // The worked example from RFC 6455 section 1.3
+    CHECK(response.find("Sec-WebSocket-Accept: s3pPLMBiTxaQ9kYGzzhZRbK+xOo=\r\n") != std::string::npos);
+    CHECK(response.size() >= 4 && response.compare(response.size() - 4, 4, "\r\n\r\n") == 0);
+}
+
+void testHandshakeRejectsNonUpgrades() {
+    std::string response;
+    CHECK(!acceptWebSocketUpgrade("POST /events HTTP/1.1\r\nUpgrade: websocket\r\n"
+                                  "Sec-WebSocket-Key: abc\r\n\r\n", kOrigins, response));
+    CHECK(response.compare(0, 12, "HTTP/1.1 400") == 0);
+    CHECK(!acceptWebSocketUpgrade("GET / HTTP/1.1\r\nSec-WebSocket-Key: abc\r\n\r\n", kOrigins, response));
+    CHECK(response.compare(0, 12, "HTTP/1.1 400") == 0);
+    CHECK(!acceptWebSocketUpgrade("GET / HTTP/1.1\r\nUpgrade: websocket\r\n\r\n", kOrigins, response));
+    CHECK(response.compare(0, 12, "HTTP/1.1 400") == 0);
+    // Header names are case-insensitive
+    CHECK(acceptWebSocketUpgrade("GET / HTTP/1.1\r\nUPGRADE: WebSocket\r\n"
+                                 "sec-websocket-key: abc\r\n\r\n", kOrigins, response));
+}
+
+void testHandshakeOrigins() {
+    std::string response;
+    CHECK(acceptWebSocketUpgrade(upgradeRequest("Origin: null\r\n"), kOrigins, response));
+    CHECK(acceptWebSocketUpgrade(upgradeRequest("Origin: HTTP://LOCALHOST:5000\r\n"), kOrigins, response));
+    CHECK(!acceptWebSocketUpgrade(upgradeRequest("Origin: https://evil.example\r\n"), kOrigins, response));
+    CHECK(response.compare(0, 12, "HTTP/1.1 403") == 0);
+    // The body matches its Content-Length
+    CHECK(response.find("Content-Length: 18\r\n") != std::string::npos);
+    CHECK_EQ(response.substr(response.find("\r\n\r\n") + 4).size(), 18u);
+    // A prefix of an allowed origin is a different origin
+    CHECK(!acceptWebSocketUpgrade(upgradeRequest("Origin: http://localhost:50000\r\n"), kOrigins, response));
+    CHECK(!acceptWebSocketUpgrade(upgradeRequest("Origin: null\r\n"), {}, response));
+}
+
+void testFindHeadEnd() {
+    CHECK_EQ(findHttpHeadEnd("GET / HTTP/1.1\r\nHost: x\r\n"), 0u);
+    CHECK_EQ(findHttpHeadEnd("GET / HTTP/1.1\r\n\r\n"), 18u);
+    CHECK_EQ(findHttpHeadEnd("GET / HTTP/1.1\r\n\r\n\x81\x80"), 18u);   // Frames may follow at once
+}
+
+void testDecodesMaskedText() {
+    // The masked "Hello" from RFC 6455 section 5.7
+    const std::string data("\x81\x85\x37\xfa\x21\x3d\x7f\x9f\x4d\x51\x58", 11);
+    size_t offset = 0;
+    WebSocketFrame frame;
+    CHECK(decode(data, offset, frame) == FrameStatus::OK);
+    CHECK(frame.fin);
+    CHECK(frame.opcode == WebSocketOpcode::TEXT);
+    CHECK_EQ(frame.payload, std::string("Hello"));
+    CHECK_EQ(offset, data.size());
+}
+
+void testShortFramesAreIncomplete() {
+    for (const std::string& payload : {std::string("get_board"), std::string(300, 'a'), std::string(70000, 'b')}) {
+        std::string data = clientFrame(payload);
+        for (size_t cut = 0; cut < data.size(); ++cut) {
+            size_t offset = 0;
+            WebSocketFrame frame;
+            if (decode(data.substr(0, cut), offset, frame) != FrameStatus::INCOMPLETE || offset != 0) {
+                CHECK(!"truncated frame not reported as incomplete");
+                break;
+            }
+        }
+        size_t offset = 0;
+        WebSocketFrame frame;
+        CHECK(decode(data, offset, frame) == FrameStatus::OK);
+        CHECK(frame.payload == payload);
+    }
+}
+
+void testRejectsUnmaskedFrames() {
+    size_t offset = 0;
+    WebSocketFrame frame;
+    CHECK(decode(clientFrame("hi", 0x81, false), offset, frame) == FrameStatus::ERROR);
+    // Our own server frames are unmasked, so they never decode as client frames
+    std::string serverFrame;
+    encodeWebSocketFrame(WebSocketOpcode::TEXT, "hi", serverFrame);
+    CHECK(decode(serverFrame, offset, frame) == FrameStatus::ERROR);
+    CHECK_EQ(offset, 0u);
+}
+
+void testRejectsReservedBits() {
+    for (uint8_t rsv : {0x40, 0x20, 0x10}) {
+        size_t offset = 0;
+        WebSocketFrame frame;
+        CHECK(decode(clientFrame("hi", static_cast<uint8_t>(0x81 | rsv)), offset, frame) == FrameStatus::ERROR);
+    }
+}
+
+void testExtendedLengths() {
+    WebSocketFrame frame;
+    // 16-bit length at both ends of its range
+    for (size_t length : {size_t(126), size_t(0xFFFF)}) {
+        std::string data = clientFrame(std::string(length, 'x'));
+        CHECK_EQ(static_cast<unsigned char>(data[1]) & 0x7F, 126);
+        size_t offset = 0;
+        CHECK(decode(data, offset, frame) == FrameStatus::OK);
+        CHECK_EQ(frame.payload.size(), length);
+    }
+    // 64-bit length
+    std::string data = clientFrame(std::string(0x10000, 'y'));
+    CHECK_EQ(static_cast<unsigned char>(data[1]) & 0x7F, 127);
+    size_t offset = 0;
+    CHECK(decode(data, offset, frame) == FrameStatus::OK);
+    CHECK_EQ(frame.payload.size(), 0x10000u);
+    // A short payload in a longer form than needed still decodes
+    offset = 0;
+    CHECK(decode(clientFrame("abc", 0x81, true, 127), offset, frame) == FrameStatus::OK);
+    CHECK_EQ(frame.payload, std::string("abc"));
+}
+
+void testRejectsOverLimitPayloads() {
+    WebSocketFrame frame;
+    size_t offset = 0;
+    CHECK(decode(clientFrame(std::string(100, 'z')), offset, frame, 100) == FrameStatus::OK);
+    offset = 0;
+    CHECK(decode(clientFrame(std::string(101, 'z')), offset, frame, 100) == FrameStatus::ERROR);
+    offset = 0;
+    CHECK(decode(clientFrame(std::string(300, 'z')), offset, frame, 299) == FrameStatus::ERROR);
+
+    // Refused from the header alone: a 2^63-byte announcement is not waited for
+    std::string huge("\x81\xFF\x80\x00\x00\x00\x00\x00\x00\x00", 10);
+    offset = 0;
+    CHECK(decode(huge, offset, frame) == FrameStatus::ERROR);
+    std::string maximum("\x81\xFF\xFF\xFF\xFF\xFF\xFF\xFF\xFF\xFF", 10);
+    CHECK(decode(maximum, offset, frame) == FrameStatus::ERROR);
+}
+
+void testBackToBackFrames() {
+    std::string data = clientFrame("first", 0x01) + clientFrame("second", 0x80) + clientFrame("", 0x89) +
+                       clientFrame("trailing").substr(0, 3);
+    size_t offset = 0;
+    WebSocketFrame frame;
+    CHECK(decode(data, offset, frame) == FrameStatus::OK);
+    CHECK(!frame.fin);
+    CHECK(frame.opcode == WebSocketOpcode::TEXT);
+    CHECK_EQ(frame.payload, std::string("first"));
+    CHECK(decode(data, offset, frame) == FrameStatus::OK);
+    CHECK(frame.fin);
+    CHECK(frame.opcode == WebSocketOpcode::CONTINUATION);
+    CHECK_EQ(frame.payload, std::string("second"));
+    CHECK(decode(data, offset, frame) == FrameStatus::OK);
+    CHECK(frame.opcode == WebSocketOpcode::PING);
+    CHECK(frame.payload.empty());
+    size_t before = offset;
+    CHECK(decode(data, offset, frame) == FrameStatus::INCOMPLETE);
+    CHECK_EQ(offset, before);
+}
+
+void testEncodeLengthForms() {
+    struct Case { size_t length; size_t header; };
+    for (Case c : {Case{0, 2}, Case{125, 2}, Case{126, 4}, Case{0xFFFF, 4}, Case{0x10000, 10}}) {
+        std::string out = "x";
+        encodeWebSocketFrame(WebSocketOpcode::BINARY, std::string(c.length, 'p'), out);
+        CHECK_EQ(out.size(), 1 + c.header + c.length);
+        CHECK_EQ(static_cast<unsigned char>(out[1]), 0x82);
+        CHECK_EQ(static_cast<unsigned char>(out[2]) & 0x80, 0);   // Server frames are not masked
+    }
+}
+
+}
+
+int main() {
+    RUN_TEST(testHandshakeAcceptKey);
+    RUN_TEST(testHandshakeRejectsNonUpgrades);
+    RUN_TEST(testHandshakeOrigins);
+    RUN_TEST(testFindHeadEnd);
+    RUN_TEST(testDecodesMaskedText);
+    RUN_TEST(testShortFramesAreIncomplete);
+    RUN_TEST(testRejectsUnmaskedFrames);
+    RUN_TEST(testRejectsReservedBits);
+    RUN_TEST(testExtendedLengths);
+    RUN_TEST(testRejectsOverLimitPayloads);
+    RUN_TEST(testBackToBackFrames);
+    RUN_TEST(testEncodeLengthForms);
+    return testSummary();
+}